@@ -0,0 +1,84 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <graphics-math.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace gm;
+
+// The dispatched batch kernels at every tier the machine supports; the
+// GRAPHICS_MATH_CPU_TIER override has no effect here
+TEST_CASE("Dispatched batch kernels", "[dispatch]") {
+    auto const count = std::size_t(1 << 16);
+    detail::Pcg32 rng(1);
+    std::vector<Vec3f> vectors;
+    std::vector<Point3f> points;
+    std::vector<Matrix4x4f> matrices(1024, Matrix4x4f::identity());
+    for (std::size_t i = 0; i < count; ++i) {
+        vectors.emplace_back(rng.uniform() + 1, rng.uniform(), rng.uniform());
+        points.emplace_back(rng.uniform(), rng.uniform(), rng.uniform());
+    }
+    for (auto& m : matrices) {
+        for (int r = 0; r < 4; ++r) {
+            for (int c = 0; c < 4; ++c) m(r, c) = rng.uniform();
+        }
+    }
+    auto transform = Transform{};
+    transform.rotate({ 0, 1, 0 }, 30).translate({ 1, 2, 3 });
+
+    std::vector<Point3f> moved(count);
+    std::vector<Normal3f> normals(count);
+    std::vector<Color3f> colors(count);
+    std::vector<Matrix4x4f> products(matrices.size(), Matrix4x4f::identity());
+
+    std::vector<DualQuaternion> bones;
+    for (int i = 0; i < 64; ++i) {
+        auto const bone = Transform{}.translate({ rng.uniform(), rng.uniform(), rng.uniform() }).rotate({ rng.uniform(), rng.uniform(), 1 }, rng.uniform() * 360);
+        bones.push_back(*DualQuaternion::from_transform(bone));
+    }
+    std::vector<BoneInfluences> influences;
+    std::vector<Normal3f> unit_normals;
+    for (std::size_t i = 0; i < count; ++i) {
+        auto const bone = [&] { return static_cast<std::uint16_t>(rng.uniform() * 63); };
+        auto const w = rng.uniform();
+        influences.push_back({ { bone(), bone(), bone(), bone() }, { w / 2, (1 - w) / 2, FLOAT(0.25), FLOAT(0.25) } });
+        unit_normals.push_back(vectors[i].normalise());
+    }
+    std::vector<Normal3f> skinned_normals(count);
+
+    auto const previous = cpu_tier();
+    for (auto tier : { CpuTier::scalar, CpuTier::sse42, CpuTier::avx2, CpuTier::avx512 }) {
+        if (tier > detected_cpu_tier()) break;
+        set_cpu_tier(tier);
+        auto const suffix = std::string(" (") + to_string(tier) + ")";
+
+        BENCHMARK("Transform::apply(Span<Point3f>)" + suffix) {
+            transform.apply(Span<Point3f const>(points), moved.data());
+            return moved.back();
+        };
+
+        BENCHMARK("normalise(Span<Vec3f>)" + suffix) {
+            normalise(vectors, normals.data());
+            return normals.back();
+        };
+
+        BENCHMARK("xyz_to_linear_srgb(Span<Vec3f>)" + suffix) {
+            xyz_to_linear_srgb(vectors, colors.data());
+            return colors.back();
+        };
+
+        BENCHMARK("multiply(Span<Matrix4x4f>)" + suffix) {
+            multiply(matrices, matrices, products.data());
+            return products.back();
+        };
+
+        BENCHMARK("skin(Span<Point3f>, Span<Normal3f>)" + suffix) {
+            skin(bones, influences, points, unit_normals, moved.data(), skinned_normals.data());
+            return moved.back();
+        };
+    }
+    set_cpu_tier(previous);
+}
@@ -0,0 +1,72 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <floating-point.hpp>
+#include <transform.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <limits>
+#include <vector>
+
+using namespace gm;
+
+namespace {
+    auto constexpr factor = [](int bounce) { return bounce % 2 == 0 ? FLOAT(0.75) : 1 / FLOAT(0.75); };
+
+    // scales contributions down and up again so repeated runs stay in the
+    // same range
+    auto attenuate(std::vector<Color3f>& colors) -> FLOAT {
+        auto sum = FLOAT(0);
+        for (int bounce = 0; bounce < 8; ++bounce) {
+            auto const f = factor(bounce);
+            for (auto& c : colors) {
+                c = c * f;
+                sum += c.r;
+            }
+        }
+        return sum;
+    }
+}
+
+TEST_CASE("Denormal slowdown and recovery", "[floating-point]") {
+    auto const count = std::size_t(1 << 16);
+    auto const normal = std::vector<Color3f>(count, Color3f{ 0.5f });
+    // the smallest normal, every other product is denormal
+    auto const tiny = std::vector<Color3f>(count, Color3f{ std::numeric_limits<float>::min() });
+
+    BENCHMARK_ADVANCED("normal values")(Catch::Benchmark::Chronometer meter) {
+        auto colors = normal;
+        meter.measure([&] { return attenuate(colors); });
+    };
+
+    BENCHMARK_ADVANCED("denormal values")(Catch::Benchmark::Chronometer meter) {
+        auto colors = tiny;
+        meter.measure([&] { return attenuate(colors); });
+    };
+
+    BENCHMARK_ADVANCED("denormal values, ScopedFlushToZero")(Catch::Benchmark::Chronometer meter) {
+        ScopedFlushToZero guard;
+        auto colors = tiny;
+        meter.measure([&] { return attenuate(colors); });
+    };
+
+    BENCHMARK_ADVANCED("denormal values, clamp_denormals per bounce")(Catch::Benchmark::Chronometer meter) {
+        auto colors = tiny;
+        meter.measure([&] {
+            auto sum = FLOAT(0);
+            for (int bounce = 0; bounce < 8; ++bounce) {
+                auto const f = factor(bounce);
+                for (auto& c : colors) {
+                    c = c * f;
+                    sum += c.r;
+                }
+                clamp_denormals(colors);
+            }
+            return sum;
+        });
+    };
+
+    BENCHMARK_ADVANCED("flush_nonfinite")(Catch::Benchmark::Chronometer meter) {
+        auto colors = normal;
+        meter.measure([&] { return flush_nonfinite(colors); });
+    };
+}
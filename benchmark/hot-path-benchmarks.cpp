@@ -0,0 +1,49 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <graphics-math.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <vector>
+
+using namespace gm;
+
+// Built into both `benchmarks` and `benchmarks-instrumented`; with
+// instrumentation disabled the timings must match a build without the hooks.
+TEST_CASE("Hot paths", "[instrumentation]") {
+    auto const count = std::size_t(1 << 16);
+    std::vector<Vec3f> vectors;
+    std::vector<Point3f> points;
+    detail::Pcg32 rng(1);
+    for (std::size_t i = 0; i < count; ++i) {
+        vectors.emplace_back(rng.uniform() + 1, rng.uniform(), rng.uniform());
+        points.emplace_back(rng.uniform(), rng.uniform(), rng.uniform());
+    }
+    auto transform = Transform{};
+    transform.rotate({ 0, 1, 0 }, 30).translate({ 1, 2, 3 });
+
+    BENCHMARK("Vec3::normalise") {
+        auto sum = FLOAT(0);
+        for (auto const& v : vectors) sum += v.normalise().x();
+        return sum;
+    };
+
+    BENCHMARK("Transform::apply(Point3f)") {
+        auto sum = FLOAT(0);
+        for (auto const& p : points) sum += transform.apply(p).x;
+        return sum;
+    };
+
+    BENCHMARK("Matrix4x4::multiply") {
+        auto m = Matrix4x4f::identity();
+        for (std::size_t i = 0; i < 1024; ++i) m = m * transform.matrix();
+        return m;
+    };
+
+    BENCHMARK("solve_quadratic") {
+        auto sum = FLOAT(0);
+        for (auto const& v : vectors) {
+            if (auto const roots = solve_quadratic(v.x, FLOAT(3), -v.y)) sum += std::get<0>(*roots);
+        }
+        return sum;
+    };
+}
@@ -0,0 +1,77 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <color3.hpp>
+#include <sampling.hpp>
+#include <transform.hpp>
+#include <transform2d.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <vector>
+
+using namespace gm;
+
+namespace {
+    template<typename Encoder>
+    auto encode(std::vector<Color3f> const& colors, Encoder const& encoder) -> std::uint32_t {
+        auto sum = std::uint32_t(0);
+        for (auto const& c : colors) {
+            auto const codes = c.encode_srgb(encoder);
+            sum += codes[0] + codes[1] + codes[2];
+        }
+        return sum;
+    }
+
+    template<typename Decoder>
+    auto decode(std::vector<std::array<std::uint16_t, 3>> const& codes, Decoder const& decoder) -> FLOAT {
+        auto sum = FLOAT(0);
+        for (auto const& c : codes) sum += Color3f::decode_srgb(c, decoder).g;
+        return sum;
+    }
+
+    template<typename Trig>
+    auto rotations(std::vector<FLOAT> const& angles, Trig const& trig) -> FLOAT {
+        auto sum = FLOAT(0);
+        for (auto angle : angles) sum += Transform{}.rotate({ 0, 1, 0 }, angle, trig).matrix()(0, 2);
+        return sum;
+    }
+}
+
+// Tables against the gcem path they approximate
+TEST_CASE("Lookup tables", "[lookup-tables]") {
+    auto const count = std::size_t(1 << 16);
+    detail::Pcg32 rng(1);
+    std::vector<Color3f> colors;
+    std::vector<std::array<std::uint16_t, 3>> codes8, codes16;
+    std::vector<FLOAT> angles;
+    for (std::size_t i = 0; i < count; ++i) {
+        colors.emplace_back(rng.uniform(), rng.uniform(), rng.uniform());
+        codes8.push_back(colors.back().encode_srgb());
+        codes16.push_back(colors.back().encode_srgb(SrgbEncoder<16>{}));
+        angles.push_back(rng.uniform() * 720 - 360);
+    }
+
+    BENCHMARK("encode_srgb 8 bit (gcem)") { return encode(colors, SrgbEncoder<8>{}); };
+    BENCHMARK("encode_srgb 8 bit (table)") { return encode(colors, SrgbEncodeTable<8>{}); };
+    BENCHMARK("encode_srgb 16 bit (gcem)") { return encode(colors, SrgbEncoder<16>{}); };
+    BENCHMARK("encode_srgb 16 bit (table)") { return encode(colors, SrgbEncodeTable<16>{}); };
+
+    BENCHMARK("decode_srgb 8 bit (gcem)") { return decode(codes8, SrgbDecoder<8>{}); };
+    BENCHMARK("decode_srgb 8 bit (table)") { return decode(codes8, SrgbDecodeTable<8>{}); };
+    BENCHMARK("decode_srgb 16 bit (gcem)") { return decode(codes16, SrgbDecoder<16>{}); };
+    BENCHMARK("decode_srgb 16 bit (table)") { return decode(codes16, SrgbDecodeTable<16>{}); };
+
+    BENCHMARK("Transform::rotate (gcem)") { return rotations(angles, ExactSinCos{}); };
+    BENCHMARK("Transform::rotate (table)") { return rotations(angles, SinCosTable<>{}); };
+
+    BENCHMARK("sin/cos (gcem)") {
+        auto sum = FLOAT(0);
+        for (auto angle : angles) sum += ExactSinCos{}(angle).sin;
+        return sum;
+    };
+    BENCHMARK("sin/cos (table)") {
+        auto sum = FLOAT(0);
+        for (auto angle : angles) sum += SinCosTable<>{}(angle).sin;
+        return sum;
+    };
+}
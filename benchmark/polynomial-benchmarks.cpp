@@ -0,0 +1,111 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <polynomial.hpp>
+#include <sampling.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace gm;
+
+namespace {
+    // Monic polynomials with known, well separated roots in [-4, 4]
+    template<std::size_t N>
+    struct Polynomials {
+        std::vector<std::array<FLOAT, N>> roots;
+        std::vector<std::array<FLOAT, N + 1>> coefficients;
+    };
+
+    template<std::size_t N>
+    auto make_polynomials(std::size_t count) -> Polynomials<N> {
+        Polynomials<N> result;
+        detail::Pcg32 rng(N);
+        while (result.roots.size() < count) {
+            std::array<FLOAT, N> r;
+            for (auto& x : r) x = 8 * rng.uniform() - 4;
+            std::sort(r.begin(), r.end());
+            auto separated = true;
+            for (std::size_t i = 1; i < N; ++i) separated &= r[i] - r[i - 1] > FLOAT(0.1);
+            if (!separated) continue;
+            // multiply out, highest degree first
+            std::array<double, N + 1> c{};
+            c[0] = 1;
+            for (std::size_t i = 0; i < N; ++i) {
+                for (std::size_t k = i + 1; k > 0; --k) c[k] -= r[i] * c[k - 1];
+            }
+            std::array<FLOAT, N + 1> cf;
+            for (std::size_t k = 0; k <= N; ++k) cf[k] = static_cast<FLOAT>(c[k]);
+            result.roots.push_back(r);
+            result.coefficients.push_back(cf);
+        }
+        return result;
+    }
+
+    template<std::size_t N, typename Solver>
+    auto max_error(Polynomials<N> const& polynomials, Solver const& solve) -> double {
+        auto error = 0.0;
+        for (std::size_t i = 0; i < polynomials.roots.size(); ++i) {
+            auto const roots = solve(polynomials.coefficients[i]);
+            if (roots.size() != N) return INFINITY;
+            for (std::size_t k = 0; k < N; ++k) error = std::max(error, std::abs(double(roots[k]) - polynomials.roots[i][k]));
+        }
+        return error;
+    }
+}
+
+TEST_CASE("Polynomial solvers", "[polynomial]") {
+    auto const count = std::size_t(1 << 14);
+    auto const quadratics = make_polynomials<2>(count);
+    auto const cubics = make_polynomials<3>(count);
+    auto const quartics = make_polynomials<4>(count);
+
+    auto const quadratic = [](std::array<FLOAT, 3> const& c) {
+        auto const roots = solve_quadratic(c[0], c[1], c[2]);
+        return std::array<FLOAT, 2>{ std::get<0>(*roots), std::get<1>(*roots) };
+    };
+    auto const cubic = [](std::array<FLOAT, 4> const& c) { return solve_cubic(c[0], c[1], c[2], c[3]); };
+    auto const quartic = [](std::array<FLOAT, 5> const& c) { return solve_quartic(c[0], c[1], c[2], c[3], c[4]); };
+
+    std::cout << "max root error (float coefficients): quadratic " << max_error(quadratics, quadratic)
+              << ", cubic " << max_error(cubics, cubic) << ", quartic " << max_error(quartics, quartic) << '\n';
+
+    BENCHMARK("solve_quadratic") {
+        auto sum = FLOAT(0);
+        for (auto const& c : quadratics.coefficients) sum += quadratic(c)[0];
+        return sum;
+    };
+
+    BENCHMARK("solve_cubic") {
+        auto sum = FLOAT(0);
+        for (auto const& c : cubics.coefficients) sum += cubic(c)[0];
+        return sum;
+    };
+
+    BENCHMARK("solve_quartic") {
+        auto sum = FLOAT(0);
+        for (auto const& c : quartics.coefficients) sum += quartic(c)[0];
+        return sum;
+    };
+
+    // the largest root of each cubic, bracketed above the middle one
+    BENCHMARK("newton_bisect, 8 lanes") {
+        auto sum = FLOAT(0);
+        for (std::size_t i = 0; i + 8 <= count; i += 8) {
+            std::array<FLOAT, 8> lo, hi;
+            for (std::size_t lane = 0; lane < 8; ++lane) {
+                lo[lane] = (cubics.roots[i + lane][1] + cubics.roots[i + lane][2]) / 2;
+                hi[lane] = 5;
+            }
+            auto const roots = newton_bisect<8>([&](std::size_t lane, FLOAT x) {
+                auto const& c = cubics.coefficients[i + lane];
+                return std::make_pair(((c[0] * x + c[1]) * x + c[2]) * x + c[3], (3 * c[0] * x + 2 * c[1]) * x + c[2]);
+            }, lo, hi, 8);
+            for (auto const x : roots) sum += x;
+        }
+        return sum;
+    };
+}
@@ -0,0 +1,46 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <spatial-sort.hpp>
+#include <sampling.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <vector>
+
+using namespace gm;
+
+namespace {
+    auto random_points(std::size_t count) -> std::vector<Point3f> {
+        std::vector<Point3f> points(count);
+        detail::Pcg32 rng(count);
+        for (auto& p : points) p = Point3f{ rng.uniform() * 100, rng.uniform() * 10, rng.uniform() };
+        return points;
+    }
+
+    auto run(std::size_t count) -> void {
+        auto const points = random_points(count);
+        std::vector<Point3f> sorted(count);
+
+        BENCHMARK("morton codes") {
+            std::vector<std::uint64_t> codes(count);
+            auto const [min, max] = bounds(points);
+            morton_codes(points, min, max, codes.data());
+            return codes.back();
+        };
+
+        BENCHMARK("morton sort") {
+            return morton_sort(points);
+        };
+
+        auto const permutation = morton_sort(points);
+        BENCHMARK("gather") {
+            gather(points.data(), permutation, sorted.data());
+            return sorted.front();
+        };
+    }
+}
+
+TEST_CASE("Morton sort 1M points", "[spatial-sort]") { run(1'000'000); }
+TEST_CASE("Morton sort 10M points", "[spatial-sort]") { run(10'000'000); }
+// needs about 4GB, run explicitly with [large]
+TEST_CASE("Morton sort 100M points", "[.][large][spatial-sort]") { run(100'000'000); }
@@ -0,0 +1,71 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <dispatch.hpp>
+#include <sampling.hpp>
+#include <texture.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <vector>
+
+using namespace gm;
+
+// Coherent lookups along scanlines of a 1024x1024 texture
+TEST_CASE("Texture lookups", "[texture]") {
+    auto const size = 1024;
+    detail::Pcg32 rng(1);
+    std::vector<Color3f> linear;
+    std::vector<Color3ui8> encoded;
+    for (int i = 0; i < size * size; ++i) {
+        linear.emplace_back(rng.uniform(), rng.uniform(), rng.uniform());
+        encoded.emplace_back(static_cast<std::uint8_t>(rng.uniform() * 255), static_cast<std::uint8_t>(rng.uniform() * 255), static_cast<std::uint8_t>(rng.uniform() * 255));
+    }
+    auto const texture = MipMapf({ size, size }, linear);
+    auto const texture8 = MipMapui8({ size, size }, encoded);
+
+    auto const count = std::size_t(1 << 16);
+    std::vector<Point2f> uv;
+    std::vector<FLOAT> levels;
+    for (std::size_t i = 0; i < count; ++i) {
+        uv.emplace_back(static_cast<FLOAT>(i % 256) / 256 + FLOAT(0.001), static_cast<FLOAT>(i / 256) / 256);
+        levels.push_back(rng.uniform() * 2);
+    }
+    std::vector<Color3f> out(count);
+    auto& cache = TexelCache::local();
+
+    BENCHMARK("MipMap::bilinear (scalar loop)") {
+        auto sum = FLOAT(0);
+        for (auto const& p : uv) sum += texture.bilinear(p, 2).g;
+        return sum;
+    };
+    BENCHMARK("MipMap::bilinear (batch)") {
+        texture.bilinear(uv, 2, out.data());
+        return out[7].g;
+    };
+    BENCHMARK("MipMap::trilinear (scalar loop)") {
+        auto sum = FLOAT(0);
+        for (std::size_t i = 0; i < count; ++i) sum += texture.trilinear(uv[i], levels[i]).g;
+        return sum;
+    };
+    BENCHMARK("MipMap::trilinear (batch)") {
+        texture.trilinear(uv, levels, out.data());
+        return out[7].g;
+    };
+
+    BENCHMARK("8 bit bilinear") {
+        auto sum = FLOAT(0);
+        for (auto const& p : uv) sum += texture8.bilinear(p, 2).g;
+        return sum;
+    };
+    BENCHMARK("8 bit bilinear (texel cache)") {
+        auto sum = FLOAT(0);
+        for (auto const& p : uv) sum += texture8.bilinear(p, 2, cache).g;
+        return sum;
+    };
+
+    BENCHMARK("MipMap::ewa (4:1 footprint)") {
+        auto sum = FLOAT(0);
+        for (std::size_t i = 0; i < count; i += 16) sum += texture.ewa(uv[i], Vec2f{ FLOAT(4) / size, 0 }, Vec2f{ 0, FLOAT(1) / size }).g;
+        return sum;
+    };
+}
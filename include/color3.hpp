@@ -1,7 +1,10 @@
 #pragma once
 
 #include "util.hpp"
+#include "compare.hpp"
+#include "lookup-tables.hpp"
 
+#include <array>
 #include <cstdint>
 #include <ostream>
 #include <algorithm>
@@ -21,23 +24,11 @@ namespace gm {
         auto static constexpr black() -> Color3 { return Color3{0}; }
 
         auto constexpr operator==(Color3<Type> const& other) const -> bool {
-            if constexpr (std::is_floating_point_v<Type>) {
-                return gcem::abs(r - other.r) < constants::epsilon
-                    && gcem::abs(g - other.g) < constants::epsilon
-                    && gcem::abs(b - other.b) < constants::epsilon;
-            } else {
-                return r == other.x && g == other.y && b == other.z;
-            }
+            return approx_equal(*this, other, DefaultComparison<Type>{});
         }
 
         auto constexpr operator!=(Color3<Type> const& other) const -> bool {
-            if constexpr (std::is_floating_point_v<Type>) {
-                return gcem::abs(r - other.r) > constants::epsilon
-                    || gcem::abs(g - other.g) > constants::epsilon
-                    || gcem::abs(b - other.b) > constants::epsilon;
-            } else {
-                return r != other.x || g != other.y || b != other.z;
-            }
+            return !(*this == other);
         }
 
         auto constexpr operator*(Type factor) const -> Color3<Type>         {
@@ -93,9 +84,9 @@ namespace gm {
         }
 
         auto constexpr clamp() -> void {
-            r = std::clamp(r, 0, 1);
-            g = std::clamp(g, 0, 1);
-            b = std::clamp(b, 0, 1);
+            r = std::clamp(r, Type(0), Type(1));
+            g = std::clamp(g, Type(0), Type(1));
+            b = std::clamp(b, Type(0), Type(1));
         }
 
         auto constexpr gamma_encode(FLOAT gamma) -> void {
@@ -108,9 +99,22 @@ namespace gm {
 
         auto constexpr convert_to_rgb() -> void {
             gamma_encode(2.2f);
-            r = 255 * std::clamp(r, 0.0f, 1.0f);
-            g = 255 * std::clamp(g, 0.0f, 1.0f);
-            b = 255 * std::clamp(b, 0.0f, 1.0f);
+            r = 255 * std::clamp(r, Type(0), Type(1));
+            g = 255 * std::clamp(g, Type(0), Type(1));
+            b = 255 * std::clamp(b, Type(0), Type(1));
+        }
+
+        // sRGB codes of the color clamped to [0, 1]. `Encoder` is SrgbEncoder
+        // (gcem) or SrgbEncodeTable, of the output bit depth.
+        template<typename Encoder = SrgbEncoder<8>>
+        auto constexpr encode_srgb(Encoder const& encoder = {}) const -> std::array<std::uint16_t, 3> {
+            return { encoder(static_cast<FLOAT>(r)), encoder(static_cast<FLOAT>(g)), encoder(static_cast<FLOAT>(b)) };
+        }
+
+        // `Decoder` is SrgbDecoder or SrgbDecodeTable
+        template<typename Decoder = SrgbDecoder<8>>
+        static auto constexpr decode_srgb(std::array<std::uint16_t, 3> const& codes, Decoder const& decoder = {}) -> Color3<Type> {
+            return { static_cast<Type>(decoder(codes[0])), static_cast<Type>(decoder(codes[1])), static_cast<Type>(decoder(codes[2])) };
         }
 
         auto friend operator<<(std::ostream &os, Color3<Type> const& c) -> std::ostream & {
@@ -119,6 +123,11 @@ namespace gm {
         }
     };
 
+    template<typename Type, typename Policy>
+    auto constexpr approx_equal(Color3<Type> const& a, Color3<Type> const& b, Policy const& policy) -> bool {
+        return policy(a.r, b.r) & policy(a.g, b.g) & policy(a.b, b.b);
+    }
+
     template<typename Type>
     auto constexpr operator*(Type factor, Color3<Type> const& color) -> Color3<Type> {
         return Color3<Type>{ color.r * factor, color.g * factor, color.b * factor };
@@ -138,4 +147,9 @@ namespace gm {
     typedef Color3<std::uint8_t> Color3ui8;
     typedef Color3<unsigned short> Color3ui16;
 
+#if defined(GRAPHICS_MATH_STATIC) && !defined(GRAPHICS_MATH_IMPLEMENTATION)
+    // instantiated in graphics-math-static
+    extern template class Color3<float>;
+    extern template class Color3<double>;
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "util.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+// Component comparison policies. approx_equal(a, b, policy) is provided next
+// to each vector, point, normal, color and matrix type; it evaluates every
+// component and combines the results with bitwise and, so it does not branch
+// and vectorizes.
+namespace gm {
+
+    struct Exact {
+        template<typename T>
+        auto constexpr operator()(T a, T b) const -> bool {
+            return a == b;
+        }
+    };
+
+    struct AbsoluteTolerance {
+        FLOAT tolerance = constants::epsilon;
+
+        template<typename T>
+        auto constexpr operator()(T a, T b) const -> bool {
+            return gcem::abs(a - b) < tolerance;
+        }
+    };
+
+    // |a - b| <= tolerance * max(|a|, |b|), use for values far from 1
+    struct RelativeTolerance {
+        FLOAT tolerance = static_cast<FLOAT>(1e-5);
+
+        template<typename T>
+        auto constexpr operator()(T a, T b) const -> bool {
+            auto const abs_a = gcem::abs(a), abs_b = gcem::abs(b);
+            return gcem::abs(a - b) <= tolerance * (abs_a > abs_b ? abs_a : abs_b);
+        }
+    };
+
+    // At most `max_ulps` representable values apart; +0 and -0 are equal,
+    // NaN equals nothing
+    struct UlpDistance {
+        std::uint64_t max_ulps = 4;
+
+        template<typename T>
+        auto operator()(T a, T b) const -> bool {
+            static_assert(std::is_floating_point_v<T>);
+            using Int = std::conditional_t<sizeof(T) == 4, std::int32_t, std::int64_t>;
+            // sign-magnitude to two's complement, so integer order matches float order
+            auto const ordered = [](T x) -> std::int64_t {
+                Int i;
+                std::memcpy(&i, &x, sizeof(x));
+                return i < 0 ? std::int64_t(std::numeric_limits<Int>::min()) - i : std::int64_t(i);
+            };
+            auto const ia = ordered(a), ib = ordered(b);
+            auto const distance = ia > ib ? std::uint64_t(ia) - std::uint64_t(ib) : std::uint64_t(ib) - std::uint64_t(ia);
+            return (a == a) & (b == b) & (distance <= max_ulps);
+        }
+    };
+
+    // What operator== uses: a small absolute tolerance for floating point,
+    // exact for integers
+    template<typename Type>
+    using DefaultComparison = std::conditional_t<std::is_floating_point_v<Type>, AbsoluteTolerance, Exact>;
+}
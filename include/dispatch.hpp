@@ -0,0 +1,144 @@
+#pragma once
+
+#include "util.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <optional>
+#include <string_view>
+
+// Runtime selection between copies of the batch kernels compiled for
+// different x86 instruction sets, so one binary uses AVX2 or AVX-512 where
+// available without building the whole program with -mavx2. Each kernel is
+// flattened into one clone per tier; elsewhere (MSVC, other architectures)
+// every tier compiles to the same code.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #define GM_MULTIVERSIONING 1
+    #define GM_TARGET_CLONE(isa) __attribute__((flatten, target(isa)))
+#else
+    #define GM_TARGET_CLONE(isa)
+#endif
+
+// With the compiled graphics-math-static target (GRAPHICS_MATH_STATIC) the
+// batch kernels are only declared in the headers and defined once in the
+// library. Their names carry an ABI tag of the library version and FLOAT,
+// so a program built with another FLOAT fails to link instead of
+// misbehaving. Header-only builds define them inline.
+#define GM_STRINGIFY_IMPL(x) #x
+#define GM_STRINGIFY(x) GM_STRINGIFY_IMPL(x)
+#if defined(GRAPHICS_MATH_STATIC)
+    #if defined(__GNUC__) || defined(__clang__)
+        #define GM_KERNEL_ABI __attribute__((abi_tag("gm0_1_" GM_STRINGIFY(FLOAT))))
+    #else
+        #define GM_KERNEL_ABI
+    #endif
+    #define GM_KERNEL
+    #if !defined(GRAPHICS_MATH_IMPLEMENTATION)
+        #define GM_KERNELS_OUT_OF_LINE 1
+    #endif
+#else
+    #define GM_KERNEL_ABI
+    #define GM_KERNEL inline
+#endif
+
+namespace gm {
+
+    // Instruction set tiers in increasing order. FMA is deliberately not
+    // enabled in any tier: without contraction every tier rounds the same
+    // way, so machines of a heterogeneous farm produce identical results.
+    enum class CpuTier : int {
+        scalar,
+        sse42,
+        avx2,
+        avx512
+    };
+
+    inline auto constexpr to_string(CpuTier tier) -> char const* {
+        switch (tier) {
+        case CpuTier::sse42: return "sse4.2";
+        case CpuTier::avx2: return "avx2";
+        case CpuTier::avx512: return "avx512";
+        default: return "scalar";
+        }
+    }
+
+    inline auto constexpr parse_cpu_tier(std::string_view name) -> std::optional<CpuTier> {
+        for (auto tier : { CpuTier::scalar, CpuTier::sse42, CpuTier::avx2, CpuTier::avx512 }) {
+            if (name == to_string(tier)) return tier;
+        }
+        return std::nullopt;
+    }
+
+    // The best tier the processor and operating system support, detected
+    // on first use
+    inline auto detected_cpu_tier() -> CpuTier {
+        static auto const tier = [] {
+#if defined(GM_MULTIVERSIONING)
+            // also checks that the OS saves the AVX registers
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl")
+                && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512dq")) return CpuTier::avx512;
+            if (__builtin_cpu_supports("avx2")) return CpuTier::avx2;
+            if (__builtin_cpu_supports("sse4.2")) return CpuTier::sse42;
+#endif
+            return CpuTier::scalar;
+        }();
+        return tier;
+    }
+
+    namespace detail {
+        // `name` lowers the tier, unknown names and tiers above `detected`
+        // are ignored
+        inline auto constexpr initial_cpu_tier(char const* name, CpuTier detected) -> CpuTier {
+            if (name == nullptr) return detected;
+            auto const requested = parse_cpu_tier(name);
+            return requested && *requested < detected ? *requested : detected;
+        }
+
+        inline auto active_cpu_tier() -> std::atomic<CpuTier>& {
+            static std::atomic<CpuTier> tier{ initial_cpu_tier(std::getenv("GRAPHICS_MATH_CPU_TIER"), detected_cpu_tier()) };
+            return tier;
+        }
+    }
+
+    // The tier the batch kernels run at: the detected one unless lowered by
+    // the GRAPHICS_MATH_CPU_TIER environment variable (scalar, sse4.2, avx2
+    // or avx512) or set_cpu_tier
+    inline auto cpu_tier() -> CpuTier {
+        return detail::active_cpu_tier().load(std::memory_order_relaxed);
+    }
+
+    // Forces a tier for benchmarking and testing, clamped to the detected
+    // one. Returns the previous tier.
+    inline auto set_cpu_tier(CpuTier tier) -> CpuTier {
+        auto const clamped = tier < detected_cpu_tier() ? tier : detected_cpu_tier();
+        return detail::active_cpu_tier().exchange(clamped, std::memory_order_relaxed);
+    }
+
+    namespace detail {
+        template<typename Kernel>
+        auto run_scalar(Kernel const& kernel) -> void { kernel(); }
+
+        template<typename Kernel>
+        GM_TARGET_CLONE("sse4.2") auto run_sse42(Kernel const& kernel) -> void { kernel(); }
+
+        template<typename Kernel>
+        GM_TARGET_CLONE("avx2") auto run_avx2(Kernel const& kernel) -> void { kernel(); }
+
+        template<typename Kernel>
+        GM_TARGET_CLONE("avx512f,avx512vl,avx512bw,avx512dq") auto run_avx512(Kernel const& kernel) -> void { kernel(); }
+
+        // Runs the loop in `kernel` compiled for the active tier. The loop
+        // body should only call inline functions, anything that is not
+        // inlined into the clone runs at the baseline instruction set.
+        template<typename Kernel>
+        auto dispatch(Kernel const& kernel) -> void {
+            switch (cpu_tier()) {
+            case CpuTier::avx512: return run_avx512(kernel);
+            case CpuTier::avx2: return run_avx2(kernel);
+            case CpuTier::sse42: return run_sse42(kernel);
+            default: return run_scalar(kernel);
+            }
+        }
+    }
+}
@@ -0,0 +1,313 @@
+#pragma once
+
+#include "compare.hpp"
+#include "dispatch.hpp"
+#include "matrix4x4.hpp"
+#include "normal3.hpp"
+#include "parallel.hpp"
+#include "point3.hpp"
+#include "span.hpp"
+#include "transform.hpp"
+#include "vec3.hpp"
+#include "util.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace gm {
+
+    // w + v.x i + v.y j + v.z k
+    class Quaternion {
+    public:
+        Vec3f v;
+        FLOAT w;
+
+        constexpr Quaternion() : v(), w(1) { }
+        constexpr Quaternion(Vec3f const& v, FLOAT w) : v(v), w(w) { }
+
+        auto constexpr operator+(Quaternion const& other) const -> Quaternion {
+            return { v + other.v, w + other.w };
+        }
+
+        auto constexpr operator*(FLOAT scalar) const -> Quaternion {
+            return { v * scalar, w * scalar };
+        }
+
+        // Hamilton product, applies `other` first when both are rotations
+        auto constexpr operator*(Quaternion const& other) const -> Quaternion {
+            return { w * other.v + other.w * v + v.cross(other.v), w * other.w - v.dot(other.v) };
+        }
+
+        auto constexpr dot(Quaternion const& other) const -> FLOAT {
+            return v.dot(other.v) + w * other.w;
+        }
+
+        auto constexpr conjugate() const -> Quaternion {
+            return { -v, w };
+        }
+
+        auto length() const -> FLOAT {
+            return std::sqrt(dot(*this));
+        }
+
+        // Rotates by a unit quaternion
+        auto constexpr rotate(Vec3f const& u) const -> Vec3f {
+            return u + v.cross(v.cross(u) + w * u) * 2;
+        }
+    };
+
+    // Rigid transform as real + epsilon dual: the real part is the rotation,
+    // the dual part is half the translation times the rotation. Unlike
+    // matrices, a normalised weighted sum of these is again rigid, which is
+    // what makes them suitable for skinning.
+    class DualQuaternion {
+    public:
+        Quaternion real;
+        Quaternion dual;
+
+        constexpr DualQuaternion() : real(), dual(Vec3f{}, 0) { }
+        constexpr DualQuaternion(Quaternion const& real, Quaternion const& dual) : real(real), dual(dual) { }
+
+        // Rotation by the unit quaternion `rotation`, then translation
+        static auto constexpr from_rotation_translation(Quaternion const& rotation, Vec3f const& translation) -> DualQuaternion {
+            return { rotation, Quaternion{ translation, 0 } * rotation * FLOAT(0.5) };
+        }
+
+        // nullopt unless the upper 3x3 block of the matrix is a rotation
+        // (orthonormal within `tolerance`, no reflection) and the bottom row
+        // is (0, 0, 0, 1)
+        static auto from_transform(Transform const& transform, FLOAT tolerance = static_cast<FLOAT>(1e-4)) -> std::optional<DualQuaternion> {
+            auto const& m = transform.matrix();
+            auto const column = [&m](int j) { return Vec3f{ m(0, j), m(1, j), m(2, j) }; };
+            auto const c0 = column(0), c1 = column(1), c2 = column(2);
+            AbsoluteTolerance const near{ tolerance };
+            auto const rigid = near(c0.dot(c0), FLOAT(1)) & near(c1.dot(c1), FLOAT(1)) & near(c2.dot(c2), FLOAT(1))
+                & near(c0.dot(c1), FLOAT(0)) & near(c0.dot(c2), FLOAT(0)) & near(c1.dot(c2), FLOAT(0))
+                & (c0.cross(c1).dot(c2) > 0)
+                & (m(3, 0) == 0) & (m(3, 1) == 0) & (m(3, 2) == 0) & (m(3, 3) == 1);
+            if (!rigid) return std::nullopt;
+
+            // Shepperd's method, picks the largest component to divide by
+            Quaternion q;
+            auto const trace = m(0, 0) + m(1, 1) + m(2, 2);
+            if (trace > 0) {
+                auto const s = 2 * std::sqrt(trace + 1);
+                q = { Vec3f{ (m(2, 1) - m(1, 2)) / s, (m(0, 2) - m(2, 0)) / s, (m(1, 0) - m(0, 1)) / s }, s / 4 };
+            } else if (m(0, 0) > m(1, 1) && m(0, 0) > m(2, 2)) {
+                auto const s = 2 * std::sqrt(1 + m(0, 0) - m(1, 1) - m(2, 2));
+                q = { Vec3f{ s / 4, (m(0, 1) + m(1, 0)) / s, (m(0, 2) + m(2, 0)) / s }, (m(2, 1) - m(1, 2)) / s };
+            } else if (m(1, 1) > m(2, 2)) {
+                auto const s = 2 * std::sqrt(1 + m(1, 1) - m(0, 0) - m(2, 2));
+                q = { Vec3f{ (m(0, 1) + m(1, 0)) / s, s / 4, (m(1, 2) + m(2, 1)) / s }, (m(0, 2) - m(2, 0)) / s };
+            } else {
+                auto const s = 2 * std::sqrt(1 + m(2, 2) - m(0, 0) - m(1, 1));
+                q = { Vec3f{ (m(0, 2) + m(2, 0)) / s, (m(1, 2) + m(2, 1)) / s, s / 4 }, (m(1, 0) - m(0, 1)) / s };
+            }
+            q = q * (1 / q.length());
+            return from_rotation_translation(q, column(3));
+        }
+
+        auto constexpr rotation() const -> Quaternion const& { return real; }
+
+        auto constexpr translation() const -> Vec3f {
+            return (real.w * dual.v - dual.w * real.v + real.v.cross(dual.v)) * 2;
+        }
+
+        auto to_transform() const -> Transform {
+            auto const x = real.rotate(Vec3f{ 1, 0, 0 }), y = real.rotate(Vec3f{ 0, 1, 0 }), z = real.rotate(Vec3f{ 0, 0, 1 });
+            auto const t = translation();
+            Matrix4x4f const matrix{ x.x, y.x, z.x, t.x,
+                                     x.y, y.y, z.y, t.y,
+                                     x.z, y.z, z.z, t.z,
+                                     0, 0, 0, 1 };
+            Matrix4x4f const inverse{ x.x, x.y, x.z, -x.dot(t),
+                                      y.x, y.y, y.z, -y.dot(t),
+                                      z.x, z.y, z.z, -z.dot(t),
+                                      0, 0, 0, 1 };
+            return { matrix, inverse };
+        }
+
+        // Applies `other` first
+        auto constexpr operator*(DualQuaternion const& other) const -> DualQuaternion {
+            return { real * other.real, real * other.dual + dual * other.real };
+        }
+
+        auto constexpr operator+(DualQuaternion const& other) const -> DualQuaternion {
+            return { real + other.real, dual + other.dual };
+        }
+
+        auto constexpr operator*(FLOAT scalar) const -> DualQuaternion {
+            return { real * scalar, dual * scalar };
+        }
+
+        // Divides by the length of the real part, as after blending
+        auto normalise() const -> DualQuaternion {
+            return *this * (1 / real.length());
+        }
+
+        auto constexpr operator()(Point3f const& p) const -> Point3f {
+            auto const r = real.rotate(Vec3f{ p.x, p.y, p.z }) + translation();
+            return { r.x, r.y, r.z };
+        }
+
+        auto constexpr operator()(Vec3f const& v) const -> Vec3f {
+            return real.rotate(v);
+        }
+
+        auto operator()(Normal3f const& n) const -> Normal3f {
+            return real.rotate(Vec3f(n)).normalise();
+        }
+    };
+
+    // Up to four bones per vertex, unused slots have zero weight. Weights
+    // are expected to sum to one.
+    struct BoneInfluences {
+        std::array<std::uint16_t, 4> bones{};
+        std::array<FLOAT, 4> weights{};
+    };
+
+    namespace detail {
+        inline constexpr std::size_t skinning_chunk_size = 1 << 12;
+
+        // Vertices per pass of the batch kernels, the arrays of a block
+        // stay in L1
+        inline constexpr std::size_t skinning_block_size = 64;
+
+        // The bones with each of their eight components in an array of its
+        // own, so the blend loads them as gathers with a four byte scale
+        class BoneComponents {
+        public:
+            explicit BoneComponents(Span<DualQuaternion const> bones) : m_components(8 * bones.size()), m_count(bones.size()) {
+                for (std::size_t i = 0; i < bones.size(); ++i) {
+                    auto const& b = bones[i];
+                    FLOAT const components[] = { b.real.v.x, b.real.v.y, b.real.v.z, b.real.w, b.dual.v.x, b.dual.v.y, b.dual.v.z, b.dual.w };
+                    for (std::size_t j = 0; j < 8; ++j) m_components[j * m_count + i] = components[j];
+                }
+            }
+
+            auto component(std::size_t j) const -> FLOAT const* { return m_components.data() + j * m_count; }
+
+        private:
+            std::vector<FLOAT> m_components;
+            std::size_t m_count;
+        };
+
+        // Blended dual quaternions of a block as one array per component,
+        // so the passes over them vectorize
+        struct BlendedBones {
+            std::array<FLOAT, skinning_block_size> rx, ry, rz, rw, dx, dy, dz, dw;
+
+            auto constexpr operator[](std::size_t i) const -> DualQuaternion {
+                return { Quaternion{ Vec3f{ rx[i], ry[i], rz[i] }, rw[i] }, Quaternion{ Vec3f{ dx[i], dy[i], dz[i] }, dw[i] } };
+            }
+        };
+
+        // Dual quaternion linear blending of `count` <= skinning_block_size
+        // vertices; flipping each bone into the hemisphere of the first one
+        // takes the shortest rotation path. The influences are unpacked
+        // first, the flip is a select and the square roots get a loop of
+        // their own: with math errno they do not vectorize, the sums and the
+        // scaling do.
+        inline auto blend(BoneComponents const& bones, BoneInfluences const* influences, std::size_t count, BlendedBones& out) -> void {
+            std::array<std::array<std::uint32_t, skinning_block_size>, 4> index;
+            std::array<std::array<FLOAT, skinning_block_size>, 4> weight;
+            for (std::size_t i = 0; i < count; ++i) {
+                for (std::size_t k = 0; k < 4; ++k) {
+                    index[k][i] = influences[i].bones[k];
+                    weight[k][i] = influences[i].weights[k];
+                }
+            }
+
+            auto const brx = bones.component(0), bry = bones.component(1), brz = bones.component(2), brw = bones.component(3);
+            auto const bdx = bones.component(4), bdy = bones.component(5), bdz = bones.component(6), bdw = bones.component(7);
+            std::array<FLOAT, skinning_block_size> scale;
+            for (std::size_t i = 0; i < count; ++i) {
+                auto const p = index[0][i];
+                FLOAT rx = 0, ry = 0, rz = 0, rw = 0, dx = 0, dy = 0, dz = 0, dw = 0;
+                // unrolled, a loop here keeps the outer one from vectorizing
+                auto const add = [&](std::size_t k) {
+                    auto const b = index[k][i];
+                    auto const dot = brx[p] * brx[b] + bry[p] * bry[b] + brz[p] * brz[b] + brw[p] * brw[b];
+                    auto const w = dot < 0 ? -weight[k][i] : weight[k][i];
+                    rx = rx + brx[b] * w; ry = ry + bry[b] * w; rz = rz + brz[b] * w; rw = rw + brw[b] * w;
+                    dx = dx + bdx[b] * w; dy = dy + bdy[b] * w; dz = dz + bdz[b] * w; dw = dw + bdw[b] * w;
+                };
+                add(0); add(1); add(2); add(3);
+                out.rx[i] = rx; out.ry[i] = ry; out.rz[i] = rz; out.rw[i] = rw;
+                out.dx[i] = dx; out.dy[i] = dy; out.dz[i] = dz; out.dw[i] = dw;
+                scale[i] = rx * rx + ry * ry + rz * rz + rw * rw;
+            }
+            for (std::size_t i = 0; i < count; ++i) scale[i] = 1 / std::sqrt(scale[i]);
+            for (std::size_t i = 0; i < count; ++i) {
+                out.rx[i] *= scale[i]; out.ry[i] *= scale[i]; out.rz[i] *= scale[i]; out.rw[i] *= scale[i];
+                out.dx[i] *= scale[i]; out.dy[i] *= scale[i]; out.dz[i] *= scale[i]; out.dw[i] *= scale[i];
+            }
+        }
+
+        // Calls `apply(blended, first, count)` for the blocks of [begin, end),
+        // compiled for the active CPU tier
+        template<typename Apply>
+        auto skin_blocks(BoneComponents const& bones, BoneInfluences const* influences, std::size_t begin, std::size_t end, Apply const& apply) -> void {
+            dispatch([&] {
+                BlendedBones blended;
+                for (auto first = begin; first < end; first += skinning_block_size) {
+                    auto const count = std::min(skinning_block_size, end - first);
+                    blend(bones, influences + first, count, blended);
+                    apply(blended, first, count);
+                }
+            });
+        }
+
+        // Rotated and normalised in separate passes, as blend
+        inline auto skin_normals(BlendedBones const& blended, Normal3f const* in, std::size_t count, Normal3f* out) -> void {
+            std::array<Vec3f, skinning_block_size> rotated;
+            for (std::size_t i = 0; i < count; ++i) rotated[i] = blended[i].real.rotate(Vec3f(in[i]));
+            for (std::size_t i = 0; i < count; ++i) out[i] = rotated[i].normalise();
+        }
+    }
+
+    // Dual quaternion skinning of `in` by the bones' skinning transforms
+    // (bind pose inverse followed by the animated pose), in parallel over
+    // vertex chunks and vectorized within them at the active CPU tier
+    inline auto skin(Span<DualQuaternion const> bones, Span<BoneInfluences const> influences,
+                     Span<Point3f const> in, Point3f* out) -> void {
+        assert(influences.size() == in.size());
+        detail::BoneComponents const components(bones);
+        parallel_for(in.size(), [&](std::size_t begin, std::size_t end) {
+            detail::skin_blocks(components, influences.data(), begin, end, [&](auto const& blended, std::size_t first, std::size_t count) {
+                for (std::size_t i = 0; i < count; ++i) out[first + i] = blended[i](in.data()[first + i]);
+            });
+        }, detail::skinning_chunk_size);
+    }
+
+    inline auto skin(Span<DualQuaternion const> bones, Span<BoneInfluences const> influences,
+                     Span<Normal3f const> in, Normal3f* out) -> void {
+        assert(influences.size() == in.size());
+        detail::BoneComponents const components(bones);
+        parallel_for(in.size(), [&](std::size_t begin, std::size_t end) {
+            detail::skin_blocks(components, influences.data(), begin, end, [&](auto const& blended, std::size_t first, std::size_t count) {
+                detail::skin_normals(blended, in.data() + first, count, out + first);
+            });
+        }, detail::skinning_chunk_size);
+    }
+
+    // Blends once per vertex for both
+    inline auto skin(Span<DualQuaternion const> bones, Span<BoneInfluences const> influences,
+                     Span<Point3f const> points, Span<Normal3f const> normals,
+                     Point3f* out_points, Normal3f* out_normals) -> void {
+        assert(influences.size() == points.size() && normals.size() == points.size());
+        detail::BoneComponents const components(bones);
+        parallel_for(points.size(), [&](std::size_t begin, std::size_t end) {
+            detail::skin_blocks(components, influences.data(), begin, end, [&](auto const& blended, std::size_t first, std::size_t count) {
+                for (std::size_t i = 0; i < count; ++i) out_points[first + i] = blended[i](points.data()[first + i]);
+                detail::skin_normals(blended, normals.data() + first, count, out_normals + first);
+            });
+        }, detail::skinning_chunk_size);
+    }
+}
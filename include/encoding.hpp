@@ -0,0 +1,307 @@
+#pragma once
+
+#include "vec3.hpp"
+#include "normal3.hpp"
+#include "color3.hpp"
+#include "util.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#if defined(__F16C__)
+    #include <immintrin.h>
+#endif
+
+namespace gm {
+
+    // Octahedral unit vector encoding (Cigolle et al. 2014) with two signed
+    // normalised integers. Octahedral<std::int8_t> packs a normal into 16 bits,
+    // Octahedral<std::int16_t> into 32 bits.
+    template<typename Storage>
+    struct Octahedral {
+        static_assert(std::is_integral_v<Storage> && std::is_signed_v<Storage>);
+        Storage u, v;
+
+        auto constexpr operator==(Octahedral<Storage> const& other) const -> bool {
+            return u == other.u && v == other.v;
+        }
+
+        auto constexpr operator!=(Octahedral<Storage> const& other) const -> bool {
+            return !(*this == other);
+        }
+    };
+
+    typedef Octahedral<std::int8_t> Oct16;
+    typedef Octahedral<std::int16_t> Oct32;
+
+    namespace detail {
+
+        auto constexpr sign_not_zero(FLOAT v) -> FLOAT {
+            return v >= 0 ? FLOAT(1) : FLOAT(-1);
+        }
+
+        // Projects a unit vector onto the octahedron and unfolds it to [-1,1]^2
+        auto constexpr octahedral_project(Normal3f const& n) -> std::tuple<FLOAT, FLOAT> {
+            auto const inv_l1 = 1 / (gcem::abs(n.x()) + gcem::abs(n.y()) + gcem::abs(n.z()));
+            auto const px = n.x() * inv_l1;
+            auto const py = n.y() * inv_l1;
+            if (n.z() >= 0) return { px, py };
+            return { (1 - gcem::abs(py)) * sign_not_zero(px), (1 - gcem::abs(px)) * sign_not_zero(py) };
+        }
+
+        template<typename Storage>
+        auto constexpr snorm_max() -> FLOAT {
+            return static_cast<FLOAT>(std::numeric_limits<Storage>::max());
+        }
+
+        auto constexpr octahedral_unfold(FLOAT x, FLOAT y) -> Vec3f {
+            auto const z = 1 - gcem::abs(x) - gcem::abs(y);
+            auto const t = std::max(-z, FLOAT(0));
+            return { x + (x >= 0 ? -t : t), y + (y >= 0 ? -t : t), z };
+        }
+    }
+
+    // Rounds to the nearest representable encoding
+    template<typename Storage>
+    auto encode_octahedral(Normal3f const& n) -> Octahedral<Storage> {
+        auto const [x, y] = detail::octahedral_project(n);
+        auto constexpr scale = detail::snorm_max<Storage>();
+        return { static_cast<Storage>(std::round(std::clamp(x, FLOAT(-1), FLOAT(1)) * scale)),
+                 static_cast<Storage>(std::round(std::clamp(y, FLOAT(-1), FLOAT(1)) * scale)) };
+    }
+
+    template<typename Storage>
+    auto decode_octahedral(Octahedral<Storage> const& e) -> Normal3f {
+        auto constexpr inv_scale = 1 / detail::snorm_max<Storage>();
+        // snorm: the most negative value maps to -1 as well
+        auto const x = std::max(e.u * inv_scale, FLOAT(-1));
+        auto const y = std::max(e.v * inv_scale, FLOAT(-1));
+        return detail::octahedral_unfold(x, y).normalise();
+    }
+
+    // Picks the floor/ceil combination with the smallest angular error,
+    // roughly halving the maximum error at four times the cost
+    template<typename Storage>
+    auto encode_octahedral_precise(Normal3f const& n) -> Octahedral<Storage> {
+        auto const [x, y] = detail::octahedral_project(n);
+        auto constexpr scale = detail::snorm_max<Storage>();
+        auto const fx = std::floor(std::clamp(x, FLOAT(-1), FLOAT(1)) * scale);
+        auto const fy = std::floor(std::clamp(y, FLOAT(-1), FLOAT(1)) * scale);
+
+        auto const target = static_cast<Vec3f>(n);
+        auto best = Octahedral<Storage>{};
+        auto best_error = std::numeric_limits<FLOAT>::max();
+        for (int i = 0; i < 4; ++i) {
+            auto const cx = std::min(fx + (i & 1), scale);
+            auto const cy = std::min(fy + (i >> 1), scale);
+            auto const candidate = Octahedral<Storage>{ static_cast<Storage>(cx), static_cast<Storage>(cy) };
+            // the chord length resolves small angles better than a float dot product
+            auto const error = (static_cast<Vec3f>(decode_octahedral(candidate)) - target).length_squared();
+            if (error < best_error) {
+                best_error = error;
+                best = candidate;
+            }
+        }
+        return best;
+    }
+
+    template<typename Storage>
+    auto encode_octahedral(Normal3f const* normals, Octahedral<Storage>* out, std::size_t count) -> void {
+        for (std::size_t i = 0; i < count; ++i) out[i] = encode_octahedral<Storage>(normals[i]);
+    }
+
+    template<typename Storage>
+    auto decode_octahedral(Octahedral<Storage> const* encoded, Normal3f* out, std::size_t count) -> void {
+        for (std::size_t i = 0; i < count; ++i) out[i] = decode_octahedral(encoded[i]);
+    }
+
+    // IEEE 754 binary16 storage type. Arithmetic is done after converting to float.
+    class Half {
+    public:
+        constexpr Half() : m_bits(0) { }
+        explicit Half(float value) : m_bits(from_float(value)) { }
+
+        static auto constexpr from_bits(std::uint16_t bits) -> Half {
+            auto h = Half{};
+            h.m_bits = bits;
+            return h;
+        }
+
+        auto constexpr bits() const -> std::uint16_t { return m_bits; }
+
+        explicit operator float() const { return to_float(m_bits); }
+
+        auto constexpr operator==(Half const& other) const -> bool { return m_bits == other.m_bits; }
+        auto constexpr operator!=(Half const& other) const -> bool { return m_bits != other.m_bits; }
+
+        // Round to nearest even, overflow to infinity, NaNs stay NaN (F. Giesen)
+        static auto from_float(float value) -> std::uint16_t {
+            std::uint32_t f;
+            std::memcpy(&f, &value, sizeof(f));
+            auto const sign = f & 0x80000000u;
+            f ^= sign;
+
+            std::uint32_t o;
+            if (f >= 0x47800000u) {
+                o = f > 0x7f800000u ? 0x7e00u : 0x7c00u;
+            } else if (f < 0x38800000u) {
+                // denormal result: let the float adder do the rounding
+                auto const denorm_magic = std::uint32_t{ ((127 - 15) + (23 - 10) + 1) << 23 };
+                float magic, shifted;
+                std::memcpy(&magic, &denorm_magic, sizeof(magic));
+                std::memcpy(&shifted, &f, sizeof(shifted));
+                shifted += magic;
+                std::memcpy(&o, &shifted, sizeof(o));
+                o -= denorm_magic;
+            } else {
+                auto const mantissa_odd = (f >> 13) & 1;
+                f += (static_cast<std::uint32_t>(15 - 127) << 23) + 0xfff;
+                f += mantissa_odd;
+                o = f >> 13;
+            }
+            return static_cast<std::uint16_t>(o | (sign >> 16));
+        }
+
+        static auto to_float(std::uint16_t h) -> float {
+            auto constexpr shifted_exponent = std::uint32_t{ 0x7c00u << 13 };
+            auto o = static_cast<std::uint32_t>(h & 0x7fffu) << 13;
+            auto const exponent = shifted_exponent & o;
+            o += static_cast<std::uint32_t>(127 - 15) << 23;
+
+            float result;
+            if (exponent == shifted_exponent) {
+                o += static_cast<std::uint32_t>(128 - 16) << 23;
+                std::memcpy(&result, &o, sizeof(result));
+            } else if (exponent == 0) {
+                auto constexpr magic_bits = std::uint32_t{ 113u << 23 };
+                float magic;
+                std::memcpy(&magic, &magic_bits, sizeof(magic));
+                o += 1u << 23;
+                std::memcpy(&result, &o, sizeof(result));
+                result -= magic;
+            } else {
+                std::memcpy(&result, &o, sizeof(result));
+            }
+
+            if (h & 0x8000u) result = -result;
+            return result;
+        }
+
+    private:
+        std::uint16_t m_bits;
+    };
+
+    // Half precision storage for hot arrays, convert to Vec3f for arithmetic
+    struct Vec3h {
+        Half x, y, z;
+
+        constexpr Vec3h() = default;
+        explicit Vec3h(Vec3f const& v)
+            : x(static_cast<float>(v.x)), y(static_cast<float>(v.y)), z(static_cast<float>(v.z)) { }
+
+        explicit operator Vec3f() const {
+            return { static_cast<FLOAT>(static_cast<float>(x)),
+                     static_cast<FLOAT>(static_cast<float>(y)),
+                     static_cast<FLOAT>(static_cast<float>(z)) };
+        }
+    };
+
+    struct Color3h {
+        Half r, g, b;
+
+        constexpr Color3h() = default;
+        explicit Color3h(Color3f const& c)
+            : r(static_cast<float>(c.r)), g(static_cast<float>(c.g)), b(static_cast<float>(c.b)) { }
+
+        explicit operator Color3f() const {
+            return { static_cast<FLOAT>(static_cast<float>(r)),
+                     static_cast<FLOAT>(static_cast<float>(g)),
+                     static_cast<FLOAT>(static_cast<float>(b)) };
+        }
+    };
+
+    // Converts `count` floats, using F16C when the target supports it
+    inline auto float_to_half(float const* in, Half* out, std::size_t count) -> void {
+        std::size_t i = 0;
+#if defined(__F16C__)
+        for (; i + 8 <= count; i += 8) {
+            auto const h = _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), h);
+        }
+#endif
+        for (; i < count; ++i) out[i] = Half{ in[i] };
+    }
+
+    inline auto half_to_float(Half const* in, float* out, std::size_t count) -> void {
+        std::size_t i = 0;
+#if defined(__F16C__)
+        for (; i + 8 <= count; i += 8) {
+            auto const h = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i));
+            _mm256_storeu_ps(out + i, _mm256_cvtph_ps(h));
+        }
+#endif
+        for (; i < count; ++i) out[i] = static_cast<float>(in[i]);
+    }
+
+    static_assert(sizeof(Half) == 2 && sizeof(Vec3h) == 6 && sizeof(Color3h) == 6);
+
+    namespace detail {
+        // `count` components as one contiguous stream. Templates, so the F16C
+        // path for float is not compiled when FLOAT is double.
+        template<typename T>
+        auto components_to_half(T const* in, Half* out, std::size_t count) -> void {
+            if constexpr (std::is_same_v<T, float>) {
+                float_to_half(in, out, count);
+            } else {
+                for (std::size_t i = 0; i < count; ++i) out[i] = Half{ static_cast<float>(in[i]) };
+            }
+        }
+
+        template<typename T>
+        auto components_from_half(Half const* in, T* out, std::size_t count) -> void {
+            if constexpr (std::is_same_v<T, float>) {
+                half_to_float(in, out, count);
+            } else {
+                for (std::size_t i = 0; i < count; ++i) out[i] = static_cast<T>(static_cast<float>(in[i]));
+            }
+        }
+    }
+
+    // The array overloads treat the components as one contiguous stream,
+    // which is what lets them use the wide F16C path when FLOAT is float
+
+    inline auto encode_half(Vec3f const* in, Vec3h* out, std::size_t count) -> void {
+        if constexpr (sizeof(Vec3f) == 3 * sizeof(FLOAT)) {
+            detail::components_to_half(&in->x, &out->x, 3 * count);
+        } else {
+            for (std::size_t i = 0; i < count; ++i) out[i] = Vec3h{ in[i] };
+        }
+    }
+
+    inline auto decode_half(Vec3h const* in, Vec3f* out, std::size_t count) -> void {
+        if constexpr (sizeof(Vec3f) == 3 * sizeof(FLOAT)) {
+            detail::components_from_half(&in->x, &out->x, 3 * count);
+        } else {
+            for (std::size_t i = 0; i < count; ++i) out[i] = static_cast<Vec3f>(in[i]);
+        }
+    }
+
+    inline auto encode_half(Color3f const* in, Color3h* out, std::size_t count) -> void {
+        if constexpr (sizeof(Color3f) == 3 * sizeof(FLOAT)) {
+            detail::components_to_half(&in->r, &out->r, 3 * count);
+        } else {
+            for (std::size_t i = 0; i < count; ++i) out[i] = Color3h{ in[i] };
+        }
+    }
+
+    inline auto decode_half(Color3h const* in, Color3f* out, std::size_t count) -> void {
+        if constexpr (sizeof(Color3f) == 3 * sizeof(FLOAT)) {
+            detail::components_from_half(&in->r, &out->r, 3 * count);
+        } else {
+            for (std::size_t i = 0; i < count; ++i) out[i] = static_cast<Color3f>(in[i]);
+        }
+    }
+}
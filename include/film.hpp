@@ -0,0 +1,269 @@
+#pragma once
+
+#include "color3.hpp"
+#include "point2.hpp"
+#include "util.hpp"
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+namespace gm {
+
+    namespace detail {
+        // Lock-free floating point add, std::atomic<float>::fetch_add is C++20
+        inline auto atomic_add(std::atomic<FLOAT>& target, FLOAT value) -> void {
+            auto current = target.load(std::memory_order_relaxed);
+            while (!target.compare_exchange_weak(current, current + value, std::memory_order_relaxed)) { }
+        }
+    }
+
+    // Separable reconstruction filter f(x) * f(y), tabulated over [0, radius]
+    class Filter {
+    public:
+        static auto box(FLOAT radius = FLOAT(0.5)) -> Filter {
+            return Filter{ radius, [](FLOAT) { return FLOAT(1); } };
+        }
+
+        static auto triangle(FLOAT radius = 2) -> Filter {
+            return Filter{ radius, [radius](FLOAT x) { return std::max(FLOAT(0), radius - x); } };
+        }
+
+        static auto gaussian(FLOAT radius = FLOAT(1.5), FLOAT sigma = FLOAT(0.5)) -> Filter {
+            auto const edge = std::exp(-radius * radius / (2 * sigma * sigma));
+            return Filter{ radius, [=](FLOAT x) { return std::max(FLOAT(0), std::exp(-x * x / (2 * sigma * sigma)) - edge); } };
+        }
+
+        static auto mitchell(FLOAT radius = 2, FLOAT b = FLOAT(1) / 3, FLOAT c = FLOAT(1) / 3) -> Filter {
+            return Filter{ radius, [=](FLOAT x) {
+                x = 2 * x / radius;
+                if (x > 1) {
+                    return ((-b - 6 * c) * x * x * x + (6 * b + 30 * c) * x * x + (-12 * b - 48 * c) * x + (8 * b + 24 * c)) / 6;
+                }
+                return ((12 - 9 * b - 6 * c) * x * x * x + (-18 + 12 * b + 6 * c) * x * x + (6 - 2 * b)) / 6;
+            } };
+        }
+
+        auto constexpr radius() const -> FLOAT { return m_radius; }
+
+        // 1D weight at offset x from the pixel center
+        auto evaluate(FLOAT x) const -> FLOAT {
+            auto const index = static_cast<std::size_t>(gcem::abs(x) * m_inv_step);
+            return index < table_size ? m_table[index] : FLOAT(0);
+        }
+
+    private:
+        static constexpr std::size_t table_size = 64;
+
+        template<typename Function>
+        Filter(FLOAT radius, Function const& f) : m_radius(radius), m_inv_step(table_size / radius) {
+            for (std::size_t i = 0; i < table_size; ++i) {
+                // sample at the bin center
+                m_table[i] = f((i + FLOAT(0.5)) * radius / table_size);
+            }
+        }
+
+        FLOAT m_radius;
+        FLOAT m_inv_step;
+        std::array<FLOAT, table_size> m_table{};
+    };
+
+    // Half-open pixel rectangle [min, max)
+    struct PixelBounds {
+        Point2i min;
+        Point2i max;
+
+        auto constexpr width() const -> int { return max.x - min.x; }
+        auto constexpr height() const -> int { return max.y - min.y; }
+        auto constexpr area() const -> int { return width() * height(); }
+    };
+
+    class Film;
+
+    // Thread-local accumulation buffer for one tile. It covers the tile
+    // expanded by the filter radius, and is merged into the film when the
+    // tile is done.
+    class FilmTile {
+    public:
+        auto bounds() const -> PixelBounds const& { return m_tile; }
+
+        // Adds a radiance sample at a continuous raster position
+        auto add_sample(Point2f const& position, Color3f const& radiance) -> void {
+            add_samples(&position, &radiance, 1);
+        }
+
+        auto add_samples(Point2f const* positions, Color3f const* radiance, std::size_t count) -> void {
+            auto const radius = m_filter->radius();
+            FLOAT wx[max_footprint], wy[max_footprint];
+
+            for (std::size_t s = 0; s < count; ++s) {
+                // pixel centers are at integer + 0.5
+                auto const px = positions[s].x - FLOAT(0.5);
+                auto const py = positions[s].y - FLOAT(0.5);
+                auto const x0 = std::max(static_cast<int>(std::ceil(px - radius)), m_buffer.min.x);
+                auto const x1 = std::min(static_cast<int>(std::floor(px + radius)) + 1, m_buffer.max.x);
+                auto const y0 = std::max(static_cast<int>(std::ceil(py - radius)), m_buffer.min.y);
+                auto const y1 = std::min(static_cast<int>(std::floor(py + radius)) + 1, m_buffer.max.y);
+                if (x0 >= x1 || y0 >= y1) continue;
+
+                // 1D weights once per sample, the footprint is their outer product
+                for (int x = x0; x < x1; ++x) wx[x - x0] = m_filter->evaluate(x - px);
+                for (int y = y0; y < y1; ++y) wy[y - y0] = m_filter->evaluate(y - py);
+
+                auto const& L = radiance[s];
+                for (int y = y0; y < y1; ++y) {
+                    auto* row = m_pixels.data() + static_cast<std::size_t>((y - m_buffer.min.y) * m_buffer.width() + (x0 - m_buffer.min.x));
+                    for (int x = 0; x < x1 - x0; ++x) {
+                        auto const weight = wx[x] * wy[y - y0];
+                        row[x].sum += weight * L;
+                        row[x].weight += weight;
+                    }
+                }
+            }
+        }
+
+    private:
+        friend class Film;
+
+        struct Pixel {
+            Color3f sum;
+            FLOAT weight = 0;
+        };
+
+        static constexpr int max_footprint = 64;
+
+        FilmTile(PixelBounds const& tile, PixelBounds const& buffer, Filter const& filter)
+            : m_tile(tile), m_buffer(buffer), m_filter(&filter), m_pixels(static_cast<std::size_t>(buffer.area())) { }
+
+        PixelBounds m_tile;
+        PixelBounds m_buffer;
+        Filter const* m_filter;
+        std::vector<Pixel> m_pixels;
+    };
+
+    // Image accumulator for concurrent rendering. Camera paths go through
+    // FilmTiles, light tracing contributions are splatted directly with atomics.
+    class Film {
+    public:
+        Film(int width, int height, Filter const& filter, int tile_size = 32)
+            : m_width(width), m_height(height), m_tile_size(tile_size), m_filter(filter),
+              m_pixels(std::make_unique<Pixel[]>(static_cast<std::size_t>(width) * height)) {
+            assert(width > 0 && height > 0 && tile_size > 0);
+            assert(2 * static_cast<int>(std::ceil(filter.radius())) + 1 <= FilmTile::max_footprint);
+        }
+
+        auto width() const -> int { return m_width; }
+        auto height() const -> int { return m_height; }
+        auto filter() const -> Filter const& { return m_filter; }
+
+        auto tiles() const -> std::vector<PixelBounds> {
+            std::vector<PixelBounds> result;
+            for (int y = 0; y < m_height; y += m_tile_size) {
+                for (int x = 0; x < m_width; x += m_tile_size) {
+                    result.push_back({ { x, y }, { std::min(x + m_tile_size, m_width), std::min(y + m_tile_size, m_height) } });
+                }
+            }
+            return result;
+        }
+
+        auto make_tile(PixelBounds const& tile) const -> FilmTile {
+            auto const r = static_cast<int>(std::ceil(m_filter.radius()));
+            auto const buffer = PixelBounds{
+                { std::max(tile.min.x - r, 0), std::max(tile.min.y - r, 0) },
+                { std::min(tile.max.x + r, m_width), std::min(tile.max.y + r, m_height) } };
+            return FilmTile{ tile, buffer, m_filter };
+        }
+
+        // Thread-safe, tiles overlap by the filter radius so their borders are
+        // merged with atomic adds
+        auto merge(FilmTile const& tile) -> void {
+            auto const& b = tile.m_buffer;
+            for (int y = b.min.y; y < b.max.y; ++y) {
+                for (int x = b.min.x; x < b.max.x; ++x) {
+                    auto const& source = tile.m_pixels[static_cast<std::size_t>((y - b.min.y) * b.width() + (x - b.min.x))];
+                    if (source.weight == 0) continue;
+                    auto& pixel = at(x, y);
+                    detail::atomic_add(pixel.r, source.sum.r);
+                    detail::atomic_add(pixel.g, source.sum.g);
+                    detail::atomic_add(pixel.b, source.sum.b);
+                    detail::atomic_add(pixel.weight, source.weight);
+                }
+            }
+        }
+
+        // Thread-safe and lock-free. Splats are not normalised by filter weight,
+        // scale them with `splat_scale` in resolve.
+        auto add_splat(Point2f const& position, Color3f const& radiance) -> void {
+            auto const px = position.x - FLOAT(0.5);
+            auto const py = position.y - FLOAT(0.5);
+            auto const radius = m_filter.radius();
+            auto const x0 = std::max(static_cast<int>(std::ceil(px - radius)), 0);
+            auto const x1 = std::min(static_cast<int>(std::floor(px + radius)) + 1, m_width);
+            auto const y0 = std::max(static_cast<int>(std::ceil(py - radius)), 0);
+            auto const y1 = std::min(static_cast<int>(std::floor(py + radius)) + 1, m_height);
+
+            // normalise the footprint so a splat deposits exactly its radiance
+            FLOAT wx[FilmTile::max_footprint], wy[FilmTile::max_footprint];
+            auto sum_x = FLOAT(0), sum_y = FLOAT(0);
+            for (int x = x0; x < x1; ++x) sum_x += wx[x - x0] = m_filter.evaluate(x - px);
+            for (int y = y0; y < y1; ++y) sum_y += wy[y - y0] = m_filter.evaluate(y - py);
+            if (sum_x == 0 || sum_y == 0) return;
+            auto const normalisation = 1 / (sum_x * sum_y);
+
+            for (int y = y0; y < y1; ++y) {
+                for (int x = x0; x < x1; ++x) {
+                    auto const weight = wx[x - x0] * wy[y - y0] * normalisation;
+                    if (weight == 0) continue;
+                    auto& pixel = at(x, y);
+                    detail::atomic_add(pixel.splat_r, weight * radiance.r);
+                    detail::atomic_add(pixel.splat_g, weight * radiance.g);
+                    detail::atomic_add(pixel.splat_b, weight * radiance.b);
+                }
+            }
+        }
+
+        // Final pixel value: filtered camera samples plus scaled splats
+        auto pixel(int x, int y, FLOAT splat_scale = 1) const -> Color3f {
+            auto const& p = m_pixels[static_cast<std::size_t>(y) * m_width + x];
+            auto const weight = p.weight.load(std::memory_order_relaxed);
+            auto color = Color3f{};
+            if (weight != 0) {
+                color = Color3f{ p.r.load(std::memory_order_relaxed),
+                                 p.g.load(std::memory_order_relaxed),
+                                 p.b.load(std::memory_order_relaxed) } / weight;
+            }
+            return color + splat_scale * Color3f{ p.splat_r.load(std::memory_order_relaxed),
+                                                  p.splat_g.load(std::memory_order_relaxed),
+                                                  p.splat_b.load(std::memory_order_relaxed) };
+        }
+
+        // Row-major, width * height entries
+        auto resolve(Color3f* out, FLOAT splat_scale = 1) const -> void {
+            for (int y = 0; y < m_height; ++y) {
+                for (int x = 0; x < m_width; ++x) {
+                    out[static_cast<std::size_t>(y) * m_width + x] = pixel(x, y, splat_scale);
+                }
+            }
+        }
+
+    private:
+        struct Pixel {
+            std::atomic<FLOAT> r{0}, g{0}, b{0}, weight{0};
+            std::atomic<FLOAT> splat_r{0}, splat_g{0}, splat_b{0};
+        };
+
+        auto at(int x, int y) -> Pixel& {
+            return m_pixels[static_cast<std::size_t>(y) * m_width + x];
+        }
+
+        int m_width;
+        int m_height;
+        int m_tile_size;
+        Filter m_filter;
+        std::unique_ptr<Pixel[]> m_pixels;
+    };
+}
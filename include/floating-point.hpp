@@ -0,0 +1,142 @@
+#pragma once
+
+#include "vec3.hpp"
+#include "color3.hpp"
+#include "span.hpp"
+#include "util.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #include <xmmintrin.h>
+    #define GM_HAS_MXCSR 1
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+    #define GM_HAS_FPCR 1
+#endif
+
+namespace gm {
+
+    // Sets flush-to-zero and denormals-are-zero for the current thread and
+    // restores the previous mode on destruction. Arithmetic on denormals is
+    // microcoded on most x86 cores and can be two orders of magnitude slower.
+    // The mode is per thread, so create one at the top of each worker.
+    class ScopedFlushToZero {
+    public:
+        ScopedFlushToZero() {
+#if defined(GM_HAS_MXCSR)
+            m_previous = _mm_getcsr();
+            // FTZ is bit 15, DAZ bit 6
+            _mm_setcsr(m_previous | 0x8040u);
+#elif defined(GM_HAS_FPCR)
+            std::uint64_t fpcr;
+            __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+            m_previous = fpcr;
+            // FZ is bit 24 and covers both inputs and outputs
+            fpcr |= std::uint64_t(1) << 24;
+            __asm__ __volatile__("msr fpcr, %0" : : "r"(fpcr));
+#endif
+        }
+
+        ~ScopedFlushToZero() {
+#if defined(GM_HAS_MXCSR)
+            _mm_setcsr(static_cast<unsigned int>(m_previous));
+#elif defined(GM_HAS_FPCR)
+            __asm__ __volatile__("msr fpcr, %0" : : "r"(m_previous));
+#endif
+        }
+
+        ScopedFlushToZero(ScopedFlushToZero const&) = delete;
+        auto operator=(ScopedFlushToZero const&) -> ScopedFlushToZero& = delete;
+
+        // Whether the guard has any effect on this platform
+        static auto constexpr supported() -> bool {
+#if defined(GM_HAS_MXCSR) || defined(GM_HAS_FPCR)
+            return true;
+#else
+            return false;
+#endif
+        }
+
+    private:
+        std::uint64_t m_previous = 0;
+    };
+
+    namespace detail {
+        using FloatBits = std::conditional_t<sizeof(FLOAT) == 4, std::uint32_t, std::uint64_t>;
+        inline constexpr FloatBits sign_mask = FloatBits(1) << (sizeof(FLOAT) * 8 - 1);
+        inline constexpr FloatBits exponent_mask = sizeof(FLOAT) == 4 ? FloatBits(0x7f800000u) : FloatBits(0x7ff0000000000000ull);
+
+        inline auto to_bits(FLOAT x) -> FloatBits {
+            FloatBits bits;
+            std::memcpy(&bits, &x, sizeof(x));
+            return bits;
+        }
+
+        inline auto from_bits(FloatBits bits) -> FLOAT {
+            FLOAT x;
+            std::memcpy(&x, &bits, sizeof(x));
+            return x;
+        }
+
+        // Bit tests rather than std::isfinite/fpclassify, which do not
+        // vectorize and are folded away under -ffast-math
+        inline auto flush_nonfinite(FLOAT& x, FLOAT replacement) -> std::size_t {
+            auto const nonfinite = (to_bits(x) & exponent_mask) == exponent_mask;
+            x = nonfinite ? replacement : x;
+            return nonfinite;
+        }
+
+        // Replaces denormals with zero of the same sign
+        inline auto clamp_denormal(FLOAT& x) -> std::size_t {
+            auto const bits = to_bits(x);
+            auto const denormal = (bits & exponent_mask) == 0 && (bits & ~sign_mask) != 0;
+            x = from_bits(denormal ? bits & sign_mask : bits);
+            return denormal;
+        }
+    }
+
+    // Replaces NaN and infinite components, returns how many were replaced
+    inline auto flush_nonfinite(Span<Vec3f> values, FLOAT replacement = 0) -> std::size_t {
+        std::size_t flushed = 0;
+        auto* v = values.data();
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            flushed += detail::flush_nonfinite(v[i].x, replacement)
+                     + detail::flush_nonfinite(v[i].y, replacement)
+                     + detail::flush_nonfinite(v[i].z, replacement);
+        }
+        return flushed;
+    }
+
+    inline auto flush_nonfinite(Span<Color3f> values, FLOAT replacement = 0) -> std::size_t {
+        std::size_t flushed = 0;
+        auto* c = values.data();
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            flushed += detail::flush_nonfinite(c[i].r, replacement)
+                     + detail::flush_nonfinite(c[i].g, replacement)
+                     + detail::flush_nonfinite(c[i].b, replacement);
+        }
+        return flushed;
+    }
+
+    // Replaces denormal components with signed zero, returns how many were replaced
+    inline auto clamp_denormals(Span<Vec3f> values) -> std::size_t {
+        std::size_t clamped = 0;
+        auto* v = values.data();
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            clamped += detail::clamp_denormal(v[i].x) + detail::clamp_denormal(v[i].y) + detail::clamp_denormal(v[i].z);
+        }
+        return clamped;
+    }
+
+    inline auto clamp_denormals(Span<Color3f> values) -> std::size_t {
+        std::size_t clamped = 0;
+        auto* c = values.data();
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            clamped += detail::clamp_denormal(c[i].r) + detail::clamp_denormal(c[i].g) + detail::clamp_denormal(c[i].b);
+        }
+        return clamped;
+    }
+}
@@ -0,0 +1,267 @@
+#pragma once
+
+#include "vec3.hpp"
+#include "point3.hpp"
+#include "normal3.hpp"
+#include "color3.hpp"
+#include "matrix4x4.hpp"
+#include "util.hpp"
+
+#include <charconv>
+#include <cstddef>
+#include <limits>
+#include <system_error>
+#include <type_traits>
+
+#if defined(GRAPHICS_MATH_FMT)
+    #include <fmt/format.h>
+#endif
+
+#if defined(__has_include)
+    #if __has_include(<version>)
+        #include <version>
+    #endif
+#endif
+
+#if defined(__cpp_lib_format)
+    #include <format>
+#endif
+
+// Locale independent, allocation free text conversion. Scalars are written in
+// the shortest form that parses back to the same value, using the brackets of
+// operator<< but without the trailing newline:
+//
+//   Vec3, Normal3   [x,y,z]
+//   Point3, Color3  (x,y,z)
+//   Matrix4x4       [[a00,a01,a02,a03],[a10,...],...]
+//
+// The parsers accept exactly what the formatters write, and additionally
+// spaces after the separators.
+namespace gm {
+
+    namespace detail {
+        // Upper bound on the characters std::to_chars needs for one scalar
+        template<typename Type>
+        auto constexpr max_scalar_chars() -> std::size_t {
+            if constexpr (std::is_floating_point_v<Type>) {
+                // sign, digits, point, 'e', exponent sign and digits
+                return 4 + std::numeric_limits<Type>::max_digits10 + 1 + 4;
+            } else {
+                return 1 + std::numeric_limits<Type>::digits10 + 1;
+            }
+        }
+
+        template<typename Type>
+        auto write_scalars(char* first, char* last, char open, char close,
+                           Type const* values, std::size_t count) -> std::to_chars_result {
+            if (first == last) return { last, std::errc::value_too_large };
+            *first++ = open;
+            for (std::size_t i = 0; i < count; ++i) {
+                if (i != 0) {
+                    if (first == last) return { last, std::errc::value_too_large };
+                    *first++ = ',';
+                }
+                auto const result = std::to_chars(first, last, values[i]);
+                if (result.ec != std::errc{}) return result;
+                first = result.ptr;
+            }
+            if (first == last) return { last, std::errc::value_too_large };
+            *first++ = close;
+            return { first, std::errc{} };
+        }
+
+        inline auto skip_spaces(char const* first, char const* last) -> char const* {
+            while (first != last && *first == ' ') ++first;
+            return first;
+        }
+
+        inline auto expect(char const* first, char const* last, char c) -> char const* {
+            first = skip_spaces(first, last);
+            return first != last && *first == c ? first + 1 : nullptr;
+        }
+
+        template<typename Type>
+        auto read_scalars(char const* first, char const* last, char open, char close,
+                          Type* values, std::size_t count) -> std::from_chars_result {
+            auto const start = first;
+            if ((first = expect(first, last, open)) == nullptr) return { start, std::errc::invalid_argument };
+            for (std::size_t i = 0; i < count; ++i) {
+                if (i != 0 && (first = expect(first, last, ',')) == nullptr) return { start, std::errc::invalid_argument };
+                first = skip_spaces(first, last);
+                auto const result = std::from_chars(first, last, values[i]);
+                if (result.ec != std::errc{}) return result;
+                first = result.ptr;
+            }
+            if ((first = expect(first, last, close)) == nullptr) return { start, std::errc::invalid_argument };
+            return { first, std::errc{} };
+        }
+    }
+
+    template<typename Type>
+    auto to_chars(char* first, char* last, Vec3<Type> const& v) -> std::to_chars_result {
+        Type const values[] = { v.x, v.y, v.z };
+        return detail::write_scalars(first, last, '[', ']', values, 3);
+    }
+
+    template<typename Type>
+    auto to_chars(char* first, char* last, Normal3<Type> const& n) -> std::to_chars_result {
+        Type const values[] = { n.x(), n.y(), n.z() };
+        return detail::write_scalars(first, last, '[', ']', values, 3);
+    }
+
+    template<typename Type>
+    auto to_chars(char* first, char* last, Point3<Type> const& p) -> std::to_chars_result {
+        Type const values[] = { p.x, p.y, p.z };
+        return detail::write_scalars(first, last, '(', ')', values, 3);
+    }
+
+    template<typename Type>
+    auto to_chars(char* first, char* last, Color3<Type> const& c) -> std::to_chars_result {
+        Type const values[] = { c.r, c.g, c.b };
+        return detail::write_scalars(first, last, '(', ')', values, 3);
+    }
+
+    template<typename Type>
+    auto to_chars(char* first, char* last, Matrix4x4<Type> const& m) -> std::to_chars_result {
+        if (first == last) return { last, std::errc::value_too_large };
+        *first++ = '[';
+        for (int i = 0; i < 4; ++i) {
+            if (i != 0) {
+                if (first == last) return { last, std::errc::value_too_large };
+                *first++ = ',';
+            }
+            Type const row[] = { m(i, 0), m(i, 1), m(i, 2), m(i, 3) };
+            auto const result = detail::write_scalars(first, last, '[', ']', row, 4);
+            if (result.ec != std::errc{}) return result;
+            first = result.ptr;
+        }
+        if (first == last) return { last, std::errc::value_too_large };
+        *first++ = ']';
+        return { first, std::errc{} };
+    }
+
+    template<typename Type>
+    auto from_chars(char const* first, char const* last, Vec3<Type>& v) -> std::from_chars_result {
+        Type values[3];
+        auto const result = detail::read_scalars(first, last, '[', ']', values, 3);
+        if (result.ec == std::errc{}) v = Vec3<Type>{ values[0], values[1], values[2] };
+        return result;
+    }
+
+    template<typename Type>
+    auto from_chars(char const* first, char const* last, Normal3<Type>& n) -> std::from_chars_result {
+        Type values[3];
+        auto const result = detail::read_scalars(first, last, '[', ']', values, 3);
+        if (result.ec == std::errc{}) n = Normal3<Type>{ values[0], values[1], values[2] };
+        return result;
+    }
+
+    template<typename Type>
+    auto from_chars(char const* first, char const* last, Point3<Type>& p) -> std::from_chars_result {
+        Type values[3];
+        auto const result = detail::read_scalars(first, last, '(', ')', values, 3);
+        if (result.ec == std::errc{}) p = Point3<Type>{ values[0], values[1], values[2] };
+        return result;
+    }
+
+    template<typename Type>
+    auto from_chars(char const* first, char const* last, Color3<Type>& c) -> std::from_chars_result {
+        Type values[3];
+        auto const result = detail::read_scalars(first, last, '(', ')', values, 3);
+        if (result.ec == std::errc{}) c = Color3<Type>{ values[0], values[1], values[2] };
+        return result;
+    }
+
+    template<typename Type>
+    auto from_chars(char const* first, char const* last, Matrix4x4<Type>& m) -> std::from_chars_result {
+        auto const start = first;
+        Type values[4][4];
+        if ((first = detail::expect(first, last, '[')) == nullptr) return { start, std::errc::invalid_argument };
+        for (int i = 0; i < 4; ++i) {
+            if (i != 0 && (first = detail::expect(first, last, ',')) == nullptr) return { start, std::errc::invalid_argument };
+            auto const result = detail::read_scalars(detail::skip_spaces(first, last), last, '[', ']', values[i], 4);
+            if (result.ec != std::errc{}) return result;
+            first = result.ptr;
+        }
+        if ((first = detail::expect(first, last, ']')) == nullptr) return { start, std::errc::invalid_argument };
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) m(i, j) = values[i][j];
+        }
+        return { first, std::errc{} };
+    }
+
+    // Upper bound on the characters to_chars writes for one value
+    template<typename>
+    struct formatted_size;
+
+    template<typename Type> struct formatted_size<Vec3<Type>> { static constexpr std::size_t value = 4 + 3 * detail::max_scalar_chars<Type>(); };
+    template<typename Type> struct formatted_size<Normal3<Type>> { static constexpr std::size_t value = 4 + 3 * detail::max_scalar_chars<Type>(); };
+    template<typename Type> struct formatted_size<Point3<Type>> { static constexpr std::size_t value = 4 + 3 * detail::max_scalar_chars<Type>(); };
+    template<typename Type> struct formatted_size<Color3<Type>> { static constexpr std::size_t value = 4 + 3 * detail::max_scalar_chars<Type>(); };
+    template<typename Type> struct formatted_size<Matrix4x4<Type>> { static constexpr std::size_t value = 5 + 4 * (5 + 4 * detail::max_scalar_chars<Type>()); };
+
+    template<typename Value>
+    inline constexpr std::size_t formatted_size_v = formatted_size<Value>::value;
+
+    // Writes `count` values, each followed by `separator`
+    template<typename Value>
+    auto to_chars(char* first, char* last, Value const* values, std::size_t count, char separator = '\n') -> std::to_chars_result {
+        for (std::size_t i = 0; i < count; ++i) {
+            auto const result = to_chars(first, last, values[i]);
+            if (result.ec != std::errc{}) return result;
+            first = result.ptr;
+            if (first == last) return { last, std::errc::value_too_large };
+            *first++ = separator;
+        }
+        return { first, std::errc{} };
+    }
+
+    // Reads `count` values separated by whitespace
+    template<typename Value>
+    auto from_chars(char const* first, char const* last, Value* values, std::size_t count) -> std::from_chars_result {
+        for (std::size_t i = 0; i < count; ++i) {
+            while (first != last && (*first == ' ' || *first == '\n' || *first == '\r' || *first == '\t')) ++first;
+            auto const result = from_chars(first, last, values[i]);
+            if (result.ec != std::errc{}) return result;
+            first = result.ptr;
+        }
+        return { first, std::errc{} };
+    }
+
+    namespace detail {
+        // Shared by the {fmt} and std::format integrations, only the empty
+        // format spec is supported
+        template<typename Value>
+        struct CharsFormatter {
+            template<typename ParseContext>
+            constexpr auto parse(ParseContext& ctx) -> decltype(ctx.begin()) {
+                return ctx.begin();
+            }
+
+            template<typename FormatContext>
+            auto format(Value const& value, FormatContext& ctx) const -> decltype(ctx.out()) {
+                char buffer[formatted_size_v<Value>];
+                auto const result = gm::to_chars(buffer, buffer + sizeof(buffer), value);
+                auto out = ctx.out();
+                for (auto const* c = buffer; c != result.ptr; ++c) *out++ = *c;
+                return out;
+            }
+        };
+    }
+}
+
+#if defined(GRAPHICS_MATH_FMT)
+template<typename Type> struct fmt::formatter<gm::Vec3<Type>> : gm::detail::CharsFormatter<gm::Vec3<Type>> { };
+template<typename Type> struct fmt::formatter<gm::Normal3<Type>> : gm::detail::CharsFormatter<gm::Normal3<Type>> { };
+template<typename Type> struct fmt::formatter<gm::Point3<Type>> : gm::detail::CharsFormatter<gm::Point3<Type>> { };
+template<typename Type> struct fmt::formatter<gm::Color3<Type>> : gm::detail::CharsFormatter<gm::Color3<Type>> { };
+template<typename Type> struct fmt::formatter<gm::Matrix4x4<Type>> : gm::detail::CharsFormatter<gm::Matrix4x4<Type>> { };
+#endif
+
+#if defined(__cpp_lib_format)
+template<typename Type> struct std::formatter<gm::Vec3<Type>> : gm::detail::CharsFormatter<gm::Vec3<Type>> { };
+template<typename Type> struct std::formatter<gm::Normal3<Type>> : gm::detail::CharsFormatter<gm::Normal3<Type>> { };
+template<typename Type> struct std::formatter<gm::Point3<Type>> : gm::detail::CharsFormatter<gm::Point3<Type>> { };
+template<typename Type> struct std::formatter<gm::Color3<Type>> : gm::detail::CharsFormatter<gm::Color3<Type>> { };
+template<typename Type> struct std::formatter<gm::Matrix4x4<Type>> : gm::detail::CharsFormatter<gm::Matrix4x4<Type>> { };
+#endif
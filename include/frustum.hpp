@@ -0,0 +1,175 @@
+#pragma once
+
+#include "plane3.hpp"
+#include "matrix4x4.hpp"
+#include "point3.hpp"
+#include "util.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+namespace gm {
+
+    // Depth range of clip space produced by the projection the frustum is extracted from
+    enum class ClipDepth { zero_to_one, negative_one_to_one };
+
+    // Bounding spheres as structure-of-arrays
+    struct SphereBatch {
+        FLOAT const* x;
+        FLOAT const* y;
+        FLOAT const* z;
+        FLOAT const* radius;
+        std::size_t size;
+    };
+
+    // Axis-aligned bounding boxes as structure-of-arrays
+    struct BoxBatch {
+        FLOAT const* min_x;
+        FLOAT const* min_y;
+        FLOAT const* min_z;
+        FLOAT const* max_x;
+        FLOAT const* max_y;
+        FLOAT const* max_z;
+        std::size_t size;
+    };
+
+    // View frustum as six inward facing planes: left, right, bottom, top, near, far
+    class Frustum {
+    public:
+        constexpr explicit Frustum(std::array<Plane3f, 6> const& planes) : m_planes(planes) { }
+
+        // Gribb-Hartmann extraction from a (view-)projection matrix using the
+        // column vector convention of Transform, i.e. clip = m * p.
+        // For world space planes pass projection * view.
+        static auto constexpr from_matrix(Matrix4x4f const& m, ClipDepth depth = ClipDepth::zero_to_one) -> Frustum {
+            auto const row = [&m](FLOAT sign, int j) -> Plane3f {
+                return { m(3,0) + sign * m(j,0), m(3,1) + sign * m(j,1), m(3,2) + sign * m(j,2), m(3,3) + sign * m(j,3) };
+            };
+
+            auto near_plane = row(1, 2);
+            if (depth == ClipDepth::zero_to_one) {
+                near_plane = { m(2,0), m(2,1), m(2,2), m(2,3) };
+            }
+
+            // an infinite projection yields one plane with a zero normal and
+            // positive d, it stays degenerate after normalisation and accepts everything
+            return Frustum{{
+                row( 1, 0).normalise(),
+                row(-1, 0).normalise(),
+                row( 1, 1).normalise(),
+                row(-1, 1).normalise(),
+                near_plane.normalise(),
+                row(-1, 2).normalise()
+            }};
+        }
+
+        auto constexpr operator[](int i) const -> Plane3f const& { return m_planes[i]; }
+
+        auto constexpr contains(Point3f const& point) const -> bool {
+            for (auto const& plane : m_planes) {
+                if (plane.distance(point) < 0) return false;
+            }
+            return true;
+        }
+
+        // Conservative: may report spheres near the corners as visible
+        auto constexpr intersects(Point3f const& center, FLOAT radius) const -> bool {
+            for (auto const& plane : m_planes) {
+                if (plane.distance(center) < -radius) return false;
+            }
+            return true;
+        }
+
+        // Conservative: may report boxes near the corners as visible
+        auto constexpr intersects(Point3f const& min, Point3f const& max) const -> bool {
+            for (auto const& plane : m_planes) {
+                auto const& n = plane.normal;
+                auto const p = Point3f{ n.x > 0 ? max.x : min.x, n.y > 0 ? max.y : min.y, n.z > 0 ? max.z : min.z };
+                if (plane.distance(p) < 0) return false;
+            }
+            return true;
+        }
+
+        // Writes the indices of visible spheres to `visible`, which must hold
+        // spheres.size entries, and returns how many were written.
+        auto cull(SphereBatch const& spheres, std::uint32_t* visible) const -> std::size_t {
+            std::size_t count = 0;
+            std::uint32_t inside[block_size];
+
+            for (std::size_t base = 0; base < spheres.size; base += block_size) {
+                auto const n = std::min(block_size, spheres.size - base);
+                auto const* x = spheres.x + base;
+                auto const* y = spheres.y + base;
+                auto const* z = spheres.z + base;
+                auto const* r = spheres.radius + base;
+
+                std::fill_n(inside, n, 1u);
+                for (auto const& plane : m_planes) {
+                    auto const a = plane.normal.x, b = plane.normal.y, c = plane.normal.z, d = plane.d;
+                    for (std::size_t i = 0; i < n; ++i) {
+                        inside[i] &= static_cast<std::uint32_t>(a * x[i] + b * y[i] + c * z[i] + d + r[i] >= 0);
+                    }
+                }
+                count = compact(inside, n, base, visible, count);
+            }
+            return count;
+        }
+
+        // Writes the indices of visible boxes to `visible`, which must hold
+        // boxes.size entries, and returns how many were written.
+        auto cull(BoxBatch const& boxes, std::uint32_t* visible) const -> std::size_t {
+            std::size_t count = 0;
+            std::uint32_t inside[block_size];
+
+            for (std::size_t base = 0; base < boxes.size; base += block_size) {
+                auto const n = std::min(block_size, boxes.size - base);
+                auto const* min_x = boxes.min_x + base;
+                auto const* min_y = boxes.min_y + base;
+                auto const* min_z = boxes.min_z + base;
+                auto const* max_x = boxes.max_x + base;
+                auto const* max_y = boxes.max_y + base;
+                auto const* max_z = boxes.max_z + base;
+
+                std::fill_n(inside, n, 1u);
+                for (auto const& plane : m_planes) {
+                    auto const a = plane.normal.x, b = plane.normal.y, c = plane.normal.z, d = plane.d;
+                    auto const abs_a = gcem::abs(a), abs_b = gcem::abs(b), abs_c = gcem::abs(c);
+                    for (std::size_t i = 0; i < n; ++i) {
+                        // center/half-extent form of the positive vertex test
+                        auto const cx = max_x[i] + min_x[i], ex = max_x[i] - min_x[i];
+                        auto const cy = max_y[i] + min_y[i], ey = max_y[i] - min_y[i];
+                        auto const cz = max_z[i] + min_z[i], ez = max_z[i] - min_z[i];
+                        auto const dist = a * cx + b * cy + c * cz + abs_a * ex + abs_b * ey + abs_c * ez + 2 * d;
+                        inside[i] &= static_cast<std::uint32_t>(dist >= 0);
+                    }
+                }
+                count = compact(inside, n, base, visible, count);
+            }
+            return count;
+        }
+
+        template<typename Batch>
+        auto cull(Batch const& batch) const -> std::vector<std::uint32_t> {
+            auto visible = std::vector<std::uint32_t>(batch.size);
+            visible.resize(cull(batch, visible.data()));
+            return visible;
+        }
+
+    private:
+        static constexpr std::size_t block_size = 64;
+
+        // branchless stream compaction of one block
+        static auto compact(std::uint32_t const* inside, std::size_t n, std::size_t base,
+                            std::uint32_t* visible, std::size_t count) -> std::size_t {
+            for (std::size_t i = 0; i < n; ++i) {
+                visible[count] = static_cast<std::uint32_t>(base + i);
+                count += inside[i];
+            }
+            return count;
+        }
+
+        std::array<Plane3f, 6> m_planes;
+    };
+}
@@ -9,4 +9,27 @@
 #include "vec2.hpp"
 #include "onb.hpp"
 #include "transform.hpp"
-#include "color3.hpp"
\ No newline at end of file
+#include "color3.hpp"
+#include "plane3.hpp"
+#include "frustum.hpp"
+#include "sampling.hpp"
+#include "encoding.hpp"
+#include "spectrum.hpp"
+#include "film.hpp"
+#include "format.hpp"
+#include "grid.hpp"
+#include "parallel.hpp"
+#include "spatial-sort.hpp"
+#include "transform2d.hpp"
+#include "texcoord.hpp"
+#include "floating-point.hpp"
+#include "compare.hpp"
+#include "hash.hpp"
+#include "intern-cache.hpp"
+#include "mesh.hpp"
+#include "dual-quaternion.hpp"
+#include "interval.hpp"
+#include "polynomial.hpp"
+#include "dispatch.hpp"
+#include "lookup-tables.hpp"
+#include "texture.hpp"
\ No newline at end of file
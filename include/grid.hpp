@@ -0,0 +1,256 @@
+#pragma once
+
+#include "point2.hpp"
+#include "point3.hpp"
+#include "util.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+
+#if defined(__BMI2__)
+    #include <immintrin.h>
+#endif
+
+namespace gm {
+
+    // Rounds towards negative infinity, unlike the built-in division
+    auto constexpr floor_div(int a, int b) -> int {
+        auto const q = a / b;
+        return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+    }
+
+    // Result has the sign of b
+    auto constexpr floor_mod(int a, int b) -> int {
+        return a - floor_div(a, b) * b;
+    }
+
+    auto constexpr floor_div(Point2i const& p, int b) -> Point2i {
+        return { floor_div(p.x, b), floor_div(p.y, b) };
+    }
+
+    auto constexpr floor_div(Point3i const& p, int b) -> Point3i {
+        return { floor_div(p.x, b), floor_div(p.y, b), floor_div(p.z, b) };
+    }
+
+    auto constexpr floor_mod(Point2i const& p, int b) -> Point2i {
+        return { floor_mod(p.x, b), floor_mod(p.y, b) };
+    }
+
+    auto constexpr floor_mod(Point3i const& p, int b) -> Point3i {
+        return { floor_mod(p.x, b), floor_mod(p.y, b), floor_mod(p.z, b) };
+    }
+
+    // Floor, saturated to the int range; NaN maps to 0
+    inline auto floor_to_int(FLOAT x) -> int {
+        auto constexpr lo = static_cast<FLOAT>(std::numeric_limits<int>::min());
+        // the largest float below 2^31
+        auto constexpr hi = static_cast<FLOAT>(std::numeric_limits<int>::max() / 128 * 128);
+        auto const f = std::floor(x);
+        if (!(f == f)) return 0;
+        return static_cast<int>(std::clamp(f, lo, hi));
+    }
+
+    inline auto floor_to_int(Point3f const& p) -> Point3i {
+        return { floor_to_int(p.x), floor_to_int(p.y), floor_to_int(p.z) };
+    }
+
+    // Cell containing `p` in a grid of `resolution` unit cells at the origin,
+    // clamped so points on or outside the boundary map to the border cells
+    inline auto to_grid(Point3f const& p, Point3i const& resolution) -> Point3i {
+        return { std::clamp(floor_to_int(p.x), 0, resolution.x - 1),
+                 std::clamp(floor_to_int(p.y), 0, resolution.y - 1),
+                 std::clamp(floor_to_int(p.z), 0, resolution.z - 1) };
+    }
+
+    inline auto to_grid(Point2f const& p, Point2i const& resolution) -> Point2i {
+        return { std::clamp(floor_to_int(p.x), 0, resolution.x - 1),
+                 std::clamp(floor_to_int(p.y), 0, resolution.y - 1) };
+    }
+
+    namespace detail {
+        // Spreads the low 32 bits so bit i lands on bit 2i
+        auto constexpr part_1_by_1(std::uint64_t x) -> std::uint64_t {
+            x &= 0x00000000ffffffffull;
+            x = (x | (x << 16)) & 0x0000ffff0000ffffull;
+            x = (x | (x << 8)) & 0x00ff00ff00ff00ffull;
+            x = (x | (x << 4)) & 0x0f0f0f0f0f0f0f0full;
+            x = (x | (x << 2)) & 0x3333333333333333ull;
+            x = (x | (x << 1)) & 0x5555555555555555ull;
+            return x;
+        }
+
+        auto constexpr compact_1_by_1(std::uint64_t x) -> std::uint64_t {
+            x &= 0x5555555555555555ull;
+            x = (x | (x >> 1)) & 0x3333333333333333ull;
+            x = (x | (x >> 2)) & 0x0f0f0f0f0f0f0f0full;
+            x = (x | (x >> 4)) & 0x00ff00ff00ff00ffull;
+            x = (x | (x >> 8)) & 0x0000ffff0000ffffull;
+            x = (x | (x >> 16)) & 0x00000000ffffffffull;
+            return x;
+        }
+
+        // Spreads the low 21 bits so bit i lands on bit 3i
+        auto constexpr part_1_by_2(std::uint64_t x) -> std::uint64_t {
+            x &= 0x00000000001fffffull;
+            x = (x | (x << 32)) & 0x001f00000000ffffull;
+            x = (x | (x << 16)) & 0x001f0000ff0000ffull;
+            x = (x | (x << 8)) & 0x100f00f00f00f00full;
+            x = (x | (x << 4)) & 0x10c30c30c30c30c3ull;
+            x = (x | (x << 2)) & 0x1249249249249249ull;
+            return x;
+        }
+
+        auto constexpr compact_1_by_2(std::uint64_t x) -> std::uint64_t {
+            x &= 0x1249249249249249ull;
+            x = (x | (x >> 2)) & 0x10c30c30c30c30c3ull;
+            x = (x | (x >> 4)) & 0x100f00f00f00f00full;
+            x = (x | (x >> 8)) & 0x001f0000ff0000ffull;
+            x = (x | (x >> 16)) & 0x001f00000000ffffull;
+            x = (x | (x >> 32)) & 0x00000000001fffffull;
+            return x;
+        }
+
+        // Skilling, "Programming the Hilbert curve" (2004): converts axes to
+        // the transposed Hilbert index in place, and back
+        template<std::size_t Dims>
+        auto constexpr axes_to_transpose(std::uint32_t (&X)[Dims], int order) -> void {
+            auto const M = std::uint32_t(1) << (order - 1);
+            for (auto Q = M; Q > 1; Q >>= 1) {
+                auto const P = Q - 1;
+                for (std::size_t i = 0; i < Dims; ++i) {
+                    if (X[i] & Q) {
+                        X[0] ^= P;
+                    } else {
+                        auto const t = (X[0] ^ X[i]) & P;
+                        X[0] ^= t;
+                        X[i] ^= t;
+                    }
+                }
+            }
+            for (std::size_t i = 1; i < Dims; ++i) X[i] ^= X[i - 1];
+            std::uint32_t t = 0;
+            for (auto Q = M; Q > 1; Q >>= 1) {
+                if (X[Dims - 1] & Q) t ^= Q - 1;
+            }
+            for (std::size_t i = 0; i < Dims; ++i) X[i] ^= t;
+        }
+
+        template<std::size_t Dims>
+        auto constexpr transpose_to_axes(std::uint32_t (&X)[Dims], int order) -> void {
+            auto const N = std::uint64_t(2) << (order - 1);
+            auto t = X[Dims - 1] >> 1;
+            for (std::size_t i = Dims - 1; i > 0; --i) X[i] ^= X[i - 1];
+            X[0] ^= t;
+            for (std::uint64_t Q = 2; Q != N; Q <<= 1) {
+                auto const P = static_cast<std::uint32_t>(Q - 1);
+                for (std::size_t i = Dims; i-- > 0;) {
+                    if (X[i] & Q) {
+                        X[0] ^= P;
+                    } else {
+                        t = (X[0] ^ X[i]) & P;
+                        X[0] ^= t;
+                        X[i] ^= t;
+                    }
+                }
+            }
+        }
+    }
+
+    // Morton (Z-order) codes interleave the coordinate bits, x in the lowest
+    // bit. 2D codes take 32 bits per axis, 3D codes 21 bits per axis;
+    // coordinates must be non-negative. With BMI2 the (de)interleave is a
+    // single pdep/pext, which is microcoded and slow on AMD before Zen 3.
+    inline auto morton_encode(Point2i const& p) -> std::uint64_t {
+#if defined(__BMI2__)
+        return _pdep_u64(static_cast<std::uint32_t>(p.x), 0x5555555555555555ull)
+             | _pdep_u64(static_cast<std::uint32_t>(p.y), 0xaaaaaaaaaaaaaaaaull);
+#else
+        return detail::part_1_by_1(static_cast<std::uint32_t>(p.x))
+             | detail::part_1_by_1(static_cast<std::uint32_t>(p.y)) << 1;
+#endif
+    }
+
+    inline auto morton_encode(Point3i const& p) -> std::uint64_t {
+#if defined(__BMI2__)
+        return _pdep_u64(static_cast<std::uint32_t>(p.x), 0x1249249249249249ull)
+             | _pdep_u64(static_cast<std::uint32_t>(p.y), 0x2492492492492492ull)
+             | _pdep_u64(static_cast<std::uint32_t>(p.z), 0x4924924924924924ull);
+#else
+        return detail::part_1_by_2(static_cast<std::uint32_t>(p.x))
+             | detail::part_1_by_2(static_cast<std::uint32_t>(p.y)) << 1
+             | detail::part_1_by_2(static_cast<std::uint32_t>(p.z)) << 2;
+#endif
+    }
+
+    inline auto morton_decode_2d(std::uint64_t code) -> Point2i {
+#if defined(__BMI2__)
+        return { static_cast<int>(_pext_u64(code, 0x5555555555555555ull)),
+                 static_cast<int>(_pext_u64(code, 0xaaaaaaaaaaaaaaaaull)) };
+#else
+        return { static_cast<int>(detail::compact_1_by_1(code)),
+                 static_cast<int>(detail::compact_1_by_1(code >> 1)) };
+#endif
+    }
+
+    inline auto morton_decode_3d(std::uint64_t code) -> Point3i {
+#if defined(__BMI2__)
+        return { static_cast<int>(_pext_u64(code, 0x1249249249249249ull)),
+                 static_cast<int>(_pext_u64(code, 0x2492492492492492ull)),
+                 static_cast<int>(_pext_u64(code, 0x4924924924924924ull)) };
+#else
+        return { static_cast<int>(detail::compact_1_by_2(code)),
+                 static_cast<int>(detail::compact_1_by_2(code >> 1)),
+                 static_cast<int>(detail::compact_1_by_2(code >> 2)) };
+#endif
+    }
+
+    inline auto morton_encode(Point3i const* points, std::uint64_t* codes, std::size_t count) -> void {
+        for (std::size_t i = 0; i < count; ++i) codes[i] = morton_encode(points[i]);
+    }
+
+    inline auto morton_decode_3d(std::uint64_t const* codes, Point3i* points, std::size_t count) -> void {
+        for (std::size_t i = 0; i < count; ++i) points[i] = morton_decode_3d(codes[i]);
+    }
+
+    // Hilbert curve index of a point in a 2^order grid per axis (order <= 31
+    // in 2D, <= 21 in 3D). Neighbouring indices are always adjacent cells,
+    // so it is more cache coherent than Morton order at a higher cost.
+    inline auto hilbert_encode(Point2i const& p, int order) -> std::uint64_t {
+        assert(order > 0 && order <= 31);
+        std::uint32_t X[2] = { static_cast<std::uint32_t>(p.x), static_cast<std::uint32_t>(p.y) };
+        detail::axes_to_transpose(X, order);
+        // the transposed index interleaves with the first axis most significant
+        return morton_encode(Point2i{ static_cast<int>(X[1]), static_cast<int>(X[0]) });
+    }
+
+    inline auto hilbert_encode(Point3i const& p, int order) -> std::uint64_t {
+        assert(order > 0 && order <= 21);
+        std::uint32_t X[3] = { static_cast<std::uint32_t>(p.x), static_cast<std::uint32_t>(p.y), static_cast<std::uint32_t>(p.z) };
+        detail::axes_to_transpose(X, order);
+        return morton_encode(Point3i{ static_cast<int>(X[2]), static_cast<int>(X[1]), static_cast<int>(X[0]) });
+    }
+
+    inline auto hilbert_decode_2d(std::uint64_t index, int order) -> Point2i {
+        assert(order > 0 && order <= 31);
+        auto const t = morton_decode_2d(index);
+        std::uint32_t X[2] = { static_cast<std::uint32_t>(t.y), static_cast<std::uint32_t>(t.x) };
+        detail::transpose_to_axes(X, order);
+        return { static_cast<int>(X[0]), static_cast<int>(X[1]) };
+    }
+
+    inline auto hilbert_decode_3d(std::uint64_t index, int order) -> Point3i {
+        assert(order > 0 && order <= 21);
+        auto const t = morton_decode_3d(index);
+        std::uint32_t X[3] = { static_cast<std::uint32_t>(t.z), static_cast<std::uint32_t>(t.y), static_cast<std::uint32_t>(t.x) };
+        detail::transpose_to_axes(X, order);
+        return { static_cast<int>(X[0]), static_cast<int>(X[1]), static_cast<int>(X[2]) };
+    }
+
+    inline auto hilbert_encode(Point3i const* points, std::uint64_t* indices, std::size_t count, int order) -> void {
+        for (std::size_t i = 0; i < count; ++i) indices[i] = hilbert_encode(points[i], order);
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "vec2.hpp"
+#include "vec3.hpp"
+#include "point2.hpp"
+#include "point3.hpp"
+#include "normal3.hpp"
+#include "color3.hpp"
+#include "matrix4x4.hpp"
+#include "transform.hpp"
+#include "transform2d.hpp"
+#include "compare.hpp"
+#include "util.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Hashing consistent with exact equality, for std::unordered_map and friends:
+//
+//     std::unordered_map<Matrix4x4f, int, Hash, ExactEqual> map;
+//
+// std::hash is deliberately not specialized: operator== on the floating point
+// types compares with a tolerance, which no hash can agree with.
+namespace gm {
+
+    namespace detail {
+        // splitmix64 finalizer
+        auto constexpr mix(std::uint64_t h) -> std::uint64_t {
+            h ^= h >> 30;
+            h *= 0xbf58476d1ce4e5b9ull;
+            h ^= h >> 27;
+            h *= 0x94d049bb133111ebull;
+            h ^= h >> 31;
+            return h;
+        }
+
+        template<typename T>
+        auto component_bits(T value) -> std::uint64_t {
+            if constexpr (std::is_floating_point_v<T>) {
+                // -0 == +0, so both must hash alike
+                value = value == 0 ? T(0) : value;
+                using Bits = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+                Bits bits;
+                std::memcpy(&bits, &value, sizeof(value));
+                return bits;
+            } else {
+                return static_cast<std::uint64_t>(value);
+            }
+        }
+
+        template<typename... Components>
+        auto hash_components(Components... components) -> std::size_t {
+            std::uint64_t h = 0;
+            ((h = mix(h + 0x9e3779b97f4a7c15ull + component_bits(components))), ...);
+            return static_cast<std::size_t>(h);
+        }
+    }
+
+    struct Hash {
+        template<typename Type>
+        auto operator()(Vec2<Type> const& v) const -> std::size_t { return detail::hash_components(v.x, v.y); }
+
+        template<typename Type>
+        auto operator()(Vec3<Type> const& v) const -> std::size_t { return detail::hash_components(v.x, v.y, v.z); }
+
+        template<typename Type>
+        auto operator()(Point2<Type> const& p) const -> std::size_t { return detail::hash_components(p.x, p.y); }
+
+        template<typename Type>
+        auto operator()(Point3<Type> const& p) const -> std::size_t { return detail::hash_components(p.x, p.y, p.z); }
+
+        template<typename Type>
+        auto operator()(Normal3<Type> const& n) const -> std::size_t { return detail::hash_components(n.x(), n.y(), n.z()); }
+
+        template<typename Type>
+        auto operator()(Color3<Type> const& c) const -> std::size_t { return detail::hash_components(c.r, c.g, c.b); }
+
+        template<typename Type>
+        auto operator()(Matrix4x4<Type> const& m) const -> std::size_t {
+            std::uint64_t h = 0;
+            for (int i = 0; i < 4; ++i) {
+                h = detail::mix(h + 0x9e3779b97f4a7c15ull + detail::hash_components(m(i, 0), m(i, 1), m(i, 2), m(i, 3)));
+            }
+            return static_cast<std::size_t>(h);
+        }
+
+        // The inverse follows from the matrix and is not hashed
+        auto operator()(Transform const& t) const -> std::size_t { return (*this)(t.matrix()); }
+
+        auto operator()(Transform2D const& t) const -> std::size_t { return detail::hash_components(t.a, t.b, t.tx, t.c, t.d, t.ty); }
+    };
+
+    struct ExactEqual {
+        template<typename T>
+        auto operator()(T const& a, T const& b) const -> bool { return approx_equal(a, b, Exact{}); }
+
+        auto operator()(Transform const& a, Transform const& b) const -> bool {
+            return approx_equal(a.matrix(), b.matrix(), Exact{}) & approx_equal(a.inverse(), b.inverse(), Exact{});
+        }
+    };
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+// Opt-in call and numeric-event counters for hot paths. Define
+// GRAPHICS_MATH_INSTRUMENT (or configure with GRAPHICS_MATH_INSTRUMENTATION=ON)
+// in every translation unit to enable them; otherwise the hooks expand to
+// nothing and this header includes no other headers.
+//
+// Each thread counts into its own block with plain relaxed stores, report()
+// sums all blocks without locking. Blocks are recycled when threads exit, so
+// counts from finished threads are kept.
+
+#if defined(GRAPHICS_MATH_INSTRUMENT)
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#if defined(__GNUC__) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+    #define GM_INSTRUMENT_ACTIVE() (!__builtin_is_constant_evaluated())
+#else
+    // without the builtin the hooks would break constant evaluation
+    #define GM_INSTRUMENT_ACTIVE() false
+#endif
+
+#define GM_INSTRUMENT_COUNT(counter) \
+    do { if (GM_INSTRUMENT_ACTIVE()) ::gm::instrumentation::count(::gm::instrumentation::Counter::counter); } while (0)
+#define GM_INSTRUMENT_COUNT_N(counter, n) \
+    do { if (GM_INSTRUMENT_ACTIVE()) ::gm::instrumentation::count(::gm::instrumentation::Counter::counter, n); } while (0)
+#define GM_INSTRUMENT_COUNT_IF(condition, counter) \
+    do { if (GM_INSTRUMENT_ACTIVE() && (condition)) ::gm::instrumentation::count(::gm::instrumentation::Counter::counter); } while (0)
+#define GM_INSTRUMENT_CHECK(...) \
+    do { if (GM_INSTRUMENT_ACTIVE()) ::gm::instrumentation::check(__VA_ARGS__); } while (0)
+
+namespace gm::instrumentation {
+
+    enum class Counter : std::size_t {
+        transform_apply,
+        matrix_multiply,
+        normalise,
+        solve_quadratic,
+        nan,
+        infinity,
+        denormal,
+        zero_length_normalise,
+        singular_scale,
+        degenerate_quadratic,
+        count
+    };
+
+    inline constexpr std::size_t counter_count = static_cast<std::size_t>(Counter::count);
+
+    inline constexpr char const* counter_names[counter_count] = {
+        "transform_apply",
+        "matrix_multiply",
+        "normalise",
+        "solve_quadratic",
+        "nan",
+        "infinity",
+        "denormal",
+        "zero_length_normalise",
+        "singular_scale",
+        "degenerate_quadratic"
+    };
+
+    namespace detail {
+        struct ThreadCounters {
+            std::array<std::atomic<std::uint64_t>, counter_count> counts{};
+            std::atomic<bool> in_use{ true };
+            ThreadCounters* next = nullptr;
+        };
+
+        // Push-only list, blocks live until the end of the program
+        inline std::atomic<ThreadCounters*> registry{ nullptr };
+
+        inline auto acquire() -> ThreadCounters* {
+            for (auto* block = registry.load(std::memory_order_acquire); block != nullptr; block = block->next) {
+                auto expected = false;
+                if (block->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) return block;
+            }
+            auto* block = new ThreadCounters;
+            block->next = registry.load(std::memory_order_relaxed);
+            while (!registry.compare_exchange_weak(block->next, block, std::memory_order_release, std::memory_order_relaxed)) { }
+            return block;
+        }
+
+        struct ThreadSlot {
+            ThreadCounters* counters = acquire();
+            ~ThreadSlot() { counters->in_use.store(false, std::memory_order_release); }
+        };
+
+        inline auto local() -> ThreadCounters& {
+            thread_local ThreadSlot slot;
+            return *slot.counters;
+        }
+    }
+
+    inline auto count(Counter counter, std::uint64_t n = 1) -> void {
+        // only the owning thread writes, so no read-modify-write is needed
+        auto& value = detail::local().counts[static_cast<std::size_t>(counter)];
+        value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    // Records NaN, infinite and denormal values
+    template<typename... Values>
+    auto check(Values... values) -> void {
+        auto const classify = [](auto value) {
+            switch (std::fpclassify(value)) {
+            case FP_NAN: count(Counter::nan); break;
+            case FP_INFINITE: count(Counter::infinity); break;
+            case FP_SUBNORMAL: count(Counter::denormal); break;
+            default: break;
+            }
+        };
+        (classify(values), ...);
+    }
+
+    struct Report {
+        std::array<std::uint64_t, counter_count> counts{};
+
+        auto operator[](Counter counter) const -> std::uint64_t {
+            return counts[static_cast<std::size_t>(counter)];
+        }
+
+        auto friend operator<<(std::ostream& os, Report const& report) -> std::ostream& {
+            for (std::size_t i = 0; i < counter_count; ++i) {
+                os << counter_names[i] << ": " << report.counts[i] << '\n';
+            }
+            return os;
+        }
+    };
+
+    // Totals over all threads that have counted so far
+    inline auto report() -> Report {
+        Report result;
+        for (auto* block = detail::registry.load(std::memory_order_acquire); block != nullptr; block = block->next) {
+            for (std::size_t i = 0; i < counter_count; ++i) {
+                result.counts[i] += block->counts[i].load(std::memory_order_relaxed);
+            }
+        }
+        return result;
+    }
+
+    // Counts made concurrently with a reset may survive it
+    inline auto reset() -> void {
+        for (auto* block = detail::registry.load(std::memory_order_acquire); block != nullptr; block = block->next) {
+            for (auto& value : block->counts) value.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+#else
+
+#define GM_INSTRUMENT_COUNT(counter) ((void)0)
+#define GM_INSTRUMENT_COUNT_N(counter, n) ((void)0)
+#define GM_INSTRUMENT_COUNT_IF(condition, counter) ((void)0)
+#define GM_INSTRUMENT_CHECK(...) ((void)0)
+
+#endif
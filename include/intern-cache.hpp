@@ -0,0 +1,190 @@
+#pragma once
+
+#include "matrix4x4.hpp"
+#include "transform.hpp"
+#include "hash.hpp"
+#include "util.hpp"
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <unordered_map>
+
+namespace gm {
+
+    namespace detail {
+        inline auto snap(FLOAT x, FLOAT quantum) -> FLOAT {
+            auto const snapped = std::round(x / quantum) * quantum;
+            // keep -0 from splitting a key
+            return snapped == 0 ? FLOAT(0) : snapped;
+        }
+
+        inline auto snap(Matrix4x4f m, FLOAT quantum) -> Matrix4x4f {
+            for (int i = 0; i < 4; ++i) {
+                for (int j = 0; j < 4; ++j) m(i, j) = snap(m(i, j), quantum);
+            }
+            return m;
+        }
+
+        inline auto snap(Transform const& t, FLOAT quantum) -> Transform {
+            return { snap(t.matrix(), quantum), snap(t.inverse(), quantum) };
+        }
+    }
+
+    // Deduplicates values and hands out dense 32-bit handles, so that e.g.
+    // scene instances can store a handle instead of a 128 byte Transform.
+    //
+    // Values are compared exactly after optionally snapping every entry to a
+    // multiple of `quantum`; snapping makes values that differ by rounding
+    // noise share a handle while keeping hashing and equality consistent.
+    // The canonical (snapped) value is what is stored and returned.
+    //
+    // intern() and find() may be called concurrently; the key space is split
+    // into shards with one lock each. Stored values never move, so
+    // operator[] is lock-free and references stay valid for the lifetime of
+    // the cache.
+    template<typename Type>
+    class InternCache {
+    public:
+        using Handle = std::uint32_t;
+
+        struct Stats {
+            std::uint64_t lookups = 0;
+            std::uint64_t hits = 0;
+            std::size_t unique = 0;
+
+            auto hit_rate() const -> double {
+                return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);
+            }
+        };
+
+        explicit InternCache(FLOAT quantum = 0) : m_quantum(quantum) { }
+
+        InternCache(InternCache const&) = delete;
+        auto operator=(InternCache const&) -> InternCache& = delete;
+
+        ~InternCache() {
+            auto const count = m_size.load(std::memory_order_acquire);
+            for (std::size_t block = 0; block < block_count; ++block) {
+                auto* values = m_blocks[block].load(std::memory_order_acquire);
+                if (values == nullptr) continue;
+                auto const first = block_first(block);
+                for (std::size_t i = 0; i < block_size(block) && first + i < count; ++i) values[i].~Type();
+                ::operator delete(values, std::align_val_t{ alignof(Type) });
+            }
+        }
+
+        auto intern(Type const& value) -> Handle {
+            auto const key = canonical(value);
+            auto const hash = Hash{}(key);
+            auto& shard = m_shards[hash % shard_count];
+            m_lookups.fetch_add(1, std::memory_order_relaxed);
+
+            std::lock_guard lock(shard.mutex);
+            if (auto const found = find_locked(shard, hash, key)) {
+                m_hits.fetch_add(1, std::memory_order_relaxed);
+                return *found;
+            }
+            auto const handle = m_next.fetch_add(1, std::memory_order_relaxed);
+            assert(handle != invalid_handle);
+            new (slot(handle)) Type(key);
+            shard.handles.emplace(hash, handle);
+            m_size.fetch_add(1, std::memory_order_release);
+            return handle;
+        }
+
+        auto find(Type const& value) const -> std::optional<Handle> {
+            auto const key = canonical(value);
+            auto const hash = Hash{}(key);
+            auto& shard = m_shards[hash % shard_count];
+            std::lock_guard lock(shard.mutex);
+            return find_locked(shard, hash, key);
+        }
+
+        // `handle` must come from intern() on this cache
+        auto operator[](Handle handle) const -> Type const& {
+            auto const [block, offset] = locate(handle);
+            return m_blocks[block].load(std::memory_order_acquire)[offset];
+        }
+
+        auto size() const -> std::size_t { return m_size.load(std::memory_order_acquire); }
+
+        auto stats() const -> Stats {
+            return { m_lookups.load(std::memory_order_relaxed), m_hits.load(std::memory_order_relaxed), size() };
+        }
+
+        static constexpr Handle invalid_handle = ~Handle(0);
+
+    private:
+        // Block b holds 2^(b + first_block_bits) values, so 32 - first_block_bits
+        // + 1 blocks cover every handle without ever moving a value
+        static constexpr std::size_t first_block_bits = 10;
+        static constexpr std::size_t block_count = 32 - first_block_bits + 1;
+        static constexpr std::size_t shard_count = 64;
+
+        struct alignas(64) Shard {
+            std::mutex mutex;
+            std::unordered_multimap<std::size_t, Handle> handles;
+        };
+
+        static auto constexpr block_first(std::size_t block) -> std::size_t {
+            return block == 0 ? 0 : std::size_t(1) << (block + first_block_bits - 1);
+        }
+
+        static auto constexpr block_size(std::size_t block) -> std::size_t {
+            return block == 0 ? std::size_t(1) << first_block_bits : block_first(block);
+        }
+
+        static auto locate(Handle handle) -> std::pair<std::size_t, std::size_t> {
+            auto const index = static_cast<std::uint64_t>(handle) >> first_block_bits;
+            if (index == 0) return { 0, handle };
+            std::size_t block = 0;
+            for (auto i = index; i != 0; i >>= 1) ++block;
+            return { block, handle - block_first(block) };
+        }
+
+        auto canonical(Type const& value) const -> Type {
+            return m_quantum > 0 ? detail::snap(value, m_quantum) : value;
+        }
+
+        auto find_locked(Shard& shard, std::size_t hash, Type const& key) const -> std::optional<Handle> {
+            auto const [first, last] = shard.handles.equal_range(hash);
+            for (auto it = first; it != last; ++it) {
+                if (ExactEqual{}((*this)[it->second], key)) return it->second;
+            }
+            return std::nullopt;
+        }
+
+        auto slot(Handle handle) -> Type* {
+            auto const [block, offset] = locate(handle);
+            auto* values = m_blocks[block].load(std::memory_order_acquire);
+            if (values == nullptr) {
+                auto* fresh = static_cast<Type*>(::operator new(block_size(block) * sizeof(Type), std::align_val_t{ alignof(Type) }));
+                if (m_blocks[block].compare_exchange_strong(values, fresh, std::memory_order_acq_rel)) {
+                    values = fresh;
+                } else {
+                    ::operator delete(fresh, std::align_val_t{ alignof(Type) });
+                }
+            }
+            return values + offset;
+        }
+
+        FLOAT m_quantum;
+        std::array<std::atomic<Type*>, block_count> m_blocks{};
+        mutable std::array<Shard, shard_count> m_shards;
+        std::atomic<Handle> m_next{ 0 };
+        std::atomic<std::size_t> m_size{ 0 };
+        std::atomic<std::uint64_t> m_lookups{ 0 };
+        std::atomic<std::uint64_t> m_hits{ 0 };
+    };
+
+    typedef InternCache<Transform> TransformCache;
+    typedef InternCache<Matrix4x4f> MatrixCache;
+}
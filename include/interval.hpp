@@ -0,0 +1,138 @@
+#pragma once
+
+#include "point3.hpp"
+#include "vec3.hpp"
+#include "util.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <type_traits>
+
+namespace gm {
+
+    namespace detail {
+        // Adjacent representable values, bit stepping rather than
+        // std::nextafter so batched interval arithmetic can vectorize
+        template<typename T>
+        auto next_up(T x) -> T {
+            if constexpr (std::is_floating_point_v<T>) {
+                using Bits = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+                if (x == std::numeric_limits<T>::infinity() || x != x) return x;
+                x = x == 0 ? T(0) : x;
+                Bits bits;
+                std::memcpy(&bits, &x, sizeof(x));
+                bits = x >= 0 ? bits + 1 : bits - 1;
+                std::memcpy(&x, &bits, sizeof(x));
+            }
+            return x;
+        }
+
+        template<typename T>
+        auto next_down(T x) -> T {
+            if constexpr (std::is_floating_point_v<T>) {
+                using Bits = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+                if (x == -std::numeric_limits<T>::infinity() || x != x) return x;
+                x = x == 0 ? T(-0.0) : x;
+                Bits bits;
+                std::memcpy(&bits, &x, sizeof(x));
+                bits = x > 0 ? bits - 1 : bits + 1;
+                std::memcpy(&x, &bits, sizeof(x));
+            }
+            return x;
+        }
+    }
+
+    // Closed interval [low, high] guaranteed to contain the exact result of
+    // every operation: floating point results are rounded to nearest and then
+    // widened by one ulp in each direction. The bounds are stored next to each
+    // other so arrays of intervals load as pairs.
+    template<typename Type>
+    class Interval {
+    public:
+        Type low, high;
+
+        constexpr Interval() : low(0), high(0) { }
+        constexpr Interval(Type value) : low(value), high(value) { }
+        constexpr Interval(Type low, Type high) : low(std::min(low, high)), high(std::max(low, high)) { }
+
+        auto constexpr midpoint() const -> Type { return (low + high) / 2; }
+        auto constexpr width() const -> Type { return high - low; }
+        auto constexpr contains(Type value) const -> bool { return low <= value && value <= high; }
+        auto constexpr is_point() const -> bool { return low == high; }
+
+        // Exact comparison of the bounds
+        auto constexpr operator==(Interval const& other) const -> bool { return low == other.low && high == other.high; }
+        auto constexpr operator!=(Interval const& other) const -> bool { return !(*this == other); }
+
+        auto constexpr operator-() const -> Interval { return from_bounds(-high, -low); }
+
+        auto friend operator+(Interval const& a, Interval const& b) -> Interval {
+            return from_bounds(detail::next_down(a.low + b.low), detail::next_up(a.high + b.high));
+        }
+
+        auto friend operator-(Interval const& a, Interval const& b) -> Interval {
+            return from_bounds(detail::next_down(a.low - b.high), detail::next_up(a.high - b.low));
+        }
+
+        auto friend operator*(Interval const& a, Interval const& b) -> Interval {
+            auto const p0 = a.low * b.low, p1 = a.low * b.high, p2 = a.high * b.low, p3 = a.high * b.high;
+            return from_bounds(detail::next_down(std::min({ p0, p1, p2, p3 })), detail::next_up(std::max({ p0, p1, p2, p3 })));
+        }
+
+        // Division by an interval containing zero gives the whole line
+        auto friend operator/(Interval const& a, Interval const& b) -> Interval {
+            if (b.contains(0)) return from_bounds(-std::numeric_limits<Type>::infinity(), std::numeric_limits<Type>::infinity());
+            auto const q0 = a.low / b.low, q1 = a.low / b.high, q2 = a.high / b.low, q3 = a.high / b.high;
+            return from_bounds(detail::next_down(std::min({ q0, q1, q2, q3 })), detail::next_up(std::max({ q0, q1, q2, q3 })));
+        }
+
+        auto operator+=(Interval const& other) -> Interval& { return *this = *this + other; }
+        auto operator-=(Interval const& other) -> Interval& { return *this = *this - other; }
+        auto operator*=(Interval const& other) -> Interval& { return *this = *this * other; }
+        auto operator/=(Interval const& other) -> Interval& { return *this = *this / other; }
+
+        auto friend operator<<(std::ostream& os, Interval const& i) -> std::ostream& {
+            os << '[' << i.low << ',' << i.high << ']';
+            return os;
+        }
+
+    private:
+        // skips the ordering in the public constructor
+        static auto constexpr from_bounds(Type low, Type high) -> Interval {
+            Interval result;
+            result.low = low;
+            result.high = high;
+            return result;
+        }
+    };
+
+    // Smallest interval containing both
+    template<typename Type>
+    auto constexpr hull(Interval<Type> const& a, Interval<Type> const& b) -> Interval<Type> {
+        return { std::min(a.low, b.low), std::max(a.high, b.high) };
+    }
+
+    template<typename>
+    struct is_interval : std::false_type { };
+
+    template<typename Type>
+    struct is_interval<Interval<Type>> : std::true_type { };
+
+    template<typename Type>
+    inline constexpr bool is_interval_v = is_interval<Type>::value;
+
+    typedef Interval<FLOAT> Intervalf;
+    typedef Vec3<Intervalf> Vec3fi;
+    typedef Point3<Intervalf> Point3fi;
+
+    // The box [lower, upper] as an interval point
+    inline auto constexpr to_interval(Point3f const& lower, Point3f const& upper) -> Point3fi {
+        return { Intervalf{ lower.x, upper.x }, Intervalf{ lower.y, upper.y }, Intervalf{ lower.z, upper.z } };
+    }
+
+    inline auto constexpr lower(Point3fi const& p) -> Point3f { return { p.x.low, p.y.low, p.z.low }; }
+    inline auto constexpr upper(Point3fi const& p) -> Point3f { return { p.x.high, p.y.high, p.z.high }; }
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "util.hpp"
+
+#include <gcem.hpp>
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace gm {
+
+    // sRGB transfer functions (IEC 61966-2-1) on [0, 1]
+    template<typename T>
+    auto constexpr linear_to_srgb(T linear) -> T {
+        return linear <= T(0.0031308) ? T(12.92) * linear : T(1.055) * static_cast<T>(gcem::pow(linear, T(1) / T(2.4))) - T(0.055);
+    }
+
+    template<typename T>
+    auto constexpr srgb_to_linear(T encoded) -> T {
+        return encoded <= T(0.04045) ? encoded / T(12.92) : static_cast<T>(gcem::pow((encoded + T(0.055)) / T(1.055), T(2.4)));
+    }
+
+    namespace detail {
+        template<unsigned Bits>
+        inline constexpr std::uint32_t max_code = (std::uint32_t(1) << Bits) - 1;
+    }
+
+    // Policies converting between linear values and Bits-bit sRGB codes, as
+    // used by Color3::encode_srgb and Color3::decode_srgb. SrgbEncoder and
+    // SrgbDecoder evaluate the transfer function with gcem in double
+    // precision; the tables below trade a little accuracy for speed.
+    template<unsigned Bits>
+    struct SrgbEncoder {
+        static_assert(Bits >= 1 && Bits <= 16);
+
+        // Clamps to [0, 1], NaN encodes as 0
+        auto constexpr operator()(FLOAT linear) const -> std::uint16_t {
+            auto const x = linear > 0 ? (linear < 1 ? static_cast<double>(linear) : 1.0) : 0.0;
+            return static_cast<std::uint16_t>(linear_to_srgb(x) * detail::max_code<Bits> + 0.5);
+        }
+    };
+
+    template<unsigned Bits>
+    struct SrgbDecoder {
+        static_assert(Bits >= 1 && Bits <= 16);
+
+        auto constexpr operator()(std::uint16_t code) const -> FLOAT {
+            return static_cast<FLOAT>(srgb_to_linear(static_cast<double>(code) / detail::max_code<Bits>));
+        }
+    };
+
+    // Every decoded value, generated at compile time: identical to
+    // SrgbDecoder. 1 KiB for 8 bits, 16 KiB for 12 and 256 KiB for 16.
+    template<unsigned Bits>
+    class SrgbDecodeTable {
+    public:
+        auto constexpr operator()(std::uint16_t code) const -> FLOAT {
+            assert(code <= detail::max_code<Bits>);
+            return table[code];
+        }
+
+    private:
+        static constexpr auto table = [] {
+            std::array<FLOAT, std::size_t(1) << Bits> t{};
+            for (std::size_t i = 0; i < t.size(); ++i) t[i] = SrgbDecoder<Bits>{}(static_cast<std::uint16_t>(i));
+            return t;
+        }();
+    };
+
+    // Piecewise linear interpolation of the encoding curve, with 2^(Bits / 2)
+    // segments per octave between 2^-9 and 1, indexed by the exponent and top
+    // mantissa bits of the input. Inputs on the linear part of the curve are
+    // encoded directly. Never more than one code from SrgbEncoder, and equal
+    // to it for all but a few percent of inputs (see the tests).
+    template<unsigned Bits>
+    class SrgbEncodeTable {
+        static_assert(Bits >= 1 && Bits <= 16);
+        static constexpr unsigned segment_bits = Bits / 2;
+        static constexpr unsigned fraction_bits = 23 - segment_bits;
+        static constexpr int octaves = 9;
+
+    public:
+        auto operator()(FLOAT linear) const -> std::uint16_t {
+            auto const x = static_cast<float>(linear);
+            if (!(x > 0.0031308f)) return x > 0 ? static_cast<std::uint16_t>(x * (12.92f * detail::max_code<Bits>) + 0.5f) : 0;
+            if (x >= 1) return static_cast<std::uint16_t>(detail::max_code<Bits>);
+
+            std::uint32_t bits;
+            std::memcpy(&bits, &x, sizeof(x));
+            // x is in [2^-9, 1), so the biased exponent is at least 127 - 9
+            auto const offset = bits - (std::uint32_t(127 - octaves) << 23);
+            auto const index = offset >> fraction_bits;
+            auto const fraction = static_cast<float>(offset & ((std::uint32_t(1) << fraction_bits) - 1)) * (1.0f / (std::uint32_t(1) << fraction_bits));
+            auto const value = table[index] + fraction * (table[index + 1] - table[index]);
+            return static_cast<std::uint16_t>(value + 0.5f);
+        }
+
+    private:
+        // the power part of the curve at every segment start, in codes, also
+        // below the linear threshold so the first segments interpolate it
+        static constexpr auto table = [] {
+            std::array<float, (octaves << segment_bits) + 1> t{};
+            for (std::size_t i = 0; i < t.size(); ++i) {
+                auto const octave = static_cast<int>(i >> segment_bits);
+                auto const mantissa = 1 + static_cast<double>(i & ((std::size_t(1) << segment_bits) - 1)) / (std::size_t(1) << segment_bits);
+                auto const x = mantissa / static_cast<double>(std::uint32_t(1) << (octaves - octave));
+                t[i] = static_cast<float>((1.055 * gcem::pow(x, 1 / 2.4) - 0.055) * detail::max_code<Bits>);
+            }
+            return t;
+        }();
+    };
+
+    struct SinCos {
+        FLOAT sin, cos;
+    };
+
+    // Policies giving the sine and cosine of an angle in degrees, as used by
+    // the rotate functions of Transform and Transform2D
+    struct ExactSinCos {
+        auto constexpr operator()(FLOAT degrees) const -> SinCos {
+            auto const rad = degree_to_radian(degrees);
+            return { gcem::sin(rad), gcem::cos(rad) };
+        }
+    };
+
+    // Size samples per turn, generated at compile time. The nearest sample
+    // is rotated by the remaining offset with the angle sum identities and
+    // a third order expansion of the offset's sine and cosine, so multiples
+    // of 360 / Size degrees (fixed step animation) are exact and other
+    // angles are within a few ulps.
+    template<std::size_t Size = 256>
+    class SinCosTable {
+        static_assert(Size >= 8 && (Size & (Size - 1)) == 0);
+
+    public:
+        auto constexpr operator()(FLOAT degrees) const -> SinCos {
+            auto const t = degrees * (static_cast<FLOAT>(Size) / 360);
+            // rounds to nearest without a branch on the sign
+            auto const truncated = static_cast<std::int64_t>(t);
+            auto const remainder = t - static_cast<FLOAT>(truncated);
+            auto const nearest = truncated + (remainder >= FLOAT(0.5)) - (remainder <= FLOAT(-0.5));
+            auto const d = (t - static_cast<FLOAT>(nearest)) * (2 * constants::pi / Size);
+            auto const& sample = table[static_cast<std::size_t>(nearest) & (Size - 1)];
+            auto const half_d2 = d * d / 2;
+            auto const sin_d = d - d * half_d2 / 3;
+            auto const cos_d = 1 - half_d2;
+            return { sample.sin * cos_d + sample.cos * sin_d, sample.cos * cos_d - sample.sin * sin_d };
+        }
+
+    private:
+        // first quadrant values rotated into the others, so the axes are exact
+        static constexpr auto table = [] {
+            std::array<SinCos, Size> t{};
+            for (std::size_t i = 0; i < Size; ++i) {
+                auto const a = 2 * 3.14159265358979323846 * static_cast<double>(i % (Size / 4)) / Size;
+                auto const s = static_cast<FLOAT>(gcem::sin(a)), c = static_cast<FLOAT>(gcem::cos(a));
+                switch (i / (Size / 4)) {
+                case 0: t[i] = { s, c }; break;
+                case 1: t[i] = { c, -s }; break;
+                case 2: t[i] = { -s, -c }; break;
+                default: t[i] = { -c, s }; break;
+                }
+            }
+            return t;
+        }();
+    };
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace gm {
+
+    // Read-only memory mapping of a whole file
+    class MappedFile {
+    public:
+        MappedFile(MappedFile const&) = delete;
+        auto operator=(MappedFile const&) -> MappedFile& = delete;
+
+        MappedFile(MappedFile&& other) noexcept
+            : m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)) { }
+
+        auto operator=(MappedFile&& other) noexcept -> MappedFile& {
+            if (this != &other) {
+                unmap();
+                m_data = std::exchange(other.m_data, nullptr);
+                m_size = std::exchange(other.m_size, 0);
+            }
+            return *this;
+        }
+
+        ~MappedFile() { unmap(); }
+
+        static auto open(std::string const& path) -> std::optional<MappedFile> {
+#if defined(_WIN32)
+            auto const file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                          OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE) return std::nullopt;
+
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+                CloseHandle(file);
+                return std::nullopt;
+            }
+
+            auto const mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            CloseHandle(file);
+            if (mapping == nullptr) return std::nullopt;
+
+            auto* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+            if (data == nullptr) return std::nullopt;
+
+            return MappedFile{ static_cast<std::byte const*>(data), static_cast<std::size_t>(size.QuadPart) };
+#else
+            auto const fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) return std::nullopt;
+
+            struct stat info;
+            if (fstat(fd, &info) != 0 || info.st_size == 0) {
+                ::close(fd);
+                return std::nullopt;
+            }
+
+            auto const size = static_cast<std::size_t>(info.st_size);
+            auto* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if (data == MAP_FAILED) return std::nullopt;
+
+            return MappedFile{ static_cast<std::byte const*>(data), size };
+#endif
+        }
+
+        auto data() const -> std::byte const* { return m_data; }
+        auto size() const -> std::size_t { return m_size; }
+
+    private:
+        MappedFile(std::byte const* data, std::size_t size) : m_data(data), m_size(size) { }
+
+        auto unmap() -> void {
+            if (m_data == nullptr) return;
+#if defined(_WIN32)
+            UnmapViewOfFile(m_data);
+#else
+            munmap(const_cast<std::byte*>(m_data), m_size);
+#endif
+            m_data = nullptr;
+            m_size = 0;
+        }
+
+        std::byte const* m_data;
+        std::size_t m_size;
+    };
+}
@@ -4,15 +4,22 @@
 #include "vec3.hpp"
 
 #include "util.hpp"
+#include "compare.hpp"
+#include "dispatch.hpp"
+#include "interval.hpp"
+#include "span.hpp"
 
 #include <array>
 #include <algorithm>
+#include <cassert>
+#include <cstddef>
 #include <iomanip>
 #include <cmath>
 
 namespace gm {
 
-    template<typename Type, REQUIRES(std::is_arithmetic<Type>())>
+    // Type may also be an Interval, for rigorous bounds
+    template<typename Type, REQUIRES(std::is_arithmetic<Type>() || is_interval_v<Type>)>
     class Matrix4x4 {
     private:
         std::array<std::array<Type, 4>, 4> m;
@@ -34,7 +41,8 @@ namespace gm {
         auto constexpr operator()(int i, int j) -> Type& { return m[i][j]; }
         auto constexpr operator()(int i, int j) const -> Type const& { return m[i][j]; }
 
-        // TODO: handle floating point epsilon
+        // Exact, so that equal matrices hash equally; use approx_equal for a
+        // tolerance
         auto constexpr operator==(Matrix4x4<Type> other) const -> bool {
             return m == other.m; 
         }
@@ -52,8 +60,9 @@ namespace gm {
             };
         }
 
-        constexpr Matrix4x4(Matrix4x4<Type> const& mtx) : m(mtx.m) {}
-        constexpr Matrix4x4(Matrix4x4<Type>&& mtx) : m(std::move(mtx.m)) {}
+        // defaulted so the matrix stays trivially copyable
+        constexpr Matrix4x4(Matrix4x4 const& mtx) = default;
+        constexpr Matrix4x4(Matrix4x4&& mtx) = default;
 
         auto constexpr transpose() const -> Matrix4x4 {
             auto tmp = Matrix4x4::fill_with(1);
@@ -72,6 +81,7 @@ namespace gm {
         }
 
         static auto constexpr multiply(Matrix4x4<Type> const& a, Matrix4x4<Type> const& b) -> Matrix4x4<Type> {
+            GM_INSTRUMENT_COUNT(matrix_multiply);
             // rolled up version rather than writing out the arguments
             auto c = Matrix4x4::identity();
             for (uint8_t i = 0; i < 4; ++i) {
@@ -93,12 +103,100 @@ namespace gm {
             return *this;
         }
 
-        auto constexpr operator=(Matrix4x4<Type> const& other) -> Matrix4x4<Type> {
-            m = other.m; 
-            return *this; 
+        // Sparse in-place compositions: post_* computes this * op, pre_* computes op * this.
+        // They only touch the entries the operand affects and match multiply() exactly.
+
+        auto constexpr post_translate(Type x, Type y, Type z) -> Matrix4x4<Type>& {
+            for (int i = 0; i < 4; ++i) {
+                m[i][3] = m[i][0] * x + m[i][1] * y + m[i][2] * z + m[i][3];
+            }
+            return *this;
+        }
+
+        auto constexpr pre_translate(Type x, Type y, Type z) -> Matrix4x4<Type>& {
+            for (int j = 0; j < 4; ++j) {
+                m[0][j] += x * m[3][j];
+                m[1][j] += y * m[3][j];
+                m[2][j] += z * m[3][j];
+            }
+            return *this;
+        }
+
+        auto constexpr post_scale(Type x, Type y, Type z) -> Matrix4x4<Type>& {
+            for (int i = 0; i < 4; ++i) {
+                m[i][0] *= x;
+                m[i][1] *= y;
+                m[i][2] *= z;
+            }
+            return *this;
+        }
+
+        auto constexpr pre_scale(Type x, Type y, Type z) -> Matrix4x4<Type>& {
+            for (int j = 0; j < 4; ++j) {
+                m[0][j] *= x;
+                m[1][j] *= y;
+                m[2][j] *= z;
+            }
+            return *this;
+        }
+
+        // Only the upper-left 3x3 block of `rotation` is read, the remaining
+        // entries are assumed to be those of the identity
+        auto constexpr post_rotate(Matrix4x4<Type> const& rotation) -> Matrix4x4<Type>& {
+            auto const& r = rotation.m;
+            for (int i = 0; i < 4; ++i) {
+                auto const a0 = m[i][0], a1 = m[i][1], a2 = m[i][2];
+                for (int j = 0; j < 3; ++j) {
+                    m[i][j] = a0 * r[0][j] + a1 * r[1][j] + a2 * r[2][j];
+                }
+            }
+            return *this;
+        }
+
+        auto constexpr pre_rotate(Matrix4x4<Type> const& rotation) -> Matrix4x4<Type>& {
+            auto const& r = rotation.m;
+            for (int j = 0; j < 4; ++j) {
+                auto const b0 = m[0][j], b1 = m[1][j], b2 = m[2][j];
+                for (int i = 0; i < 3; ++i) {
+                    m[i][j] = r[i][0] * b0 + r[i][1] * b1 + r[i][2] * b2;
+                }
+            }
+            return *this;
         }
 
+        auto constexpr operator=(Matrix4x4 const& other) -> Matrix4x4& = default;
+        auto constexpr operator=(Matrix4x4&& other) -> Matrix4x4& = default;
+
     };
     typedef Matrix4x4<float> Matrix4x4f;
 
+#if defined(GRAPHICS_MATH_STATIC) && !defined(GRAPHICS_MATH_IMPLEMENTATION)
+    // instantiated in graphics-math-static
+    extern template class Matrix4x4<float>;
+    extern template class Matrix4x4<double>;
+    extern template class Matrix4x4<int>;
+#endif
+
+    // Pairwise products a[i] * b[i], rounded exactly as multiply() at every CPU tier
+    GM_KERNEL_ABI auto multiply(Span<Matrix4x4f const> a, Span<Matrix4x4f const> b, Matrix4x4f* out) -> void;
+
+#if !defined(GM_KERNELS_OUT_OF_LINE)
+    GM_KERNEL auto multiply(Span<Matrix4x4f const> a, Span<Matrix4x4f const> b, Matrix4x4f* out) -> void {
+        assert(a.size() == b.size());
+        detail::dispatch([&] {
+            for (std::size_t i = 0; i < a.size(); ++i) out[i] = Matrix4x4f::multiply(a.data()[i], b.data()[i]);
+        });
+    }
+#endif
+
+    template<typename Type, typename Policy>
+    auto constexpr approx_equal(Matrix4x4<Type> const& a, Matrix4x4<Type> const& b, Policy const& policy) -> bool {
+        auto equal = true;
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                equal &= policy(a(i, j), b(i, j));
+            }
+        }
+        return equal;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,186 @@
+#pragma once
+
+#include "normal3.hpp"
+#include "onb.hpp"
+#include "parallel.hpp"
+#include "point2.hpp"
+#include "point3.hpp"
+#include "span.hpp"
+#include "vec3.hpp"
+#include "util.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+// Routines over indexed triangle meshes: three indices per triangle into the
+// vertex arrays. Per triangle work runs in parallel and is then gathered per
+// vertex, so results do not depend on the thread count.
+namespace gm {
+
+    // A vertex tangent in MikkTSpace's layout, the bitangent is
+    // sign * cross(normal, direction)
+    struct Tangent {
+        Normal3f direction;
+        FLOAT sign = 1;
+
+        auto frame(Normal3f const& normal) const -> ONB {
+            return { direction, (sign * cross(normal, Vec3f(direction))).normalise(), normal };
+        }
+    };
+
+    // Per triangle bounds and centroids (vertex average) in structure of
+    // arrays layout
+    struct TriangleBounds {
+        std::vector<FLOAT> min_x, min_y, min_z;
+        std::vector<FLOAT> max_x, max_y, max_z;
+        std::vector<FLOAT> centroid_x, centroid_y, centroid_z;
+
+        auto size() const -> std::size_t { return min_x.size(); }
+
+        auto resize(std::size_t count) -> void {
+            for (auto* v : { &min_x, &min_y, &min_z, &max_x, &max_y, &max_z, &centroid_x, &centroid_y, &centroid_z }) v->resize(count);
+        }
+    };
+
+    namespace detail {
+        inline constexpr std::size_t triangle_chunk_size = 1 << 14;
+
+        // The corners (3 * triangle + k) around each vertex as compressed
+        // rows, in increasing triangle order
+        struct VertexCorners {
+            std::vector<std::uint32_t> offsets;
+            std::vector<std::uint32_t> corners;
+        };
+
+        inline auto vertex_corners(Span<std::uint32_t const> indices, std::size_t vertex_count) -> VertexCorners {
+            VertexCorners result;
+            result.offsets.assign(vertex_count + 1, 0);
+            for (auto v : indices) {
+                assert(v < vertex_count);
+                ++result.offsets[v + 1];
+            }
+            std::partial_sum(result.offsets.begin(), result.offsets.end(), result.offsets.begin());
+            result.corners.resize(indices.size());
+            std::vector<std::uint32_t> cursor(result.offsets.begin(), result.offsets.end() - 1);
+            for (std::size_t c = 0; c < indices.size(); ++c) {
+                result.corners[cursor[indices[c]]++] = static_cast<std::uint32_t>(c);
+            }
+            return result;
+        }
+
+        // Unit length or zero
+        inline auto normalise_or_zero(Vec3f const& v) -> Vec3f {
+            auto const length_squared = v.length_squared();
+            return length_squared > 0 ? v / std::sqrt(length_squared) : Vec3f{};
+        }
+
+        inline auto project(Vec3f const& v, Normal3f const& n) -> Vec3f {
+            return v - dot(n, v) * n;
+        }
+    }
+
+    // Area weighted vertex normals: every triangle adds its unnormalised
+    // cross product, whose length is twice its area. Vertices without a non
+    // degenerate triangle get the default normal (+z).
+    inline auto vertex_normals(Span<Point3f const> positions, Span<std::uint32_t const> indices, Normal3f* out) -> void {
+        assert(indices.size() % 3 == 0);
+        auto const triangle_count = indices.size() / 3;
+        std::vector<Vec3f> face(triangle_count);
+        parallel_for(triangle_count, [&](std::size_t begin, std::size_t end) {
+            for (auto t = begin; t < end; ++t) {
+                auto const& p0 = positions[indices[3 * t]];
+                face[t] = cross(positions[indices[3 * t + 1]] - p0, positions[indices[3 * t + 2]] - p0);
+            }
+        }, detail::triangle_chunk_size);
+
+        auto const rows = detail::vertex_corners(indices, positions.size());
+        parallel_for(positions.size(), [&](std::size_t begin, std::size_t end) {
+            for (auto v = begin; v < end; ++v) {
+                Vec3f sum;
+                for (auto c = rows.offsets[v]; c < rows.offsets[v + 1]; ++c) sum = sum + face[rows.corners[c] / 3];
+                out[v] = sum.length_squared() > 0 ? sum.normalise() : Normal3f{};
+            }
+        });
+    }
+
+    // Vertex tangents as MikkTSpace computes them: each triangle's tangent
+    // and bitangent from its UV derivatives are projected into the tangent
+    // plane of every corner's normal, weighted by the corner angle in that
+    // plane and summed per vertex. Unlike the reference implementation,
+    // vertices are not split where the UV mapping is mirrored; the sign
+    // follows the summed bitangent. Vertices without usable UVs get an
+    // arbitrary tangent orthogonal to the normal.
+    inline auto vertex_tangents(Span<Point3f const> positions, Span<Normal3f const> normals, Span<Point2f const> uvs,
+                                Span<std::uint32_t const> indices, Tangent* out) -> void {
+        assert(indices.size() % 3 == 0);
+        assert(normals.size() == positions.size() && uvs.size() == positions.size());
+        auto const triangle_count = indices.size() / 3;
+        std::vector<Vec3f> corner_tangent(indices.size()), corner_bitangent(indices.size());
+        parallel_for(triangle_count, [&](std::size_t begin, std::size_t end) {
+            for (auto t = begin; t < end; ++t) {
+                std::uint32_t const v[3] = { indices[3 * t], indices[3 * t + 1], indices[3 * t + 2] };
+                auto const e1 = positions[v[1]] - positions[v[0]], e2 = positions[v[2]] - positions[v[0]];
+                auto const du1 = uvs[v[1]].x - uvs[v[0]].x, dv1 = uvs[v[1]].y - uvs[v[0]].y;
+                auto const du2 = uvs[v[2]].x - uvs[v[0]].x, dv2 = uvs[v[2]].y - uvs[v[0]].y;
+                // twice the signed UV area, only its sign is used since the
+                // directions are normalised per corner
+                auto const area = du1 * dv2 - du2 * dv1;
+                auto const orientation = area > 0 ? FLOAT(1) : area < 0 ? FLOAT(-1) : FLOAT(0);
+                auto const tangent = orientation * (e1 * dv2 - e2 * dv1);
+                auto const bitangent = orientation * (e2 * du1 - e1 * du2);
+
+                for (int k = 0; k < 3; ++k) {
+                    auto const& n = normals[v[k]];
+                    auto const& p = positions[v[k]];
+                    auto const a = detail::normalise_or_zero(detail::project(positions[v[(k + 1) % 3]] - p, n));
+                    auto const b = detail::normalise_or_zero(detail::project(positions[v[(k + 2) % 3]] - p, n));
+                    auto const angle = std::acos(std::clamp(dot(a, b), FLOAT(-1), FLOAT(1)));
+                    corner_tangent[3 * t + k] = angle * detail::normalise_or_zero(detail::project(tangent, n));
+                    corner_bitangent[3 * t + k] = angle * detail::normalise_or_zero(detail::project(bitangent, n));
+                }
+            }
+        }, detail::triangle_chunk_size);
+
+        auto const rows = detail::vertex_corners(indices, positions.size());
+        parallel_for(positions.size(), [&](std::size_t begin, std::size_t end) {
+            for (auto v = begin; v < end; ++v) {
+                Vec3f tangent, bitangent;
+                for (auto c = rows.offsets[v]; c < rows.offsets[v + 1]; ++c) {
+                    tangent = tangent + corner_tangent[rows.corners[c]];
+                    bitangent = bitangent + corner_bitangent[rows.corners[c]];
+                }
+                auto const& n = normals[v];
+                tangent = detail::project(tangent, n);
+                out[v].direction = tangent.length_squared() > 0 ? tangent.normalise() : ONB(n).u();
+                out[v].sign = dot(cross(n, Vec3f(out[v].direction)), bitangent) < 0 ? FLOAT(-1) : FLOAT(1);
+            }
+        });
+    }
+
+    inline auto triangle_bounds(Span<Point3f const> positions, Span<std::uint32_t const> indices, TriangleBounds& out) -> void {
+        assert(indices.size() % 3 == 0);
+        auto const triangle_count = indices.size() / 3;
+        out.resize(triangle_count);
+        parallel_for(triangle_count, [&](std::size_t begin, std::size_t end) {
+            for (auto t = begin; t < end; ++t) {
+                auto const& p0 = positions[indices[3 * t]];
+                auto const& p1 = positions[indices[3 * t + 1]];
+                auto const& p2 = positions[indices[3 * t + 2]];
+                out.min_x[t] = std::min({ p0.x, p1.x, p2.x });
+                out.min_y[t] = std::min({ p0.y, p1.y, p2.y });
+                out.min_z[t] = std::min({ p0.z, p1.z, p2.z });
+                out.max_x[t] = std::max({ p0.x, p1.x, p2.x });
+                out.max_y[t] = std::max({ p0.y, p1.y, p2.y });
+                out.max_z[t] = std::max({ p0.z, p1.z, p2.z });
+                out.centroid_x[t] = (p0.x + p1.x + p2.x) * (FLOAT(1) / 3);
+                out.centroid_y[t] = (p0.y + p1.y + p2.y) * (FLOAT(1) / 3);
+                out.centroid_z[t] = (p0.z + p1.z + p2.z) * (FLOAT(1) / 3);
+            }
+        }, detail::triangle_chunk_size);
+    }
+}
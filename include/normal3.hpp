@@ -1,8 +1,13 @@
 #pragma once
 
 #include "util.hpp"
+#include "compare.hpp"
+#include "dispatch.hpp"
+#include "span.hpp"
 #include "vec3.hpp"
 
+#include <charconv>
+#include <cstddef>
 #include <ostream>
 
 namespace gm {
@@ -16,31 +21,26 @@ namespace gm {
         template<typename>
         friend class Vec3;
 
+        // parsing restores the exact components without renormalising
+        template<typename T>
+        friend auto from_chars(char const* first, char const* last, Normal3<T>& n) -> std::from_chars_result;
+
     public:
+        constexpr Normal3() : m_x(0), m_y(0), m_z(1) { }
+
         auto constexpr x() const -> Type { return m_x; }
         auto constexpr y() const -> Type { return m_y; }
         auto constexpr z() const -> Type { return m_z; }
 
         auto constexpr operator==(Normal3<Type> const& other) const -> bool {
-            if constexpr (std::is_floating_point_v<Type>) {
-                return gcem::abs(x() - other.x()) < constants::epsilon
-                    && gcem::abs(y() - other.y()) < constants::epsilon
-                    && gcem::abs(z() - other.z()) < constants::epsilon;
-            } 
-            return x() == other.x() && y() == other.y() && z() == other.z();
+            return approx_equal(*this, other, DefaultComparison<Type>{});
         }
 
         auto constexpr operator!=(Normal3<Type> const& other) const -> bool {
-            if constexpr (std::is_floating_point_v<Type>) {
-                return gcem::abs(x() - other.x()) > constants::epsilon
-                    || gcem::abs(y() - other.y()) > constants::epsilon
-                    || gcem::abs(z() - other.z()) > constants::epsilon;
-            } else {
-                return x() != other.x() || y() != other.y() || z() != other.z();
-            }
-        } 
+            return !(*this == other);
+        }
 
-        constexpr explicit operator Vec3<Type>() const { return Vec3f{ x(), y(), z() }; }
+        constexpr explicit operator Vec3<Type>() const { return Vec3<Type>{ x(), y(), z() }; }
 
         auto friend operator<<(std::ostream &os, Normal3<Type> const& n) -> std::ostream & {
             os << '[' << n.x() << ',' << n.y() << ',' << n.z() <<']' << '\n';
@@ -53,6 +53,11 @@ namespace gm {
         }
     };
 
+    template<typename Type, typename Policy>
+    auto constexpr approx_equal(Normal3<Type> const& a, Normal3<Type> const& b, Policy const& policy) -> bool {
+        return policy(a.x(), b.x()) & policy(a.y(), b.y()) & policy(a.z(), b.z());
+    }
+
     template<typename Type>
     auto constexpr operator*(Type const scalar, Normal3<Type> const& n) -> Vec3<Type> {
         return { scalar * n.x(), scalar * n.y(), scalar * n.z() };
@@ -90,4 +95,21 @@ namespace gm {
     }
 
     typedef Normal3<FLOAT> Normal3f;
+
+#if defined(GRAPHICS_MATH_STATIC) && !defined(GRAPHICS_MATH_IMPLEMENTATION)
+    // instantiated in graphics-math-static
+    extern template class Normal3<float>;
+    extern template class Normal3<double>;
+#endif
+
+    // Batched Vec3::normalise, dispatched to the best CPU tier
+    GM_KERNEL_ABI auto normalise(Span<Vec3f const> in, Normal3f* out) -> void;
+
+#if !defined(GM_KERNELS_OUT_OF_LINE)
+    GM_KERNEL auto normalise(Span<Vec3f const> in, Normal3f* out) -> void {
+        detail::dispatch([&] {
+            for (std::size_t i = 0; i < in.size(); ++i) out[i] = in.data()[i].normalise();
+        });
+    }
+#endif
 }
\ No newline at end of file
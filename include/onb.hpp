@@ -27,6 +27,9 @@ namespace gm {
             m_basis[1] = cross(m_basis[2], a).normalise();
             m_basis[0] = cross(m_basis[1], m_basis[2]).normalise();
         }
+
+        // From an existing orthonormal frame, e.g. a tangent frame
+        constexpr ONB(Normal3f const& u, Normal3f const& v, Normal3f const& w) : m_basis{ u, v, w } { }
         
         auto constexpr operator[](int i) const ->  Normal3f const& {
             return m_basis[i];
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace gm {
+
+    inline auto thread_count() -> std::size_t {
+        return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    // Splits [0, count) into `chunks` contiguous ranges and calls
+    // f(chunk, begin, end) for each on its own thread. Chunk boundaries only
+    // depend on count and chunks, so consecutive calls see the same ranges.
+    template<typename Function>
+    auto parallel_chunks(std::size_t count, std::size_t chunks, Function const& f) -> void {
+        auto const range = [count, chunks](std::size_t chunk) {
+            return count / chunks * chunk + std::min(chunk, count % chunks);
+        };
+        if (chunks <= 1) {
+            f(std::size_t(0), std::size_t(0), count);
+            return;
+        }
+
+        std::vector<std::thread> threads;
+        threads.reserve(chunks - 1);
+        for (std::size_t chunk = 1; chunk < chunks; ++chunk) {
+            threads.emplace_back([&f, &range, chunk] { f(chunk, range(chunk), range(chunk + 1)); });
+        }
+        f(std::size_t(0), range(0), range(1));
+        for (auto& thread : threads) thread.join();
+    }
+
+    // Number of chunks worth a thread each for `count` items
+    inline auto chunk_count(std::size_t count, std::size_t min_chunk_size = 1 << 16) -> std::size_t {
+        return std::clamp<std::size_t>(count / min_chunk_size, 1, thread_count());
+    }
+
+    // Calls f(begin, end) over disjoint ranges covering [0, count)
+    template<typename Function>
+    auto parallel_for(std::size_t count, Function const& f, std::size_t min_chunk_size = 1 << 16) -> void {
+        parallel_chunks(count, chunk_count(count, min_chunk_size),
+                        [&f](std::size_t, std::size_t begin, std::size_t end) { f(begin, end); });
+    }
+}
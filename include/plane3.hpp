@@ -0,0 +1,68 @@
+#pragma once
+
+#include "util.hpp"
+#include "vec3.hpp"
+#include "point3.hpp"
+#include "normal3.hpp"
+
+#include <ostream>
+
+namespace gm {
+
+    // Plane in the implicit form dot(normal, p) + d = 0. The normal is not
+    // required to be unit length; call normalise() before using distance().
+    template<typename Type>
+    class Plane3 {
+    public:
+        Vec3<Type> normal;
+        Type d;
+
+        constexpr Plane3() : normal(0, 0, 1), d(0) { }
+        constexpr Plane3(Type a, Type b, Type c, Type d_) : normal(a, b, c), d(d_) { }
+        constexpr Plane3(Vec3<Type> const& n, Type d_) : normal(n), d(d_) { }
+        constexpr Plane3(Normal3<Type> const& n, Point3<Type> const& p)
+            : normal(static_cast<Vec3<Type>>(n)), d(-(n.x() * p.x + n.y() * p.y + n.z() * p.z)) { }
+
+        auto constexpr operator==(Plane3<Type> const& other) const -> bool {
+            if constexpr (std::is_floating_point_v<Type>) {
+                return normal == other.normal && gcem::abs(d - other.d) < constants::epsilon;
+            } else {
+                return normal == other.normal && d == other.d;
+            }
+        }
+
+        auto constexpr operator!=(Plane3<Type> const& other) const -> bool {
+            return !(*this == other);
+        }
+
+        // Signed distance scaled by the length of the normal
+        auto constexpr evaluate(Point3<Type> const& p) const -> Type {
+            return normal.x * p.x + normal.y * p.y + normal.z * p.z + d;
+        }
+
+        // Signed distance, assumes a unit length normal
+        auto constexpr distance(Point3<Type> const& p) const -> Type {
+            return evaluate(p);
+        }
+
+        // A degenerate plane (zero normal) is returned as is
+        auto constexpr normalise() const -> Plane3<Type> {
+            static_assert(std::is_floating_point_v<Type>);
+            auto const len = normal.length();
+            if (len == 0) return *this;
+            auto const inv_len = 1 / len;
+            return { normal * inv_len, d * inv_len };
+        }
+
+        auto constexpr flip() const -> Plane3<Type> {
+            return { -normal, -d };
+        }
+
+        auto friend operator<<(std::ostream &os, Plane3<Type> const& p) -> std::ostream & {
+            os << '[' << p.normal.x << ',' << p.normal.y << ',' << p.normal.z << ',' << p.d << ']' << '\n';
+            return os;
+        }
+    };
+
+    typedef Plane3<FLOAT> Plane3f;
+}
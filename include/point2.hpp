@@ -12,40 +12,31 @@ namespace gm {
 template<typename Type>
 class Point2 {
 public:
-    Type x, y, z;
+    Type x, y;
 
-    constexpr Point2() : x(0), y(0), z(0) { }
+    constexpr Point2() : x(0), y(0) { }
     constexpr Point2(Type x, Type y) : x(x), y(y){ }
     constexpr explicit Point2(Type val) : x(val), y(val) { }
     constexpr explicit Point2(Point3<Type> const& p) : x(p.x), y(p.y) { }
 
     auto constexpr operator==(Point2<Type> const& other) const -> bool {
-        if constexpr (std::is_floating_point_v<Type>) {
-            return gcem::abs(x - other.x) < constants::epsilon
-                && gcem::abs(y - other.y) < constants::epsilon;
-        } 
-        return x == other.x && y == other.y;
+        return approx_equal(*this, other, DefaultComparison<Type>{});
     }
 
     auto constexpr operator!=(Point2<Type> const& other) const -> bool {
-        if constexpr (std::is_floating_point_v<Type>) {
-            return gcem::abs(x - other.x) > constants::epsilon
-                || gcem::abs(y - other.y) > constants::epsilon;
-        } else {
-            return x != other.x || y != other.y;
-        }
+        return !(*this == other);
     }
 
     auto constexpr operator-(Point2<Type> const& other) const -> Vec2<Type> {
-        return { x - other.x, y - other.y, z - other.z };
+        return { x - other.x, y - other.y };
     }
 
     auto constexpr operator+(Vec2<Type> const& v) const -> Point2<Type> {
-        return { x + v.x, y + v.y, z + v.z };
+        return { x + v.x, y + v.y };
     }
 
     auto constexpr operator-(Vec2<Type> const& v) const -> Point2<Type> {
-        return { x - v.x, y - v.y, z - v.z };
+        return { x - v.x, y - v.y };
     }
 
     auto constexpr operator/(Type div) const -> Point2<Type> {
@@ -53,10 +44,9 @@ public:
     }
 
     auto constexpr operator[](std::size_t const index) const -> Type {
-        assert(index >= 0 && index <= 2);
+        assert(index >= 0 && index <= 1);
         if (index == 0) return x; 
-        if (index == 1) return y; 
-        return z;
+        return y;
     }
 
     auto friend operator<<(std::ostream &os, Point2<Type> const& p) -> std::ostream & {
@@ -66,6 +56,11 @@ public:
 
 };
 
+template<typename Type, typename Policy>
+auto constexpr approx_equal(Point2<Type> const& a, Point2<Type> const& b, Policy const& policy) -> bool {
+    return policy(a.x, b.x) & policy(a.y, b.y);
+}
+
 template<typename Type>
 auto elementwise_min(const Point2<Type>& a, const Point2<Type>& b) -> Point2<Type> {
     return {std::min(a.x, b.x), std::min(a.y, b.y)};
@@ -89,4 +84,10 @@ auto constexpr operator/(Type const scalar, Point2<Type> const& p) -> Point2<Typ
 typedef Point2<FLOAT> Point2f;
 typedef Point2<int> Point2i;
 
+#if defined(GRAPHICS_MATH_STATIC) && !defined(GRAPHICS_MATH_IMPLEMENTATION)
+    // instantiated in graphics-math-static
+    extern template class Point2<float>;
+    extern template class Point2<double>;
+    extern template class Point2<int>;
+#endif
 }
\ No newline at end of file
@@ -18,23 +18,12 @@ namespace gm {
         constexpr explicit Point3(Type val) : x(val), y(val), z(val) { }
 
         auto constexpr operator==(Point3<Type> const& other) const -> bool {
-            if constexpr (std::is_floating_point_v<Type>) {
-                return gcem::abs(x - other.x) < constants::epsilon
-                    && gcem::abs(y - other.y) < constants::epsilon
-                    && gcem::abs(z - other.z) < constants::epsilon;
-            } 
-            return x == other.x && y == other.y && z == other.z;
+            return approx_equal(*this, other, DefaultComparison<Type>{});
         }
 
         auto constexpr operator!=(Point3<Type> const& other) const -> bool {
-            if constexpr (std::is_floating_point_v<Type>) {
-                return gcem::abs(x - other.x) > constants::epsilon
-                    || gcem::abs(y - other.y) > constants::epsilon
-                    || gcem::abs(z - other.z) > constants::epsilon;
-            } else {
-                return x != other.x || y != other.y || z != other.z;
-            }
-        } 
+            return !(*this == other);
+        }
 
         auto constexpr operator-(Point3<Type> const& other) const -> Vec3<Type> {
             return { x - other.x, y - other.y, z - other.z };
@@ -69,7 +58,11 @@ namespace gm {
         }
     };
 
-    
+    template<typename Type, typename Policy>
+    auto constexpr approx_equal(Point3<Type> const& a, Point3<Type> const& b, Policy const& policy) -> bool {
+        return policy(a.x, b.x) & policy(a.y, b.y) & policy(a.z, b.z);
+    }
+
     template<typename Type>
     auto elementwise_min(const Point3<Type>& a, const Point3<Type>& b) -> Point3<Type> {
         return {std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z)};
@@ -93,4 +86,10 @@ namespace gm {
     typedef Point3<FLOAT> Point3f;
     typedef Point3<int> Point3i;
 
+#if defined(GRAPHICS_MATH_STATIC) && !defined(GRAPHICS_MATH_IMPLEMENTATION)
+    // instantiated in graphics-math-static
+    extern template class Point3<float>;
+    extern template class Point3<double>;
+    extern template class Point3<int>;
+#endif
 }
\ No newline at end of file
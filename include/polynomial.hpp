@@ -0,0 +1,299 @@
+#pragma once
+
+#include "util.hpp"
+
+#include <gcem.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace gm {
+
+    // Real roots in increasing order. A repeated root may be listed more
+    // than once.
+    template<std::size_t N>
+    struct Roots {
+        std::array<FLOAT, N> values{};
+        std::size_t count = 0;
+
+        auto constexpr size() const -> std::size_t { return count; }
+        auto constexpr empty() const -> bool { return count == 0; }
+        auto constexpr operator[](std::size_t i) const -> FLOAT { return values[i]; }
+        auto constexpr begin() const -> FLOAT const* { return values.data(); }
+        auto constexpr end() const -> FLOAT const* { return values.data() + count; }
+    };
+
+    namespace detail {
+        // gcem in constant expressions, the much faster std functions otherwise
+#if defined(__GNUC__) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+        auto constexpr constant_evaluated() -> bool { return __builtin_is_constant_evaluated(); }
+#else
+        auto constexpr constant_evaluated() -> bool { return true; }
+#endif
+
+        auto constexpr sqrt(FLOAT x) -> FLOAT {
+            return constant_evaluated() ? static_cast<FLOAT>(gcem::sqrt(x)) : std::sqrt(x);
+        }
+
+        auto constexpr cbrt(FLOAT x) -> FLOAT {
+            if (!constant_evaluated()) return std::cbrt(x);
+            auto const r = static_cast<FLOAT>(gcem::pow(gcem::abs(x), FLOAT(1) / 3));
+            return x < 0 ? -r : r;
+        }
+
+        auto constexpr acos(FLOAT x) -> FLOAT {
+            return constant_evaluated() ? static_cast<FLOAT>(gcem::acos(x)) : std::acos(x);
+        }
+
+        auto constexpr cos(FLOAT x) -> FLOAT {
+            return constant_evaluated() ? static_cast<FLOAT>(gcem::cos(x)) : std::cos(x);
+        }
+
+        template<std::size_t N>
+        auto constexpr push(Roots<N>& roots, FLOAT x) -> void {
+            roots.values[roots.count++] = x;
+        }
+
+        // insertion sort, std::sort is not constexpr before C++20
+        template<std::size_t N>
+        auto constexpr sort(Roots<N>& roots) -> void {
+            for (std::size_t i = 1; i < roots.count; ++i) {
+                auto const x = roots.values[i];
+                auto j = i;
+                for (; j > 0 && roots.values[j - 1] > x; --j) roots.values[j] = roots.values[j - 1];
+                roots.values[j] = x;
+            }
+        }
+
+        // One Newton step on the monic polynomial with the given lower
+        // coefficients, highest first
+        template<std::size_t N>
+        auto constexpr polish(FLOAT x, std::array<FLOAT, N> const& c) -> FLOAT {
+            FLOAT f = 1, df = 0;
+            for (auto const coefficient : c) {
+                df = df * x + f;
+                f = f * x + coefficient;
+            }
+            return df != 0 ? x - f / df : x;
+        }
+
+        // Also handles a == 0
+        auto constexpr quadratic(FLOAT a, FLOAT b, FLOAT c) -> Roots<2> {
+            Roots<2> roots;
+            if (a == 0) {
+                if (b != 0) push(roots, -c / b);
+                return roots;
+            }
+            auto const discr = b * b - 4 * a * c;
+            if (discr < 0) return roots;
+            // avoids cancellation between b and the root
+            auto const q = FLOAT(-0.5) * (b + (b < 0 ? -sqrt(discr) : sqrt(discr)));
+            if (q == 0) {
+                push(roots, FLOAT(0));
+                return roots;
+            }
+            push(roots, q / a);
+            push(roots, c / q);
+            sort(roots);
+            return roots;
+        }
+    }
+
+    // Real roots of a x^3 + b x^2 + c x + d (Cardano, or trigonometric for
+    // three real roots), each polished with one Newton step
+    template<typename T, REQUIRES(std::is_arithmetic<T>())>
+    auto constexpr solve_cubic(T a, T b, T c, T d) -> Roots<3> {
+        Roots<3> roots;
+        if (a == 0) {
+            for (auto const x : detail::quadratic(static_cast<FLOAT>(b), static_cast<FLOAT>(c), static_cast<FLOAT>(d))) detail::push(roots, x);
+            return roots;
+        }
+
+        auto const inv_a = 1 / static_cast<FLOAT>(a);
+        auto const A = static_cast<FLOAT>(b) * inv_a, B = static_cast<FLOAT>(c) * inv_a, C = static_cast<FLOAT>(d) * inv_a;
+        // substituting x = t - A / 3 gives t^3 + 3 p t + 2 q = 0
+        auto const sq_A = A * A;
+        auto const p = (B - sq_A / 3) / 3;
+        auto const q = (2 * A * sq_A / 27 - A * B / 3 + C) / 2;
+        auto const cb_p = p * p * p;
+        auto const discr = q * q + cb_p;
+
+        if (discr == 0) {
+            auto const u = detail::cbrt(-q);
+            detail::push(roots, 2 * u);
+            if (u != 0) detail::push(roots, -u);
+        } else if (discr < 0) {
+            auto const phi = detail::acos(std::clamp(-q / detail::sqrt(-cb_p), FLOAT(-1), FLOAT(1))) / 3;
+            auto const t = 2 * detail::sqrt(-p);
+            detail::push(roots, t * detail::cos(phi));
+            detail::push(roots, -t * detail::cos(phi + constants::pi / 3));
+            detail::push(roots, -t * detail::cos(phi - constants::pi / 3));
+        } else {
+            auto const s = detail::sqrt(discr);
+            detail::push(roots, detail::cbrt(s - q) - detail::cbrt(s + q));
+        }
+
+        std::array<FLOAT, 3> const monic{ A, B, C };
+        for (std::size_t i = 0; i < roots.count; ++i) roots.values[i] = detail::polish(roots.values[i] - A / 3, monic);
+        detail::sort(roots);
+        return roots;
+    }
+
+    // Real roots of a x^4 + b x^3 + c x^2 + d x + e by Ferrari's method: the
+    // depressed quartic splits into two quadratics through a root of the
+    // resolvent cubic. Each root is polished with two Newton steps.
+    template<typename T, REQUIRES(std::is_arithmetic<T>())>
+    auto constexpr solve_quartic(T a, T b, T c, T d, T e) -> Roots<4> {
+        Roots<4> roots;
+        if (a == 0) {
+            for (auto const x : solve_cubic(b, c, d, e)) detail::push(roots, x);
+            return roots;
+        }
+
+        auto const inv_a = 1 / static_cast<FLOAT>(a);
+        auto const A = static_cast<FLOAT>(b) * inv_a, B = static_cast<FLOAT>(c) * inv_a;
+        auto const C = static_cast<FLOAT>(d) * inv_a, D = static_cast<FLOAT>(e) * inv_a;
+        // substituting x = y - A / 4 gives y^4 + p y^2 + q y + r = 0
+        auto const sq_A = A * A;
+        auto const p = FLOAT(-3) / 8 * sq_A + B;
+        auto const q = sq_A * A / 8 - A * B / 2 + C;
+        auto const r = FLOAT(-3) / 256 * sq_A * sq_A + sq_A * B / 16 - A * C / 4 + D;
+
+        if (r == 0) {
+            // y (y^3 + p y + q) = 0
+            detail::push(roots, FLOAT(0));
+            for (auto const y : solve_cubic(FLOAT(1), FLOAT(0), p, q)) detail::push(roots, y);
+        } else {
+            // (y^2 + z + s y - u)(y^2 + z - s y + u) with 2 z - s^2 = p,
+            // 2 s u = q and z^2 - u^2 = r, for a root z of the resolvent
+            std::array<FLOAT, 3> const cubic{ -p / 2, -r, r * p / 2 - q * q / 8 };
+            auto const resolvent = solve_cubic(FLOAT(1), cubic[0], cubic[1], cubic[2]);
+            // the largest root keeps s and u real whenever possible
+            auto const z = detail::polish(detail::polish(resolvent[resolvent.count - 1], cubic), cubic);
+            auto const s_sq = 2 * z - p, u_sq = z * z - r;
+            // take the square root of the larger and divide for the other,
+            // which avoids the cancellation in the smaller
+            FLOAT s = 0, u = 0;
+            if (s_sq >= u_sq && s_sq > 0) {
+                s = q < 0 ? -detail::sqrt(s_sq) : detail::sqrt(s_sq);
+                u = q / (2 * s);
+            } else if (u_sq > 0) {
+                u = detail::sqrt(u_sq);
+                s = q / (2 * u);
+            }
+            for (auto const y : detail::quadratic(1, s, z - u)) detail::push(roots, y);
+            for (auto const y : detail::quadratic(1, -s, z + u)) detail::push(roots, y);
+        }
+
+        std::array<FLOAT, 4> const monic{ A, B, C, D };
+        for (std::size_t i = 0; i < roots.count; ++i) {
+            roots.values[i] = detail::polish(detail::polish(roots.values[i] - A / 4, monic), monic);
+        }
+        detail::sort(roots);
+        return roots;
+    }
+
+    // Horner evaluation of c[0] + c[1] x + ... + c[N - 1] x^(N - 1)
+    template<std::size_t N>
+    auto constexpr evaluate_polynomial(FLOAT x, std::array<FLOAT, N> const& c) -> FLOAT {
+        FLOAT result = 0;
+        for (std::size_t i = N; i-- > 0;) result = result * x + c[i];
+        return result;
+    }
+
+    // Safeguarded Newton iteration on N brackets in lockstep. f(lane, x)
+    // returns {f(x), f'(x)} for that lane, and f must change sign over
+    // [lo[lane], hi[lane]]; lanes where it does not give NaN. Every lane runs
+    // all iterations and steps are selected without branching, so the lanes
+    // vectorize. Steps leaving the bracket fall back to bisection.
+    template<std::size_t N, typename Function>
+    auto newton_bisect(Function const& f, std::array<FLOAT, N> lo, std::array<FLOAT, N> hi, int iterations = 24) -> std::array<FLOAT, N> {
+        std::array<FLOAT, N> x{}, f_lo{};
+        std::array<bool, N> bracketed{};
+        for (std::size_t lane = 0; lane < N; ++lane) {
+            f_lo[lane] = f(lane, lo[lane]).first;
+            bracketed[lane] = (f_lo[lane] <= 0) != (f(lane, hi[lane]).first <= 0);
+            x[lane] = (lo[lane] + hi[lane]) / 2;
+        }
+        for (int iteration = 0; iteration < iterations; ++iteration) {
+            for (std::size_t lane = 0; lane < N; ++lane) {
+                auto const [fx, dfx] = f(lane, x[lane]);
+                auto const same_side = (fx <= 0) == (f_lo[lane] <= 0);
+                lo[lane] = same_side ? x[lane] : lo[lane];
+                hi[lane] = same_side ? hi[lane] : x[lane];
+                auto const newton = x[lane] - fx / dfx;
+                auto const inside = newton > lo[lane] && newton < hi[lane];
+                x[lane] = inside ? newton : (lo[lane] + hi[lane]) / 2;
+            }
+        }
+        for (std::size_t lane = 0; lane < N; ++lane) {
+            x[lane] = bracketed[lane] ? x[lane] : std::numeric_limits<FLOAT>::quiet_NaN();
+        }
+        return x;
+    }
+
+    // Scalar form, stops once the bracket is narrower than `tolerance`
+    template<typename Function>
+    auto newton_bisect(Function const& f, FLOAT lo, FLOAT hi, FLOAT tolerance = constants::epsilon, int max_iterations = 64) -> std::optional<FLOAT> {
+        auto const f_lo = f(lo).first;
+        if ((f_lo <= 0) == (f(hi).first <= 0)) return std::nullopt;
+        auto x = (lo + hi) / 2;
+        for (int iteration = 0; iteration < max_iterations && hi - lo > tolerance; ++iteration) {
+            auto const [fx, dfx] = f(x);
+            if (fx == 0) return x;
+            if ((fx <= 0) == (f_lo <= 0)) lo = x; else hi = x;
+            auto const newton = x - fx / dfx;
+            x = newton > lo && newton < hi ? newton : (lo + hi) / 2;
+        }
+        return x;
+    }
+
+    // The Bernstein basis polynomial i of degree n at t
+    auto constexpr bernstein(int i, int n, FLOAT t) -> FLOAT {
+        FLOAT binomial = 1;
+        for (int k = 1; k <= i; ++k) binomial = binomial * (n - i + k) / k;
+        FLOAT result = binomial;
+        for (int k = 0; k < i; ++k) result *= t;
+        for (int k = 0; k < n - i; ++k) result *= 1 - t;
+        return result;
+    }
+
+    // Point on the Bezier curve with the given control points (scalars,
+    // vectors or points) by de Casteljau's algorithm
+    template<typename Type, std::size_t N>
+    auto constexpr bezier(std::array<Type, N> control, FLOAT t) -> Type {
+        static_assert(N > 0);
+        for (std::size_t level = N - 1; level > 0; --level) {
+            for (std::size_t i = 0; i < level; ++i) control[i] = (1 - t) * control[i] + t * control[i + 1];
+        }
+        return control[0];
+    }
+
+    // The control points of the curve's derivative, a curve of one lower
+    // degree
+    template<typename Type, std::size_t N>
+    auto constexpr bezier_derivative(std::array<Type, N> const& control) -> std::array<decltype(control[1] - control[0]), N - 1> {
+        static_assert(N > 1);
+        std::array<decltype(control[1] - control[0]), N - 1> result{};
+        for (std::size_t i = 0; i + 1 < N; ++i) result[i] = static_cast<FLOAT>(N - 1) * (control[i + 1] - control[i]);
+        return result;
+    }
+
+    // Splits the curve at t into the control points of [0, t] and [t, 1]
+    template<typename Type, std::size_t N>
+    auto constexpr subdivide(std::array<Type, N> control, FLOAT t) -> std::pair<std::array<Type, N>, std::array<Type, N>> {
+        std::array<Type, N> left{}, right{};
+        for (std::size_t level = N; level > 0; --level) {
+            left[N - level] = control[0];
+            right[level - 1] = control[level - 1];
+            for (std::size_t i = 0; i + 1 < level; ++i) control[i] = (1 - t) * control[i] + t * control[i + 1];
+        }
+        return { left, right };
+    }
+}
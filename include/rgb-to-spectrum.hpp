@@ -0,0 +1,327 @@
+#pragma once
+
+#include "spectrum.hpp"
+#include "mapped-file.hpp"
+#include "color3.hpp"
+#include "util.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+namespace gm {
+
+    // Smooth reflectance spectrum sigmoid(c0 * lambda^2 + c1 * lambda + c2), lambda in nm
+    // (Jakob and Hanika 2019)
+    struct RGBSigmoidPolynomial {
+        FLOAT c0, c1, c2;
+
+        static auto sigmoid(FLOAT x) -> FLOAT {
+            if (std::isinf(x)) return x > 0 ? FLOAT(1) : FLOAT(0);
+            return FLOAT(0.5) + x / (2 * std::sqrt(1 + x * x));
+        }
+
+        auto evaluate(FLOAT lambda) const -> FLOAT {
+            return sigmoid((c0 * lambda + c1) * lambda + c2);
+        }
+
+        template<std::size_t N>
+        auto sample(SampledWavelengths<N> const& w) const -> SampledSpectrum<N> {
+            auto s = SampledSpectrum<N>{};
+            for (std::size_t i = 0; i < N; ++i) s[i] = evaluate(w.lambda(i));
+            return s;
+        }
+    };
+
+    // Precomputed coefficients for RGB to reflectance spectrum upsampling, in
+    // the file format of the rgb2spec reference implementation: "SPEC", the
+    // resolution as uint32, `resolution` brightness scale values and
+    // 3 x resolution^3 x 3 coefficients, all native endian float32.
+    // Loaded tables are memory mapped rather than read.
+    class RGBToSpectrumTable {
+    public:
+        RGBToSpectrumTable(RGBToSpectrumTable const&) = delete;
+        auto operator=(RGBToSpectrumTable const&) -> RGBToSpectrumTable& = delete;
+        RGBToSpectrumTable(RGBToSpectrumTable&&) = default;
+        auto operator=(RGBToSpectrumTable&&) -> RGBToSpectrumTable& = default;
+
+        static auto load(std::string const& path) -> std::optional<RGBToSpectrumTable> {
+            auto file = MappedFile::open(path);
+            if (!file || file->size() < header_size) return std::nullopt;
+
+            auto const* bytes = file->data();
+            if (std::memcmp(bytes, "SPEC", 4) != 0) return std::nullopt;
+
+            std::uint32_t resolution;
+            std::memcpy(&resolution, bytes + 4, sizeof(resolution));
+            if (resolution < 2 || resolution > 1024 || file->size() != file_size(resolution)) return std::nullopt;
+
+            auto table = RGBToSpectrumTable{};
+            table.m_resolution = static_cast<int>(resolution);
+            table.m_scale = reinterpret_cast<float const*>(bytes + header_size);
+            table.m_data = table.m_scale + resolution;
+            table.m_file = std::move(file);
+            return table;
+        }
+
+        // Fits the coefficients with Gauss-Newton iterations against the white
+        // balanced linear sRGB response of to_color. Expensive: intended for
+        // offline generation followed by save(), or small resolutions.
+        static auto build(int resolution) -> RGBToSpectrumTable {
+            assert(resolution >= 2);
+            auto const res = static_cast<std::size_t>(resolution);
+
+            auto table = RGBToSpectrumTable{};
+            table.m_resolution = resolution;
+            table.m_owned.resize(res + 9 * res * res * res);
+
+            auto* scale = table.m_owned.data();
+            auto* data = scale + res;
+            for (std::size_t k = 0; k < res; ++k) {
+                scale[k] = static_cast<float>(smoothstep(smoothstep(static_cast<double>(k) / (res - 1))));
+            }
+
+            auto const fitter = Fitter{};
+            auto const start = res / 5;
+
+            for (std::size_t l = 0; l < 3; ++l) {
+                for (std::size_t j = 0; j < res; ++j) {
+                    auto const y = static_cast<double>(j) / (res - 1);
+                    for (std::size_t i = 0; i < res; ++i) {
+                        auto const x = static_cast<double>(i) / (res - 1);
+
+                        auto const target = [&](double z) {
+                            auto rgb = std::array<double, 3>{};
+                            rgb[l] = z;
+                            rgb[(l + 1) % 3] = x * z;
+                            rgb[(l + 2) % 3] = y * z;
+                            return rgb;
+                        };
+
+                        // march away from a well-conditioned brightness, warm
+                        // starting each fit from its neighbour and subdividing
+                        // the step when that is too far away
+                        auto previous_z = 0.0;
+                        auto const fit = [&](std::size_t k, std::array<double, 3>& coefficients) {
+                            auto const z = static_cast<double>(scale[k]);
+                            auto const warm_start = coefficients;
+                            for (int steps = 1; steps <= 16; steps *= 2) {
+                                coefficients = warm_start;
+                                auto converged = true;
+                                for (int step = 1; step <= steps && converged; ++step) {
+                                    converged = fitter.solve(target(lerp(static_cast<double>(step) / steps, previous_z, z)), coefficients);
+                                }
+                                if (converged || k == start) break;
+                            }
+                            previous_z = z;
+
+                            auto const nm = to_nanometers(coefficients);
+                            auto const offset = (((l * res + k) * res + j) * res + i) * 3;
+                            for (std::size_t c = 0; c < 3; ++c) data[offset + c] = static_cast<float>(nm[c]);
+                        };
+
+                        auto coefficients = std::array<double, 3>{};
+                        for (auto k = start; k < res; ++k) fit(k, coefficients);
+
+                        coefficients = {};
+                        previous_z = 0;
+                        fit(start, coefficients);
+                        for (auto k = start; k-- > 0;) fit(k, coefficients);
+                    }
+                }
+            }
+
+            table.m_scale = scale;
+            table.m_data = data;
+            return table;
+        }
+
+        auto save(std::string const& path) const -> bool {
+            auto file = std::ofstream(path, std::ios::binary);
+            if (!file) return false;
+            auto const resolution = static_cast<std::uint32_t>(m_resolution);
+            file.write("SPEC", 4);
+            file.write(reinterpret_cast<char const*>(&resolution), sizeof(resolution));
+            file.write(reinterpret_cast<char const*>(m_scale), static_cast<std::streamsize>(resolution * sizeof(float)));
+            file.write(reinterpret_cast<char const*>(m_data), static_cast<std::streamsize>(coefficient_count() * sizeof(float)));
+            return static_cast<bool>(file);
+        }
+
+        auto resolution() const -> int { return m_resolution; }
+
+        // Coefficients for a reflectance, components are clamped to [0,1]
+        auto operator()(Color3f const& color) const -> RGBSigmoidPolynomial {
+            auto const rgb = std::array<FLOAT, 3>{
+                std::clamp(color.r, FLOAT(0), FLOAT(1)),
+                std::clamp(color.g, FLOAT(0), FLOAT(1)),
+                std::clamp(color.b, FLOAT(0), FLOAT(1)) };
+
+            if (rgb[0] == rgb[1] && rgb[1] == rgb[2]) {
+                // constant spectrum, exact without the table
+                auto const v = rgb[0];
+                return { 0, 0, (v - FLOAT(0.5)) / std::sqrt(v * (1 - v)) };
+            }
+
+            auto const res = m_resolution;
+            auto const l = static_cast<std::size_t>(std::max_element(rgb.begin(), rgb.end()) - rgb.begin());
+            auto const z = rgb[l];
+            auto const x = rgb[(l + 1) % 3] * (res - 1) / z;
+            auto const y = rgb[(l + 2) % 3] * (res - 1) / z;
+
+            auto const xi = std::min(static_cast<int>(x), res - 2);
+            auto const yi = std::min(static_cast<int>(y), res - 2);
+            auto const zi = static_cast<int>(std::clamp<std::ptrdiff_t>(
+                std::upper_bound(m_scale, m_scale + res, static_cast<float>(z)) - m_scale - 1, 0, res - 2));
+
+            auto const x1 = x - xi;
+            auto const y1 = y - yi;
+            auto const z1 = (z - m_scale[zi]) / (m_scale[zi + 1] - m_scale[zi]);
+
+            auto const dx = std::size_t{3};
+            auto const dy = 3 * static_cast<std::size_t>(res);
+            auto const dz = dy * static_cast<std::size_t>(res);
+            auto const offset = (((l * res + zi) * res + yi) * res + xi) * 3;
+
+            FLOAT c[3];
+            for (std::size_t i = 0; i < 3; ++i) {
+                auto const* p = m_data + offset + i;
+                auto const at = [p](std::size_t o) { return static_cast<FLOAT>(p[o]); };
+                c[i] = lerp(z1, lerp(y1, lerp(x1, at(0), at(dx)), lerp(x1, at(dy), at(dy + dx))),
+                                lerp(y1, lerp(x1, at(dz), at(dz + dx)), lerp(x1, at(dz + dy), at(dz + dy + dx))));
+            }
+            return { c[0], c[1], c[2] };
+        }
+
+    private:
+        RGBToSpectrumTable() = default;
+
+        static constexpr std::size_t header_size = 8;
+
+        static auto constexpr file_size(std::size_t res) -> std::size_t {
+            return header_size + sizeof(float) * (res + 9 * res * res * res);
+        }
+
+        auto coefficient_count() const -> std::size_t {
+            auto const res = static_cast<std::size_t>(m_resolution);
+            return 9 * res * res * res;
+        }
+
+        static auto constexpr smoothstep(double x) -> double {
+            return x * x * (3 - 2 * x);
+        }
+
+        // The fit works with wavelengths normalised to [0,1] for conditioning
+        static auto to_nanometers(std::array<double, 3> const& c) -> std::array<double, 3> {
+            auto const c0 = static_cast<double>(constants::lambda_min);
+            auto const c1 = 1 / static_cast<double>(constants::lambda_max - constants::lambda_min);
+            return { c[0] * c1 * c1,
+                     c[1] * c1 - 2 * c[0] * c0 * c1 * c1,
+                     c[2] - c[1] * c0 * c1 + c[0] * c0 * c0 * c1 * c1 };
+        }
+
+        // Gauss-Newton on the linear sRGB residual with an analytic Jacobian
+        class Fitter {
+        public:
+            Fitter() {
+                auto const& white = detail::equal_energy_rgb();
+                for (std::size_t k = 0; k < samples; ++k) {
+                    auto const lambda = constants::lambda_min + (constants::lambda_max - constants::lambda_min) * k / (samples - 1);
+                    // trapezoidal weights
+                    auto const h = static_cast<double>(constants::lambda_max - constants::lambda_min) / (samples - 1);
+                    auto const weight = (k == 0 || k == samples - 1) ? h / 2 : h;
+                    auto const rgb = xyz_to_linear_srgb(cie_xyz(static_cast<FLOAT>(lambda)));
+                    m_lambda[k] = static_cast<double>(k) / (samples - 1);
+                    m_weights[k] = { weight * rgb.r / (constants::cie_y_integral * white.r),
+                                     weight * rgb.g / (constants::cie_y_integral * white.g),
+                                     weight * rgb.b / (constants::cie_y_integral * white.b) };
+                }
+            }
+
+            // Returns false if the target was not reached, `c` then holds the best fit found
+            auto solve(std::array<double, 3> const& target, std::array<double, 3>& c) const -> bool {
+                double r[3], J[3][3];
+                auto error = evaluate(target, c, r, J);
+
+                for (int iteration = 0; iteration < 50; ++iteration) {
+                    if (error < 1e-12) return true;
+
+                    // J * delta = r by Cramer's rule
+                    auto const det = determinant(J);
+                    if (std::abs(det) < 1e-30) return false;
+
+                    double delta[3];
+                    for (std::size_t p = 0; p < 3; ++p) {
+                        double M[3][3];
+                        for (std::size_t i = 0; i < 3; ++i)
+                            for (std::size_t j = 0; j < 3; ++j)
+                                M[i][j] = j == p ? r[i] : J[i][j];
+                        delta[p] = determinant(M) / det;
+                    }
+
+                    // backtracking keeps large warm start steps from diverging
+                    auto step = 1.0;
+                    for (int tries = 0; tries < 20; ++tries, step *= 0.5) {
+                        auto const candidate = std::array<double, 3>{
+                            c[0] - step * delta[0], c[1] - step * delta[1], c[2] - step * delta[2] };
+                        double r_candidate[3], J_candidate[3][3];
+                        auto const candidate_error = evaluate(target, candidate, r_candidate, J_candidate);
+                        if (candidate_error < error) {
+                            c = candidate;
+                            error = candidate_error;
+                            std::copy(r_candidate, r_candidate + 3, r);
+                            std::copy(&J_candidate[0][0], &J_candidate[0][0] + 9, &J[0][0]);
+                            break;
+                        }
+                    }
+                    if (step < 1e-6) return false;
+                }
+                return error < 1e-12;
+            }
+
+        private:
+            // Residual and Jacobian of the fit, returns the squared residual
+            auto evaluate(std::array<double, 3> const& target, std::array<double, 3> const& c,
+                          double (&r)[3], double (&J)[3][3]) const -> double {
+                r[0] = -target[0]; r[1] = -target[1]; r[2] = -target[2];
+                for (auto& row : J) row[0] = row[1] = row[2] = 0;
+
+                for (std::size_t k = 0; k < samples; ++k) {
+                    auto const t = m_lambda[k];
+                    auto const x = (c[0] * t + c[1]) * t + c[2];
+                    auto const root = std::sqrt(1 + x * x);
+                    auto const s = 0.5 + x / (2 * root);
+                    auto const ds = 1 / (2 * root * root * root);
+                    double const dx[3] = { t * t, t, 1 };
+                    for (std::size_t ch = 0; ch < 3; ++ch) {
+                        r[ch] += m_weights[k][ch] * s;
+                        for (std::size_t p = 0; p < 3; ++p) J[ch][p] += m_weights[k][ch] * ds * dx[p];
+                    }
+                }
+                return r[0] * r[0] + r[1] * r[1] + r[2] * r[2];
+            }
+
+            static auto determinant(double const (&M)[3][3]) -> double {
+                return M[0][0] * (M[1][1] * M[2][2] - M[1][2] * M[2][1])
+                     - M[0][1] * (M[1][0] * M[2][2] - M[1][2] * M[2][0])
+                     + M[0][2] * (M[1][0] * M[2][1] - M[1][1] * M[2][0]);
+            }
+
+            static constexpr std::size_t samples = 95;
+            std::array<double, samples> m_lambda{};
+            std::array<std::array<double, 3>, samples> m_weights{};
+        };
+
+        std::optional<MappedFile> m_file;
+        std::vector<float> m_owned;
+        float const* m_scale = nullptr;
+        float const* m_data = nullptr;
+        int m_resolution = 0;
+    };
+}
@@ -0,0 +1,322 @@
+#pragma once
+
+#include "point2.hpp"
+#include "vec3.hpp"
+#include "normal3.hpp"
+#include "onb.hpp"
+#include "util.hpp"
+
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+namespace gm {
+
+    namespace constants {
+        inline constexpr FLOAT one_minus_epsilon = static_cast<FLOAT>(0x1.fffffep-1);
+    };
+
+    namespace detail {
+
+        auto constexpr reverse_bits(std::uint32_t x) -> std::uint32_t {
+            x = (x << 16) | (x >> 16);
+            x = ((x & 0x00ff00ffu) << 8) | ((x & 0xff00ff00u) >> 8);
+            x = ((x & 0x0f0f0f0fu) << 4) | ((x & 0xf0f0f0f0u) >> 4);
+            x = ((x & 0x33333333u) << 2) | ((x & 0xccccccccu) >> 2);
+            x = ((x & 0x55555555u) << 1) | ((x & 0xaaaaaaaau) >> 1);
+            return x;
+        }
+
+        auto constexpr hash(std::uint32_t x) -> std::uint32_t {
+            x ^= x >> 16;
+            x *= 0x7feb352du;
+            x ^= x >> 15;
+            x *= 0x846ca68bu;
+            x ^= x >> 16;
+            return x;
+        }
+
+        // Maps 32 random bits to [0,1)
+        auto constexpr to_unit_float(std::uint32_t bits) -> FLOAT {
+            return std::min(static_cast<FLOAT>(bits) * static_cast<FLOAT>(0x1p-32), constants::one_minus_epsilon);
+        }
+
+        // Hash based nested uniform scrambling (Burley 2020) of a bit-reversed value
+        auto constexpr laine_karras_permutation(std::uint32_t x, std::uint32_t seed) -> std::uint32_t {
+            x += seed;
+            x ^= x * 0x6c50b47cu;
+            x ^= x * 0xb82f1e52u;
+            x ^= x * 0xc7afe638u;
+            x ^= x * 0x8d22f6e6u;
+            return x;
+        }
+
+        auto constexpr nested_uniform_scramble(std::uint32_t x, std::uint32_t seed) -> std::uint32_t {
+            return reverse_bits(laine_karras_permutation(reverse_bits(x), seed));
+        }
+
+        // First two dimensions of the Sobol sequence: van der Corput and the
+        // Pascal matrix generator
+        auto constexpr sobol_dimension_0(std::uint32_t index) -> std::uint32_t {
+            return reverse_bits(index);
+        }
+
+        auto constexpr sobol_dimension_1(std::uint32_t index) -> std::uint32_t {
+            std::uint32_t result = 0;
+            for (std::uint32_t v = 1u << 31; index != 0; index >>= 1, v ^= v >> 1) {
+                if (index & 1) result ^= v;
+            }
+            return result;
+        }
+
+        template<std::uint32_t Base>
+        auto constexpr radical_inverse(std::uint32_t index) -> FLOAT {
+            // dividing by a constant lets the compiler replace the division
+            constexpr auto inv_base = 1.0 / Base;
+            std::uint64_t reversed = 0;
+            double inv_base_n = 1;
+            while (index) {
+                auto const next = index / Base;
+                auto const digit = index - next * Base;
+                reversed = reversed * Base + digit;
+                inv_base_n *= inv_base;
+                index = next;
+            }
+            return std::min(static_cast<FLOAT>(reversed * inv_base_n), constants::one_minus_epsilon);
+        }
+
+        // Small PCG32 generator for sequence construction
+        class Pcg32 {
+        public:
+            constexpr explicit Pcg32(std::uint64_t seed) : m_state(0) {
+                next();
+                m_state += seed;
+                next();
+            }
+
+            auto constexpr next() -> std::uint32_t {
+                auto const old = m_state;
+                m_state = old * 6364136223846793005ull + 1442695040888963407ull;
+                auto const shifted = static_cast<std::uint32_t>(((old >> 18u) ^ old) >> 27u);
+                auto const rot = static_cast<std::uint32_t>(old >> 59u);
+                return (shifted >> rot) | (shifted << ((~rot + 1u) & 31));
+            }
+
+            auto constexpr uniform() -> FLOAT { return to_unit_float(next()); }
+
+            // Uniform integer in [0, bound)
+            auto constexpr uniform(std::uint32_t bound) -> std::uint32_t {
+                return static_cast<std::uint32_t>((static_cast<std::uint64_t>(next()) * bound) >> 32);
+            }
+
+        private:
+            std::uint64_t m_state;
+        };
+    }
+
+    // Sobol (0,2)-sequence, Owen scrambled unless seed is 0
+    inline auto sobol_2d(std::uint32_t index, std::uint32_t seed = 0) -> Point2f {
+        if (seed == 0) {
+            return { detail::to_unit_float(detail::sobol_dimension_0(index)),
+                     detail::to_unit_float(detail::sobol_dimension_1(index)) };
+        }
+        auto const x = detail::nested_uniform_scramble(detail::sobol_dimension_0(index), detail::hash(seed));
+        auto const y = detail::nested_uniform_scramble(detail::sobol_dimension_1(index), detail::hash(seed ^ 0x9e3779b9u));
+        return { detail::to_unit_float(x), detail::to_unit_float(y) };
+    }
+
+    inline auto sobol_2d(std::uint32_t first, std::size_t count, Point2f* out, std::uint32_t seed = 0) -> void {
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] = sobol_2d(first + static_cast<std::uint32_t>(i), seed);
+        }
+    }
+
+    // Halton sequence in bases 2 and 3
+    inline auto halton_2d(std::uint32_t index) -> Point2f {
+        return { detail::to_unit_float(detail::reverse_bits(index)), detail::radical_inverse<3>(index) };
+    }
+
+    inline auto halton_2d(std::uint32_t first, std::size_t count, Point2f* out) -> void {
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] = halton_2d(first + static_cast<std::uint32_t>(i));
+        }
+    }
+
+    // Progressive multi-jittered (0,2) sequence (Christensen et al. 2018). Every
+    // power of two prefix is stratified in all base 2 elementary intervals.
+    // Construction is quadratic in the count, so generate tables once and reuse them.
+    inline auto pmj02(std::size_t count, std::uint32_t seed = 0) -> std::vector<Point2f> {
+
+        // Occupancy of all 2^a x 2^(k-a) elementary interval shapes for 2^k samples
+        struct Strata {
+            int k = 0;
+            std::vector<std::vector<bool>> occupied;
+
+            auto reset(int log2_count, std::vector<Point2f> const& samples) -> void {
+                k = log2_count;
+                occupied.assign(k + 1, std::vector<bool>(std::size_t{1} << k, false));
+                for (auto const& s : samples) mark(s);
+            }
+
+            auto cell(int a, std::uint32_t column, std::uint32_t row) const -> std::size_t {
+                // column/row at the finest resolution 2^k
+                return (static_cast<std::size_t>(row >> a) << a) | (column >> (k - a));
+            }
+
+            auto mark(Point2f const& p) -> void {
+                auto const n = static_cast<FLOAT>(std::uint32_t{1} << k);
+                auto const column = static_cast<std::uint32_t>(p.x * n);
+                auto const row = static_cast<std::uint32_t>(p.y * n);
+                for (int a = 0; a <= k; ++a) occupied[a][cell(a, column, row)] = true;
+            }
+
+            auto is_free(std::uint32_t column, std::uint32_t row) const -> bool {
+                for (int a = 0; a <= k; ++a) {
+                    if (occupied[a][cell(a, column, row)]) return false;
+                }
+                return true;
+            }
+        };
+
+        for (std::uint32_t attempt = 0;; ++attempt) {
+            auto rng = detail::Pcg32(detail::hash(seed) + (static_cast<std::uint64_t>(attempt) << 32));
+            auto samples = std::vector<Point2f>{};
+            samples.reserve(count);
+            samples.push_back({ rng.uniform(), rng.uniform() });
+
+            auto strata = Strata{};
+            auto failed = false;
+
+            // Places a sample in the given quadrant of cell (x, y) of an n x n grid,
+            // picking uniformly among the finest cells that keep the prefix (0,2)
+            auto const generate = [&](std::uint32_t x, std::uint32_t y, std::uint32_t x_half, std::uint32_t y_half, std::uint32_t n) {
+                auto const resolution = std::uint32_t{1} << strata.k;
+                auto const span = resolution / (2 * n);
+                auto const first_column = (2 * x + x_half) * span;
+                auto const first_row = (2 * y + y_half) * span;
+
+                std::uint32_t found = 0, column = 0, row = 0;
+                for (auto c = first_column; c < first_column + span; ++c) {
+                    for (auto r = first_row; r < first_row + span; ++r) {
+                        if (strata.is_free(c, r) && rng.uniform(++found) == 0) {
+                            column = c;
+                            row = r;
+                        }
+                    }
+                }
+                if (found == 0) {
+                    failed = true;
+                    return;
+                }
+
+                auto const inv_resolution = 1 / static_cast<FLOAT>(resolution);
+                auto const sample = Point2f{
+                    std::min((column + rng.uniform()) * inv_resolution, constants::one_minus_epsilon),
+                    std::min((row + rng.uniform()) * inv_resolution, constants::one_minus_epsilon) };
+                strata.mark(sample);
+                samples.push_back(sample);
+            };
+
+            auto const quadrant = [](Point2f const& p, std::uint32_t n) {
+                auto const x = static_cast<std::uint32_t>(p.x * 2 * n);
+                auto const y = static_cast<std::uint32_t>(p.y * 2 * n);
+                return std::make_tuple(x / 2, y / 2, x & 1, y & 1);
+            };
+
+            int log2_n = 0;
+            for (std::size_t N = 1; N < count && !failed; N *= 4, ++log2_n) {
+                auto const n = std::uint32_t{1} << log2_n;
+
+                // N -> 2N: the diagonally opposite quadrant of each existing sample
+                strata.reset(2 * log2_n + 1, samples);
+                for (std::size_t i = 0; i < N && samples.size() < count && !failed; ++i) {
+                    auto const [x, y, x_half, y_half] = quadrant(samples[i], n);
+                    generate(x, y, 1 - x_half, 1 - y_half, n);
+                }
+
+                // 2N -> 4N: the two remaining quadrants, choosing randomly which is filled first
+                strata.reset(2 * log2_n + 2, samples);
+                std::vector<std::uint32_t> flip_x(N);
+                for (std::size_t i = 0; i < N && samples.size() < count && !failed; ++i) {
+                    auto const [x, y, x_half, y_half] = quadrant(samples[i], n);
+                    flip_x[i] = rng.uniform(2);
+                    generate(x, y, flip_x[i] ? 1 - x_half : x_half, flip_x[i] ? y_half : 1 - y_half, n);
+                }
+                for (std::size_t i = 0; i < N && samples.size() < count && !failed; ++i) {
+                    auto const [x, y, x_half, y_half] = quadrant(samples[i], n);
+                    generate(x, y, flip_x[i] ? x_half : 1 - x_half, flip_x[i] ? 1 - y_half : y_half, n);
+                }
+            }
+
+            if (!failed) {
+                samples.resize(count);
+                return samples;
+            }
+        }
+    }
+
+    // Warps from [0,1)^2. Local frames have z as the up axis.
+
+    inline auto sample_concentric_disk(Point2f const& u) -> Point2f {
+        auto const a = 2 * u.x - 1;
+        auto const b = 2 * u.y - 1;
+        auto const use_a = std::abs(a) > std::abs(b);
+        // selects rather than branches so batch loops vectorize
+        auto const r = use_a ? a : b;
+        auto const num = use_a ? b : a;
+        auto const den = r == 0 ? FLOAT(1) : r;
+        auto const phi = use_a ? constants::pi / 4 * (num / den) : constants::pi / 2 - constants::pi / 4 * (num / den);
+        return { r * std::cos(phi), r * std::sin(phi) };
+    }
+
+    inline auto sample_uniform_sphere(Point2f const& u) -> Vec3f {
+        auto const z = 1 - 2 * u.x;
+        auto const r = std::sqrt(std::max(FLOAT(0), 1 - z * z));
+        auto const phi = 2 * constants::pi * u.y;
+        return { r * std::cos(phi), r * std::sin(phi), z };
+    }
+
+    inline auto sample_cosine_hemisphere(Point2f const& u) -> Vec3f {
+        auto const d = sample_concentric_disk(u);
+        auto const z = std::sqrt(std::max(FLOAT(0), 1 - d.x * d.x - d.y * d.y));
+        return { d.x, d.y, z };
+    }
+
+    // GGX distribution of visible normals via spherical caps (Dupuy and Benyoub 2023).
+    // `wo` is in the local frame and must lie in the upper hemisphere.
+    inline auto sample_ggx_vndf(Vec3f const& wo, FLOAT alpha_x, FLOAT alpha_y, Point2f const& u) -> Normal3f {
+        auto const wh = static_cast<Vec3f>(Vec3f{ alpha_x * wo.x, alpha_y * wo.y, wo.z }.normalise());
+        auto const phi = 2 * constants::pi * u.x;
+        auto const z = (1 - u.y) * (1 + wh.z) - wh.z;
+        auto const sin_theta = std::sqrt(std::clamp(1 - z * z, FLOAT(0), FLOAT(1)));
+        auto const h = Vec3f{ sin_theta * std::cos(phi) + wh.x, sin_theta * std::sin(phi) + wh.y, z + wh.z };
+        return Vec3f{ alpha_x * h.x, alpha_y * h.y, std::max(FLOAT(0), h.z) }.normalise();
+    }
+
+    inline auto uniform_sphere_pdf() -> FLOAT { return constants::inv_pi / 4; }
+    inline auto cosine_hemisphere_pdf(FLOAT cos_theta) -> FLOAT { return cos_theta * constants::inv_pi; }
+
+    // Batched warps. With a frame the directions are returned in world space.
+
+    inline auto sample_concentric_disk(Point2f const* u, Point2f* out, std::size_t count) -> void {
+        for (std::size_t i = 0; i < count; ++i) out[i] = sample_concentric_disk(u[i]);
+    }
+
+    inline auto sample_uniform_sphere(Point2f const* u, Vec3f* out, std::size_t count) -> void {
+        for (std::size_t i = 0; i < count; ++i) out[i] = sample_uniform_sphere(u[i]);
+    }
+
+    inline auto sample_cosine_hemisphere(Point2f const* u, Vec3f* out, std::size_t count) -> void {
+        for (std::size_t i = 0; i < count; ++i) out[i] = sample_cosine_hemisphere(u[i]);
+    }
+
+    inline auto sample_cosine_hemisphere(Point2f const* u, ONB const& frame, Vec3f* out, std::size_t count) -> void {
+        for (std::size_t i = 0; i < count; ++i) out[i] = frame.convert_to_local(sample_cosine_hemisphere(u[i]));
+    }
+
+    inline auto sample_ggx_vndf(Vec3f const& wo, FLOAT alpha_x, FLOAT alpha_y,
+                                Point2f const* u, Normal3f* out, std::size_t count) -> void {
+        for (std::size_t i = 0; i < count; ++i) out[i] = sample_ggx_vndf(wo, alpha_x, alpha_y, u[i]);
+    }
+}
@@ -0,0 +1,220 @@
+#pragma once
+
+#include "matrix4x4.hpp"
+#include "transform.hpp"
+#include "point3.hpp"
+#include "normal3.hpp"
+#include "vec3.hpp"
+#include "color3.hpp"
+#include "mapped-file.hpp"
+#include "span.hpp"
+#include "util.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <algorithm>
+
+namespace gm {
+
+    // Binary array files: a 64 byte little-endian header followed by the
+    // elements, so the payload is aligned for SIMD loads when memory mapped.
+    //
+    //   0  "GMBA"
+    //   4  uint16 format version
+    //   6  uint16 element type (SerializedType)
+    //   8  uint16 scalar size in bytes
+    //  10  uint16 reserved, zero
+    //  12  uint32 element size in bytes
+    //  16  uint64 element count
+    //  24  zero padding up to 64
+    //
+    // Elements are stored as their little-endian scalar components in
+    // declaration order; a Transform is its matrix followed by its inverse.
+    enum class SerializedType : std::uint16_t {
+        matrix4x4 = 1,
+        transform = 2,
+        point3 = 3,
+        normal3 = 4,
+        vec3 = 5,
+        color3 = 6
+    };
+
+    namespace constants {
+        inline constexpr std::uint16_t binary_format_version = 1;
+    };
+
+    namespace detail {
+        template<typename>
+        struct serialized_type;
+
+        template<> struct serialized_type<Matrix4x4f> { static constexpr auto value = SerializedType::matrix4x4; static constexpr std::size_t scalars = 16; };
+        template<> struct serialized_type<Transform> { static constexpr auto value = SerializedType::transform; static constexpr std::size_t scalars = 32; };
+        template<> struct serialized_type<Point3f> { static constexpr auto value = SerializedType::point3; static constexpr std::size_t scalars = 3; };
+        template<> struct serialized_type<Normal3f> { static constexpr auto value = SerializedType::normal3; static constexpr std::size_t scalars = 3; };
+        template<> struct serialized_type<Vec3f> { static constexpr auto value = SerializedType::vec3; static constexpr std::size_t scalars = 3; };
+        template<> struct serialized_type<Color3f> { static constexpr auto value = SerializedType::color3; static constexpr std::size_t scalars = 3; };
+
+        // Only types whose in-memory layout is exactly their scalars can be mapped
+        template<typename Type>
+        auto constexpr is_serializable() -> bool {
+            return std::is_trivially_copyable_v<Type>
+                && sizeof(Type) == serialized_type<Type>::scalars * sizeof(FLOAT);
+        }
+
+        inline constexpr std::size_t binary_header_size = 64;
+
+        auto constexpr is_little_endian() -> bool {
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__)
+            return __BYTE_ORDER__ != __ORDER_BIG_ENDIAN__;
+#else
+            return true;
+#endif
+        }
+
+        template<typename Integer>
+        auto store_le(unsigned char* out, Integer value) -> void {
+            for (std::size_t i = 0; i < sizeof(Integer); ++i) {
+                out[i] = static_cast<unsigned char>(static_cast<std::uint64_t>(value) >> (8 * i));
+            }
+        }
+
+        template<typename Integer>
+        auto load_le(unsigned char const* in) -> Integer {
+            std::uint64_t value = 0;
+            for (std::size_t i = 0; i < sizeof(Integer); ++i) {
+                value |= static_cast<std::uint64_t>(in[i]) << (8 * i);
+            }
+            return static_cast<Integer>(value);
+        }
+
+        // Reverses the bytes of every scalar, only needed on big-endian hosts
+        inline auto swap_scalars(unsigned char* bytes, std::size_t size) -> void {
+            for (std::size_t i = 0; i + sizeof(FLOAT) <= size; i += sizeof(FLOAT)) {
+                std::reverse(bytes + i, bytes + i + sizeof(FLOAT));
+            }
+        }
+    }
+
+    // Streams elements to a binary array file. The element count in the header
+    // is patched by close(), which the destructor calls.
+    template<typename Type>
+    class BinaryWriter {
+        static_assert(detail::is_serializable<Type>());
+    public:
+        BinaryWriter(BinaryWriter&&) = default;
+        auto operator=(BinaryWriter&&) -> BinaryWriter& = default;
+        ~BinaryWriter() { close(); }
+
+        static auto open(std::string const& path) -> std::optional<BinaryWriter> {
+            auto writer = BinaryWriter{ std::ofstream(path, std::ios::binary | std::ios::trunc) };
+            if (!writer.m_file || !writer.write_header()) return std::nullopt;
+            return writer;
+        }
+
+        auto write(Type const* elements, std::size_t count) -> bool {
+            if (!m_file) return false;
+            if constexpr (detail::is_little_endian()) {
+                m_file.write(reinterpret_cast<char const*>(elements), static_cast<std::streamsize>(count * sizeof(Type)));
+            } else {
+                for (std::size_t i = 0; i < count; ++i) {
+                    unsigned char bytes[sizeof(Type)];
+                    std::memcpy(bytes, &elements[i], sizeof(Type));
+                    detail::swap_scalars(bytes, sizeof(Type));
+                    m_file.write(reinterpret_cast<char const*>(bytes), sizeof(Type));
+                }
+            }
+            m_count += count;
+            return static_cast<bool>(m_file);
+        }
+
+        auto write(Span<Type const> elements) -> bool {
+            return write(elements.data(), elements.size());
+        }
+
+        auto count() const -> std::uint64_t { return m_count; }
+
+        auto close() -> bool {
+            if (!m_file.is_open()) return true;
+            auto const ok = write_header() && static_cast<bool>(m_file.flush());
+            m_file.close();
+            return ok;
+        }
+
+    private:
+        explicit BinaryWriter(std::ofstream&& file) : m_file(std::move(file)), m_count(0) { }
+
+        auto write_header() -> bool {
+            unsigned char header[detail::binary_header_size] = {};
+            std::memcpy(header, "GMBA", 4);
+            detail::store_le<std::uint16_t>(header + 4, constants::binary_format_version);
+            detail::store_le<std::uint16_t>(header + 6, static_cast<std::uint16_t>(detail::serialized_type<Type>::value));
+            detail::store_le<std::uint16_t>(header + 8, sizeof(FLOAT));
+            detail::store_le<std::uint32_t>(header + 12, sizeof(Type));
+            detail::store_le<std::uint64_t>(header + 16, m_count);
+
+            auto const end = m_file.tellp();
+            m_file.seekp(0);
+            m_file.write(reinterpret_cast<char const*>(header), sizeof(header));
+            if (end > static_cast<std::streamoff>(sizeof(header))) m_file.seekp(end);
+            return static_cast<bool>(m_file);
+        }
+
+        std::ofstream m_file;
+        std::uint64_t m_count;
+    };
+
+    // Memory maps a binary array file and hands out the elements in place.
+    // On big-endian hosts the elements are copied and byte swapped instead.
+    template<typename Type>
+    class BinaryReader {
+        static_assert(detail::is_serializable<Type>());
+    public:
+        static auto open(std::string const& path) -> std::optional<BinaryReader> {
+            auto file = MappedFile::open(path);
+            if (!file || file->size() < detail::binary_header_size) return std::nullopt;
+
+            auto const* header = reinterpret_cast<unsigned char const*>(file->data());
+            if (std::memcmp(header, "GMBA", 4) != 0
+                || detail::load_le<std::uint16_t>(header + 4) != constants::binary_format_version
+                || detail::load_le<std::uint16_t>(header + 6) != static_cast<std::uint16_t>(detail::serialized_type<Type>::value)
+                || detail::load_le<std::uint16_t>(header + 8) != sizeof(FLOAT)
+                || detail::load_le<std::uint32_t>(header + 12) != sizeof(Type)) {
+                return std::nullopt;
+            }
+
+            auto const count = detail::load_le<std::uint64_t>(header + 16);
+            if ((file->size() - detail::binary_header_size) / sizeof(Type) < count) return std::nullopt;
+
+            auto reader = BinaryReader{};
+            reader.m_count = static_cast<std::size_t>(count);
+            auto const* payload = file->data() + detail::binary_header_size;
+            if constexpr (detail::is_little_endian()) {
+                reader.m_elements = reinterpret_cast<Type const*>(payload);
+            } else {
+                reader.m_swapped.resize(reader.m_count * sizeof(Type));
+                std::memcpy(reader.m_swapped.data(), payload, reader.m_swapped.size());
+                detail::swap_scalars(reader.m_swapped.data(), reader.m_swapped.size());
+                reader.m_elements = reinterpret_cast<Type const*>(reader.m_swapped.data());
+            }
+            reader.m_file = std::move(file);
+            return reader;
+        }
+
+        auto elements() const -> Span<Type const> { return { m_elements, m_count }; }
+        auto size() const -> std::size_t { return m_count; }
+
+    private:
+        BinaryReader() = default;
+
+        std::optional<MappedFile> m_file;
+        std::vector<unsigned char> m_swapped;
+        Type const* m_elements = nullptr;
+        std::size_t m_count = 0;
+    };
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "util.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace gm {
+
+    // Non-owning view of contiguous elements (std::span is C++20)
+    template<typename Type>
+    class Span {
+    public:
+        constexpr Span() : m_data(nullptr), m_size(0) { }
+        constexpr Span(Type* data, std::size_t size) : m_data(data), m_size(size) { }
+
+        template<typename Element, REQUIRES(std::is_convertible_v<Element(*)[], Type(*)[]>)>
+        Span(std::vector<Element>& v) : m_data(v.data()), m_size(v.size()) { }
+
+        template<typename Element, REQUIRES(std::is_convertible_v<Element const(*)[], Type(*)[]>)>
+        Span(std::vector<Element> const& v) : m_data(v.data()), m_size(v.size()) { }
+
+        auto constexpr data() const -> Type* { return m_data; }
+        auto constexpr size() const -> std::size_t { return m_size; }
+        auto constexpr empty() const -> bool { return m_size == 0; }
+
+        auto constexpr begin() const -> Type* { return m_data; }
+        auto constexpr end() const -> Type* { return m_data + m_size; }
+
+        auto constexpr operator[](std::size_t index) const -> Type& {
+            assert(index < m_size);
+            return m_data[index];
+        }
+
+        auto constexpr subspan(std::size_t offset, std::size_t count) const -> Span<Type> {
+            assert(offset + count <= m_size);
+            return { m_data + offset, count };
+        }
+
+    private:
+        Type* m_data;
+        std::size_t m_size;
+    };
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "grid.hpp"
+#include "parallel.hpp"
+#include "point3.hpp"
+#include "span.hpp"
+#include "util.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+#include <algorithm>
+
+namespace gm {
+
+    // Axis aligned bounds of the points, computed in parallel
+    inline auto bounds(Span<Point3f const> points) -> std::pair<Point3f, Point3f> {
+        auto const chunks = chunk_count(points.size());
+        std::vector<std::pair<Point3f, Point3f>> partial(chunks, { Point3f{ constants::max_float }, Point3f{ constants::min_float } });
+        parallel_chunks(points.size(), chunks, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+            auto [lo, hi] = partial[chunk];
+            for (auto i = begin; i < end; ++i) {
+                lo = elementwise_min(lo, points[i]);
+                hi = elementwise_max(hi, points[i]);
+            }
+            partial[chunk] = { lo, hi };
+        });
+        for (std::size_t i = 1; i < chunks; ++i) {
+            partial[0] = { elementwise_min(partial[0].first, partial[i].first), elementwise_max(partial[0].second, partial[i].second) };
+        }
+        return partial[0];
+    }
+
+    // Quantises the points to 21 bits per axis within [min, max] and writes
+    // their 63 bit Morton codes
+    inline auto morton_codes(Span<Point3f const> points, Point3f const& min, Point3f const& max, std::uint64_t* codes) -> void {
+        auto constexpr cells = 1 << 21;
+        auto const scale = [](FLOAT lo, FLOAT hi) { return hi > lo ? cells / (hi - lo) : FLOAT(0); };
+        auto const sx = scale(min.x, max.x), sy = scale(min.y, max.y), sz = scale(min.z, max.z);
+        // offsets are non-negative, so truncation is the floor; NaN maps to 0
+        auto const quantise = [](FLOAT x) {
+            return static_cast<int>(std::min(std::max(FLOAT(0), x), FLOAT(cells - 1)));
+        };
+        parallel_for(points.size(), [&](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i) {
+                auto const& p = points[i];
+                codes[i] = morton_encode(Point3i{ quantise((p.x - min.x) * sx), quantise((p.y - min.y) * sy), quantise((p.z - min.z) * sz) });
+            }
+        });
+    }
+
+    // Stable LSD radix sort of key/value pairs on the low `key_bits` bits,
+    // 8 bits per pass. Each pass histograms and scatters fixed chunks in
+    // parallel; passes where every key has the same digit are skipped.
+    inline auto radix_sort(std::uint64_t* keys, std::uint32_t* values, std::size_t count, int key_bits = 64) -> void {
+        assert(key_bits > 0 && key_bits <= 64);
+        auto constexpr radix = 256;
+        using Histogram = std::array<std::size_t, radix>;
+
+        std::vector<std::uint64_t> key_buffer(count);
+        std::vector<std::uint32_t> value_buffer(count);
+        auto* src_keys = keys;
+        auto* src_values = values;
+        auto* dst_keys = key_buffer.data();
+        auto* dst_values = value_buffer.data();
+
+        auto const chunks = chunk_count(count);
+        std::vector<Histogram> offsets(chunks);
+
+        for (int shift = 0; shift < key_bits; shift += 8) {
+            parallel_chunks(count, chunks, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+                auto& histogram = offsets[chunk];
+                histogram.fill(0);
+                for (auto i = begin; i < end; ++i) ++histogram[(src_keys[i] >> shift) & (radix - 1)];
+            });
+
+            // digit major, chunk minor exclusive prefix sum keeps the sort stable
+            auto sum = std::size_t(0);
+            auto skip = false;
+            for (int digit = 0; digit < radix; ++digit) {
+                auto const start = sum;
+                for (auto& histogram : offsets) {
+                    auto const n = histogram[digit];
+                    histogram[digit] = sum;
+                    sum += n;
+                }
+                skip |= sum - start == count;
+            }
+            if (skip) continue;
+
+            parallel_chunks(count, chunks, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+                // stage a few pairs per digit and write them out together, far
+                // fewer cache lines are open at once than with direct scatter
+                auto constexpr staged = 16;
+                struct Stage {
+                    std::uint64_t keys[staged];
+                    std::uint32_t values[staged];
+                };
+                std::vector<Stage> stages(radix);
+                std::array<std::uint8_t, radix> fill{};
+
+                auto& offset = offsets[chunk];
+                for (auto i = begin; i < end; ++i) {
+                    auto const digit = (src_keys[i] >> shift) & (radix - 1);
+                    auto& stage = stages[digit];
+                    auto n = fill[digit];
+                    stage.keys[n] = src_keys[i];
+                    stage.values[n] = src_values[i];
+                    if (++n == staged) {
+                        std::copy(stage.keys, stage.keys + staged, dst_keys + offset[digit]);
+                        std::copy(stage.values, stage.values + staged, dst_values + offset[digit]);
+                        offset[digit] += staged;
+                        n = 0;
+                    }
+                    fill[digit] = n;
+                }
+                for (int digit = 0; digit < radix; ++digit) {
+                    auto const& stage = stages[digit];
+                    std::copy(stage.keys, stage.keys + fill[digit], dst_keys + offset[digit]);
+                    std::copy(stage.values, stage.values + fill[digit], dst_values + offset[digit]);
+                }
+            });
+            std::swap(src_keys, dst_keys);
+            std::swap(src_values, dst_values);
+        }
+
+        if (src_keys != keys) {
+            parallel_for(count, [&](std::size_t begin, std::size_t end) {
+                std::copy(src_keys + begin, src_keys + end, keys + begin);
+                std::copy(src_values + begin, src_values + end, values + begin);
+            });
+        }
+    }
+
+    // Permutation that orders the points along a Morton curve over their
+    // bounds. Reorder any per-point payload with gather().
+    inline auto morton_sort(Span<Point3f const> points) -> std::vector<std::uint32_t> {
+        assert(points.size() <= std::numeric_limits<std::uint32_t>::max());
+        auto const [min, max] = bounds(points);
+        std::vector<std::uint64_t> codes(points.size());
+        morton_codes(points, min, max, codes.data());
+
+        std::vector<std::uint32_t> permutation(points.size());
+        parallel_for(points.size(), [&](std::size_t begin, std::size_t end) {
+            std::iota(permutation.begin() + begin, permutation.begin() + end, static_cast<std::uint32_t>(begin));
+        });
+        radix_sort(codes.data(), permutation.data(), codes.size(), 63);
+        return permutation;
+    }
+
+    // out[i] = in[permutation[i]]
+    template<typename Type>
+    auto gather(Type const* in, Span<std::uint32_t const> permutation, Type* out) -> void {
+        parallel_for(permutation.size(), [&](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i) out[i] = in[permutation[i]];
+        });
+    }
+}
@@ -0,0 +1,310 @@
+#pragma once
+
+#include "color3.hpp"
+#include "dispatch.hpp"
+#include "span.hpp"
+#include "vec3.hpp"
+#include "util.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <ostream>
+#include <algorithm>
+
+namespace gm {
+
+    namespace constants {
+        inline constexpr FLOAT lambda_min = 360;
+        inline constexpr FLOAT lambda_max = 830;
+        // integral of the CIE y matching function over [lambda_min, lambda_max]
+        inline constexpr FLOAT cie_y_integral = static_cast<FLOAT>(106.856895);
+    };
+
+    namespace detail {
+        auto constexpr spectrum_alignment(std::size_t n) -> std::size_t {
+            auto const bytes = n * sizeof(FLOAT);
+            if (bytes % 32 == 0) return 32;
+            if (bytes % 16 == 0) return 16;
+            return alignof(FLOAT);
+        }
+    }
+
+    // Spectral radiance at N wavelengths, see SampledWavelengths. Aligned so
+    // N = 4 or 8 maps onto SSE/AVX registers.
+    template<std::size_t N>
+    class alignas(detail::spectrum_alignment(N)) SampledSpectrum {
+    public:
+        constexpr SampledSpectrum() : m_values{} { }
+        constexpr explicit SampledSpectrum(FLOAT val) : m_values{} {
+            for (std::size_t i = 0; i < N; ++i) m_values[i] = val;
+        }
+        constexpr explicit SampledSpectrum(std::array<FLOAT, N> const& values) : m_values(values) { }
+
+        auto static constexpr black() -> SampledSpectrum { return SampledSpectrum{0}; }
+        auto static constexpr size() -> std::size_t { return N; }
+
+        auto constexpr operator[](std::size_t i) const -> FLOAT { return m_values[i]; }
+        auto constexpr operator[](std::size_t i) -> FLOAT& { return m_values[i]; }
+
+        auto constexpr operator==(SampledSpectrum<N> const& other) const -> bool {
+            for (std::size_t i = 0; i < N; ++i) {
+                if (gcem::abs(m_values[i] - other.m_values[i]) > constants::epsilon) return false;
+            }
+            return true;
+        }
+
+        auto constexpr operator!=(SampledSpectrum<N> const& other) const -> bool {
+            return !(*this == other);
+        }
+
+        auto constexpr operator*(FLOAT factor) const -> SampledSpectrum<N> {
+            auto result = *this;
+            return result *= factor;
+        }
+
+        auto constexpr operator*=(FLOAT factor) -> SampledSpectrum<N>& {
+            for (std::size_t i = 0; i < N; ++i) m_values[i] *= factor;
+            return *this;
+        }
+
+        auto constexpr operator/(FLOAT factor) const -> SampledSpectrum<N> {
+            auto result = *this;
+            return result /= factor;
+        }
+
+        auto constexpr operator/=(FLOAT factor) -> SampledSpectrum<N>& {
+            for (std::size_t i = 0; i < N; ++i) m_values[i] /= factor;
+            return *this;
+        }
+
+        auto constexpr operator+(SampledSpectrum<N> const& other) const -> SampledSpectrum<N> {
+            auto result = *this;
+            return result += other;
+        }
+
+        auto constexpr operator+=(SampledSpectrum<N> const& other) -> SampledSpectrum<N>& {
+            for (std::size_t i = 0; i < N; ++i) m_values[i] += other.m_values[i];
+            return *this;
+        }
+
+        auto constexpr operator-(SampledSpectrum<N> const& other) const -> SampledSpectrum<N> {
+            auto result = *this;
+            return result -= other;
+        }
+
+        auto constexpr operator-=(SampledSpectrum<N> const& other) -> SampledSpectrum<N>& {
+            for (std::size_t i = 0; i < N; ++i) m_values[i] -= other.m_values[i];
+            return *this;
+        }
+
+        auto constexpr operator*(SampledSpectrum<N> const& other) const -> SampledSpectrum<N> {
+            auto result = *this;
+            return result *= other;
+        }
+
+        auto constexpr operator*=(SampledSpectrum<N> const& other) -> SampledSpectrum<N>& {
+            for (std::size_t i = 0; i < N; ++i) m_values[i] *= other.m_values[i];
+            return *this;
+        }
+
+        // Division by zero yields zero, for dividing by pdfs
+        auto constexpr operator/(SampledSpectrum<N> const& other) const -> SampledSpectrum<N> {
+            auto result = *this;
+            for (std::size_t i = 0; i < N; ++i) {
+                result.m_values[i] = other.m_values[i] != 0 ? m_values[i] / other.m_values[i] : 0;
+            }
+            return result;
+        }
+
+        auto constexpr is_black() const -> bool {
+            for (std::size_t i = 0; i < N; ++i) {
+                if (m_values[i] != 0) return false;
+            }
+            return true;
+        }
+
+        auto constexpr clamp() -> void {
+            for (std::size_t i = 0; i < N; ++i) m_values[i] = std::clamp(m_values[i], FLOAT(0), FLOAT(1));
+        }
+
+        auto constexpr average() const -> FLOAT {
+            auto sum = FLOAT(0);
+            for (std::size_t i = 0; i < N; ++i) sum += m_values[i];
+            return sum / N;
+        }
+
+        auto constexpr max_value() const -> FLOAT {
+            auto result = m_values[0];
+            for (std::size_t i = 1; i < N; ++i) result = std::max(result, m_values[i]);
+            return result;
+        }
+
+        auto friend operator<<(std::ostream &os, SampledSpectrum<N> const& s) -> std::ostream & {
+            os << '(';
+            for (std::size_t i = 0; i < N; ++i) os << (i == 0 ? "" : ",") << s.m_values[i];
+            os << ')' << '\n';
+            return os;
+        }
+
+    private:
+        std::array<FLOAT, N> m_values;
+    };
+
+    template<std::size_t N>
+    auto constexpr operator*(FLOAT factor, SampledSpectrum<N> const& s) -> SampledSpectrum<N> {
+        return s * factor;
+    }
+
+    template<std::size_t N>
+    auto constexpr lerp(FLOAT t, SampledSpectrum<N> const& s1, SampledSpectrum<N> const& s2) -> SampledSpectrum<N> {
+        return (1 - t) * s1 + t * s2;
+    }
+
+    // The N wavelengths (in nm) a SampledSpectrum is defined at, with their sampling pdfs
+    template<std::size_t N>
+    class SampledWavelengths {
+    public:
+        // Stratified uniform sampling of [lambda_min, lambda_max]
+        static auto sample_uniform(FLOAT u) -> SampledWavelengths {
+            auto w = SampledWavelengths{};
+            auto const range = constants::lambda_max - constants::lambda_min;
+            for (std::size_t i = 0; i < N; ++i) {
+                auto const up = stratum(u, i);
+                w.m_lambda[i] = lerp(up, constants::lambda_min, constants::lambda_max);
+                w.m_pdf[i] = 1 / range;
+            }
+            return w;
+        }
+
+        // Stratified sampling proportional to the visual response (Pharr et al.)
+        static auto sample_visible(FLOAT u) -> SampledWavelengths {
+            auto w = SampledWavelengths{};
+            for (std::size_t i = 0; i < N; ++i) {
+                auto const up = stratum(u, i);
+                w.m_lambda[i] = static_cast<FLOAT>(538 - 138.888889 * std::atanh(0.85691062 - 1.82750197 * up));
+                w.m_pdf[i] = visible_pdf(w.m_lambda[i]);
+            }
+            return w;
+        }
+
+        static auto visible_pdf(FLOAT lambda) -> FLOAT {
+            if (lambda < constants::lambda_min || lambda > constants::lambda_max) return 0;
+            auto const c = std::cosh(FLOAT(0.0072) * (lambda - 538));
+            return FLOAT(0.0039398042) / (c * c);
+        }
+
+        auto constexpr lambda(std::size_t i) const -> FLOAT { return m_lambda[i]; }
+        auto constexpr pdf(std::size_t i) const -> FLOAT { return m_pdf[i]; }
+        auto constexpr pdf() const -> SampledSpectrum<N> { return SampledSpectrum<N>{ m_pdf }; }
+
+    private:
+        static auto stratum(FLOAT u, std::size_t i) -> FLOAT {
+            auto const up = u + static_cast<FLOAT>(i) / N;
+            return up >= 1 ? up - 1 : up;
+        }
+
+        std::array<FLOAT, N> m_lambda{};
+        std::array<FLOAT, N> m_pdf{};
+    };
+
+    // CIE 1931 2 degree matching functions, multi-lobe Gaussian fit by
+    // Wyman, Sloan and Shirley (2013). Returned as (x, y, z).
+    inline auto cie_xyz(FLOAT lambda) -> Vec3f {
+        auto const g = [lambda](FLOAT mu, FLOAT sigma_low, FLOAT sigma_high) {
+            auto const t = (lambda - mu) / (lambda < mu ? sigma_low : sigma_high);
+            return std::exp(FLOAT(-0.5) * t * t);
+        };
+        return {
+            FLOAT(1.056) * g(599.8f, 37.9f, 31.0f) + FLOAT(0.362) * g(442.0f, 16.0f, 26.7f) - FLOAT(0.065) * g(501.1f, 20.4f, 26.2f),
+            FLOAT(0.821) * g(568.8f, 46.9f, 40.5f) + FLOAT(0.286) * g(530.9f, 16.3f, 31.1f),
+            FLOAT(1.217) * g(437.0f, 11.8f, 36.0f) + FLOAT(0.681) * g(459.0f, 26.0f, 13.8f)
+        };
+    }
+
+    // CIE XYZ to linear sRGB (D65)
+    auto constexpr xyz_to_linear_srgb(Vec3f const& xyz) -> Color3f {
+        return {
+            FLOAT( 3.2404542) * xyz.x + FLOAT(-1.5371385) * xyz.y + FLOAT(-0.4985314) * xyz.z,
+            FLOAT(-0.9692660) * xyz.x + FLOAT( 1.8760108) * xyz.y + FLOAT( 0.0415560) * xyz.z,
+            FLOAT( 0.0556434) * xyz.x + FLOAT(-0.2040259) * xyz.y + FLOAT( 1.0572252) * xyz.z
+        };
+    }
+
+    // Batched form, dispatched to the best CPU tier
+    GM_KERNEL_ABI auto xyz_to_linear_srgb(Span<Vec3f const> xyz, Color3f* out) -> void;
+
+#if !defined(GM_KERNELS_OUT_OF_LINE)
+    GM_KERNEL auto xyz_to_linear_srgb(Span<Vec3f const> xyz, Color3f* out) -> void {
+        detail::dispatch([&] {
+            for (std::size_t i = 0; i < xyz.size(); ++i) out[i] = xyz_to_linear_srgb(xyz.data()[i]);
+        });
+    }
+#endif
+
+    namespace detail {
+        // Linear sRGB of the equal-energy spectrum, used to white balance
+        // spectral results so that a constant spectrum maps to a grey Color3
+        inline auto equal_energy_rgb() -> Color3f const& {
+            static auto const white = [] {
+                auto xyz = Vec3f{};
+                for (auto lambda = constants::lambda_min; lambda <= constants::lambda_max; lambda += 1) {
+                    xyz = xyz + cie_xyz(lambda);
+                }
+                return xyz_to_linear_srgb(xyz / constants::cie_y_integral);
+            }();
+            return white;
+        }
+    }
+
+    // Monte Carlo estimate of the XYZ response of the spectrum
+    template<std::size_t N>
+    auto to_xyz(SampledSpectrum<N> const& s, SampledWavelengths<N> const& w) -> Vec3f {
+        auto x = FLOAT(0), y = FLOAT(0), z = FLOAT(0);
+        for (std::size_t i = 0; i < N; ++i) {
+            auto const pdf = w.pdf(i);
+            auto const weight = pdf != 0 ? s[i] / pdf : FLOAT(0);
+            auto const cie = cie_xyz(w.lambda(i));
+            x += cie.x * weight;
+            y += cie.y * weight;
+            z += cie.z * weight;
+        }
+        return Vec3f{ x, y, z } / (N * constants::cie_y_integral);
+    }
+
+    // White balanced linear sRGB, a constant spectrum of 1 gives Color3f{1}
+    template<std::size_t N>
+    auto to_color(SampledSpectrum<N> const& s, SampledWavelengths<N> const& w) -> Color3f {
+        auto const rgb = xyz_to_linear_srgb(to_xyz(s, w));
+        auto const& white = detail::equal_energy_rgb();
+        return { rgb.r / white.r, rgb.g / white.g, rgb.b / white.b };
+    }
+
+    // Film stage conversion of `count` spectra, the inner loops run over the
+    // N wavelengths and vectorise
+    template<std::size_t N>
+    auto to_color(SampledSpectrum<N> const* spectra, SampledWavelengths<N> const* wavelengths,
+                  Color3f* out, std::size_t count) -> void {
+        auto const& white = detail::equal_energy_rgb();
+        auto const inv_white = Color3f{ 1 / white.r, 1 / white.g, 1 / white.b };
+        for (std::size_t j = 0; j < count; ++j) {
+            auto const& s = spectra[j];
+            auto const& w = wavelengths[j];
+            alignas(detail::spectrum_alignment(N)) FLOAT x[N], y[N], z[N];
+            for (std::size_t i = 0; i < N; ++i) {
+                auto const cie = cie_xyz(w.lambda(i));
+                auto const pdf = w.pdf(i);
+                auto const weight = pdf != 0 ? s[i] / pdf : FLOAT(0);
+                x[i] = cie.x * weight;
+                y[i] = cie.y * weight;
+                z[i] = cie.z * weight;
+            }
+            auto xyz = Vec3f{};
+            for (std::size_t i = 0; i < N; ++i) xyz = xyz + Vec3f{ x[i], y[i], z[i] };
+            out[j] = xyz_to_linear_srgb(xyz / (N * constants::cie_y_integral)) * inv_white;
+        }
+    }
+
+    typedef SampledSpectrum<4> SampledSpectrum4;
+    typedef SampledWavelengths<4> SampledWavelengths4;
+}
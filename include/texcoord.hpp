@@ -0,0 +1,122 @@
+#pragma once
+
+#include "grid.hpp"
+#include "point2.hpp"
+#include "vec2.hpp"
+#include "span.hpp"
+#include "util.hpp"
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <algorithm>
+
+namespace gm {
+
+    enum class WrapMode {
+        repeat,
+        clamp,
+        mirror
+    };
+
+    // Texel index addressing for a row of `size` texels
+    auto constexpr wrap_texel(int i, int size, WrapMode mode) -> int {
+        switch (mode) {
+        case WrapMode::repeat:
+            return floor_mod(i, size);
+        case WrapMode::clamp:
+            return std::clamp(i, 0, size - 1);
+        case WrapMode::mirror: {
+            auto const m = floor_mod(i, 2 * size);
+            return m < size ? m : 2 * size - 1 - m;
+        }
+        }
+        return i;
+    }
+
+    namespace detail {
+        template<WrapMode Mode>
+        auto wrap_coordinate(FLOAT u) -> FLOAT {
+            if constexpr (Mode == WrapMode::repeat) {
+                return u - std::floor(u);
+            } else if constexpr (Mode == WrapMode::clamp) {
+                return std::min(std::max(u, FLOAT(0)), FLOAT(1));
+            } else {
+                auto const t = u - 2 * std::floor(u * FLOAT(0.5));
+                return t > 1 ? 2 - t : t;
+            }
+        }
+
+        template<WrapMode Mode>
+        auto wrap_coordinates(Point2f const* in, Point2f* out, std::size_t count) -> void {
+            for (std::size_t i = 0; i < count; ++i) {
+                out[i].x = wrap_coordinate<Mode>(in[i].x);
+                out[i].y = wrap_coordinate<Mode>(in[i].y);
+            }
+        }
+    }
+
+    // Maps a texture coordinate into [0, 1]
+    inline auto wrap(FLOAT u, WrapMode mode) -> FLOAT {
+        switch (mode) {
+        case WrapMode::repeat: return detail::wrap_coordinate<WrapMode::repeat>(u);
+        case WrapMode::clamp: return detail::wrap_coordinate<WrapMode::clamp>(u);
+        case WrapMode::mirror: return detail::wrap_coordinate<WrapMode::mirror>(u);
+        }
+        return u;
+    }
+
+    // `out` may alias `in`
+    inline auto wrap(Span<Point2f const> in, Point2f* out, WrapMode mode) -> void {
+        // dispatch once so each loop body is branch free
+        switch (mode) {
+        case WrapMode::repeat: detail::wrap_coordinates<WrapMode::repeat>(in.data(), out, in.size()); break;
+        case WrapMode::clamp: detail::wrap_coordinates<WrapMode::clamp>(in.data(), out, in.size()); break;
+        case WrapMode::mirror: detail::wrap_coordinates<WrapMode::mirror>(in.data(), out, in.size()); break;
+        }
+    }
+
+    // The four texels and weights of a bilinear lookup, texel centers are at
+    // half-integer coordinates
+    struct BilinearFootprint {
+        int x0, y0, x1, y1;
+        FLOAT fx, fy;
+
+        // for (x0, y0), (x1, y0), (x0, y1), (x1, y1)
+        auto constexpr weights() const -> std::array<FLOAT, 4> {
+            return { (1 - fx) * (1 - fy), fx * (1 - fy), (1 - fx) * fy, fx * fy };
+        }
+    };
+
+    inline auto bilinear_footprint(Point2f const& uv, Point2i const& resolution, WrapMode mode) -> BilinearFootprint {
+        auto const x = uv.x * resolution.x - FLOAT(0.5);
+        auto const y = uv.y * resolution.y - FLOAT(0.5);
+        auto const fx = std::floor(x), fy = std::floor(y);
+        auto const ix = floor_to_int(fx), iy = floor_to_int(fy);
+        return { wrap_texel(ix, resolution.x, mode), wrap_texel(iy, resolution.y, mode),
+                 wrap_texel(ix + 1, resolution.x, mode), wrap_texel(iy + 1, resolution.y, mode),
+                 x - fx, y - fy };
+    }
+
+    inline auto bilinear_footprint(Span<Point2f const> uv, Point2i const& resolution, WrapMode mode, BilinearFootprint* out) -> void {
+        for (std::size_t i = 0; i < uv.size(); ++i) out[i] = bilinear_footprint(uv.data()[i], resolution, mode);
+    }
+
+    // Isotropic level of detail from the screen space derivatives of the
+    // texture coordinates (from ray differentials): log2 of the larger
+    // footprint axis in texels, 0 is the finest level
+    inline auto mip_level(Vec2f const& duv_dx, Vec2f const& duv_dy, Point2i const& resolution) -> FLOAT {
+        auto const sx = static_cast<FLOAT>(resolution.x), sy = static_cast<FLOAT>(resolution.y);
+        auto const dx = (duv_dx.x * sx) * (duv_dx.x * sx) + (duv_dx.y * sy) * (duv_dx.y * sy);
+        auto const dy = (duv_dy.x * sx) * (duv_dy.x * sx) + (duv_dy.y * sy) * (duv_dy.y * sy);
+        // log2 of the squared width, halved, saves the square root
+        return std::max(FLOAT(0), FLOAT(0.5) * std::log2(std::max({ dx, dy, std::numeric_limits<FLOAT>::min() })));
+    }
+
+    inline auto mip_level(Span<Vec2f const> duv_dx, Span<Vec2f const> duv_dy, Point2i const& resolution, FLOAT* out) -> void {
+        assert(duv_dx.size() == duv_dy.size());
+        for (std::size_t i = 0; i < duv_dx.size(); ++i) out[i] = mip_level(duv_dx.data()[i], duv_dy.data()[i], resolution);
+    }
+}
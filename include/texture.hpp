@@ -0,0 +1,431 @@
+#pragma once
+
+#include "util.hpp"
+#include "color3.hpp"
+#include "dispatch.hpp"
+#include "grid.hpp"
+#include "lookup-tables.hpp"
+#include "parallel.hpp"
+#include "point2.hpp"
+#include "span.hpp"
+#include "texcoord.hpp"
+#include "vec2.hpp"
+
+#include <gcem.hpp>
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <algorithm>
+
+namespace gm {
+
+    namespace detail {
+        // How texels are stored: Color3f as is, Color3ui8 as 8-bit sRGB codes
+        // decoded to linear values with SrgbDecodeTable
+        template<typename Texel>
+        struct TexelFormat;
+
+        template<>
+        struct TexelFormat<Color3f> {
+            static auto decode(Color3f const& t) -> Color3f { return t; }
+            static auto encode(Color3f const& c) -> Color3f { return c; }
+        };
+
+        template<>
+        struct TexelFormat<Color3ui8> {
+            static auto decode(Color3ui8 const& t) -> Color3f {
+                SrgbDecodeTable<8> constexpr table{};
+                return { table(t.r), table(t.g), table(t.b) };
+            }
+
+            static auto encode(Color3f const& c) -> Color3ui8 {
+                auto const codes = c.encode_srgb(SrgbEncodeTable<8>{});
+                return { static_cast<std::uint8_t>(codes[0]), static_cast<std::uint8_t>(codes[1]), static_cast<std::uint8_t>(codes[2]) };
+            }
+        };
+
+        // Levels are stored as rows of 4x4 tiles of 16 consecutive texels, in
+        // Morton order within a tile, so the 2x2 quad of a bilinear lookup
+        // usually shares a tile and often a cache line
+        struct MipLevel {
+            Point2i resolution;
+            int tiles_x;
+            std::size_t offset;
+        };
+
+        inline auto constexpr tile_texels = std::size_t(16);
+
+        inline auto constexpr texel_index(MipLevel const& level, int x, int y) -> std::size_t {
+            auto const tile = static_cast<std::size_t>(y >> 2) * static_cast<std::size_t>(level.tiles_x) + static_cast<std::size_t>(x >> 2);
+            auto const within = static_cast<std::size_t>((x & 1) | (y & 1) << 1 | (x & 2) << 1 | (y & 2) << 2);
+            return level.offset + tile * tile_texels + within;
+        }
+
+        struct TexelQuad {
+            std::size_t i00, i10, i01, i11;
+            FLOAT fx, fy;
+        };
+
+        // bilinear_footprint of the coordinate wrapped into [0, 1] first, so
+        // only the border texels need fixing up and there is no branch
+        template<WrapMode Mode>
+        auto texel_quad(MipLevel const& level, Point2f const& uv) -> TexelQuad {
+            auto const w = level.resolution.x, h = level.resolution.y;
+            auto const x = wrap_coordinate<Mode>(uv.x) * static_cast<FLOAT>(w) - FLOAT(0.5);
+            auto const y = wrap_coordinate<Mode>(uv.y) * static_cast<FLOAT>(h) - FLOAT(0.5);
+            auto const fx = std::floor(x), fy = std::floor(y);
+            // x and y are in [-0.5, size - 0.5], NaN lands on the border
+            auto x0 = fx >= 0 ? static_cast<int>(fx) : -1;
+            auto y0 = fy >= 0 ? static_cast<int>(fy) : -1;
+            auto x1 = x0 + 1, y1 = y0 + 1;
+            if constexpr (Mode == WrapMode::repeat) {
+                x0 = x0 < 0 ? w - 1 : x0;
+                y0 = y0 < 0 ? h - 1 : y0;
+                x1 = x1 == w ? 0 : x1;
+                y1 = y1 == h ? 0 : y1;
+            } else {
+                // clamping and mirroring both repeat the border texel
+                x0 = std::max(x0, 0);
+                y0 = std::max(y0, 0);
+                x1 = std::min(x1, w - 1);
+                y1 = std::min(y1, h - 1);
+            }
+            return { texel_index(level, x0, y0), texel_index(level, x1, y0),
+                     texel_index(level, x0, y1), texel_index(level, x1, y1),
+                     x - fx, y - fy };
+        }
+
+        // Calls `f` with the wrap mode as a compile time constant
+        template<typename Function>
+        auto visit_wrap_mode(WrapMode mode, Function const& f) -> decltype(auto) {
+            switch (mode) {
+            case WrapMode::clamp: return f(std::integral_constant<WrapMode, WrapMode::clamp>{});
+            case WrapMode::mirror: return f(std::integral_constant<WrapMode, WrapMode::mirror>{});
+            default: return f(std::integral_constant<WrapMode, WrapMode::repeat>{});
+            }
+        }
+
+        // exp(-alpha r^2) - exp(-alpha) with alpha = 2, for r^2 in [0, 1]
+        inline constexpr auto ewa_weights = [] {
+            std::array<FLOAT, 128> t{};
+            for (std::size_t i = 0; i < t.size(); ++i) {
+                auto const r2 = static_cast<double>(i) / (t.size() - 1);
+                t[i] = static_cast<FLOAT>(gcem::exp(-2 * r2) - gcem::exp(-2.0));
+            }
+            return t;
+        }();
+
+        inline auto next_texture_id() -> std::uint64_t {
+            static std::atomic<std::uint64_t> next{ 1 };
+            return next.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    template<typename Texel>
+    class MipMap;
+
+    // Direct mapped cache of decoded 4x4 tiles, owned by one thread like a
+    // FilmTile. Lookups through a cache give the same results as without.
+    // Decoding in-memory Color3ui8 texels with SrgbDecodeTable is cheaper
+    // than a cache lookup (see the benchmarks); the cache is for texel
+    // formats whose decoding costs more than a few loads.
+    class TexelCache {
+    public:
+        // `tiles` is rounded up to a power of two
+        explicit TexelCache(std::size_t tiles = 256) : m_entries(std::max(round_up_pow2(tiles), std::size_t(1))) { }
+
+        // The calling thread's cache
+        static auto local() -> TexelCache& {
+            thread_local TexelCache cache;
+            return cache;
+        }
+
+        auto hits() const -> std::size_t { return m_hits; }
+        auto misses() const -> std::size_t { return m_misses; }
+
+        auto clear() -> void {
+            for (auto& entry : m_entries) entry.texture = 0;
+            m_hits = m_misses = 0;
+        }
+
+    private:
+        template<typename>
+        friend class MipMap;
+
+        struct Entry {
+            // texture ids start at 1, 0 marks an empty entry
+            std::uint64_t texture = 0;
+            std::size_t tile = 0;
+            std::array<Color3f, detail::tile_texels> texels;
+        };
+
+        static auto round_up_pow2(std::size_t n) -> std::size_t {
+            auto p = std::size_t(1);
+            while (p < n) p <<= 1;
+            return p;
+        }
+
+        // The decoded texels of the tile
+        template<typename Texel>
+        auto tile(std::uint64_t texture, Texel const* texels, std::size_t tile) -> Color3f const* {
+            auto const slot = (tile ^ static_cast<std::size_t>(texture * 0x9e3779b97f4a7c15u)) & (m_entries.size() - 1);
+            auto& entry = m_entries[slot];
+            if (entry.texture != texture || entry.tile != tile) {
+                ++m_misses;
+                entry.texture = texture;
+                entry.tile = tile;
+                auto const first = texels + tile * detail::tile_texels;
+                for (std::size_t i = 0; i < detail::tile_texels; ++i) entry.texels[i] = detail::TexelFormat<Texel>::decode(first[i]);
+            } else {
+                ++m_hits;
+            }
+            return entry.texels.data();
+        }
+
+        template<typename Texel>
+        auto fetch(std::uint64_t texture, Texel const* texels, std::size_t index) -> Color3f {
+            return tile(texture, texels, index / detail::tile_texels)[index % detail::tile_texels];
+        }
+
+        std::vector<Entry> m_entries;
+        std::size_t m_hits = 0, m_misses = 0;
+    };
+
+    // A texture with its box filtered mip pyramid, over Color3f or Color3ui8
+    // (sRGB encoded) texels. Lookups return linear Color3f values; texel
+    // centers are at half-integer coordinates as in bilinear_footprint.
+    template<typename Texel>
+    class MipMap {
+        static_assert(std::is_same_v<Texel, Color3f> || std::is_same_v<Texel, Color3ui8>);
+        using Format = detail::TexelFormat<Texel>;
+
+    public:
+        // `texels` are row-major. Each level halves the resolution, rounding
+        // down, until it is 1x1; odd sizes drop the last row or column of
+        // the finer level as in Direct3D.
+        MipMap(Point2i const& resolution, Span<Texel const> texels, WrapMode mode = WrapMode::repeat) : m_mode(mode) {
+            assert(resolution.x > 0 && resolution.y > 0);
+            assert(texels.size() == static_cast<std::size_t>(resolution.x) * static_cast<std::size_t>(resolution.y));
+
+            auto offset = std::size_t(0);
+            for (auto r = resolution;; r = Point2i{ std::max(1, r.x / 2), std::max(1, r.y / 2) }) {
+                auto const tiles_x = (r.x + 3) / 4, tiles_y = (r.y + 3) / 4;
+                m_levels.push_back({ r, tiles_x, offset });
+                offset += static_cast<std::size_t>(tiles_x) * static_cast<std::size_t>(tiles_y) * detail::tile_texels;
+                if (r.x == 1 && r.y == 1) break;
+            }
+            m_texels.resize(offset);
+
+            // filtered in linear values, so 8-bit levels do not accumulate
+            // rounding errors
+            std::vector<Color3f> linear(texels.size()), next;
+            auto const width = static_cast<std::size_t>(resolution.x);
+            parallel_for(texels.size(), [&](std::size_t begin, std::size_t end) {
+                for (auto i = begin; i < end; ++i) {
+                    auto const x = static_cast<int>(i % width), y = static_cast<int>(i / width);
+                    m_texels[detail::texel_index(m_levels[0], x, y)] = texels.data()[i];
+                    linear[i] = Format::decode(texels.data()[i]);
+                }
+            });
+            for (std::size_t l = 1; l < m_levels.size(); ++l) {
+                auto const& fine = m_levels[l - 1].resolution;
+                auto const& level = m_levels[l];
+                auto const w = static_cast<std::size_t>(level.resolution.x);
+                next.resize(w * static_cast<std::size_t>(level.resolution.y));
+                parallel_for(next.size(), [&](std::size_t begin, std::size_t end) {
+                    for (auto i = begin; i < end; ++i) {
+                        auto const x = static_cast<int>(i % w), y = static_cast<int>(i / w);
+                        auto const at = [&](int sx, int sy) -> Color3f const& {
+                            return linear[static_cast<std::size_t>(wrap_texel(sy, fine.y, m_mode)) * static_cast<std::size_t>(fine.x)
+                                          + static_cast<std::size_t>(wrap_texel(sx, fine.x, m_mode))];
+                        };
+                        next[i] = (at(2 * x, 2 * y) + at(2 * x + 1, 2 * y) + at(2 * x, 2 * y + 1) + at(2 * x + 1, 2 * y + 1)) * FLOAT(0.25);
+                        m_texels[detail::texel_index(level, x, y)] = Format::encode(next[i]);
+                    }
+                });
+                std::swap(linear, next);
+            }
+        }
+
+        auto levels() const -> int { return static_cast<int>(m_levels.size()); }
+        auto resolution(int level = 0) const -> Point2i { return m_levels[static_cast<std::size_t>(level)].resolution; }
+        auto wrap_mode() const -> WrapMode { return m_mode; }
+
+        // Unfiltered texel, wrapped with the texture's mode
+        auto texel(int level, Point2i const& p) const -> Color3f {
+            auto const& l = m_levels[static_cast<std::size_t>(level)];
+            return Format::decode(m_texels[detail::texel_index(l, wrap_texel(p.x, l.resolution.x, m_mode), wrap_texel(p.y, l.resolution.y, m_mode))]);
+        }
+
+        auto bilinear(Point2f const& uv, int level = 0) const -> Color3f {
+            return detail::visit_wrap_mode(m_mode, [&](auto mode) {
+                return blend(detail::texel_quad<decltype(mode)::value>(m_levels[clamp_level(level)], uv));
+            });
+        }
+
+        auto bilinear(Point2f const& uv, int level, TexelCache& cache) const -> Color3f {
+            return detail::visit_wrap_mode(m_mode, [&](auto mode) {
+                return blend(detail::texel_quad<decltype(mode)::value>(m_levels[clamp_level(level)], uv), cache);
+            });
+        }
+
+        // Blends the bilinear lookups of the two levels around `level`
+        auto trilinear(Point2f const& uv, FLOAT level) const -> Color3f {
+            return detail::visit_wrap_mode(m_mode, [&](auto mode) { return trilinear_lookup<decltype(mode)::value>(uv, level); });
+        }
+
+        auto trilinear(Point2f const& uv, FLOAT level, TexelCache& cache) const -> Color3f {
+            return detail::visit_wrap_mode(m_mode, [&](auto mode) { return trilinear_lookup<decltype(mode)::value>(uv, level, &cache); });
+        }
+
+        // At the isotropic level of detail of the derivatives, see mip_level
+        auto trilinear(Point2f const& uv, Vec2f const& duv_dx, Vec2f const& duv_dy) const -> Color3f {
+            return trilinear(uv, mip_level(duv_dx, duv_dy, resolution()));
+        }
+
+        // Batched lookups dispatched to the best CPU tier, identical to the
+        // scalar ones
+        auto bilinear(Span<Point2f const> uv, int level, Color3f* out) const -> void {
+            auto const& l = m_levels[clamp_level(level)];
+            detail::visit_wrap_mode(m_mode, [&](auto mode) {
+                detail::dispatch([&] {
+                    for (std::size_t i = 0; i < uv.size(); ++i) out[i] = blend(detail::texel_quad<decltype(mode)::value>(l, uv.data()[i]));
+                });
+            });
+        }
+
+        auto trilinear(Span<Point2f const> uv, Span<FLOAT const> level, Color3f* out) const -> void {
+            assert(uv.size() == level.size());
+            detail::visit_wrap_mode(m_mode, [&](auto mode) {
+                detail::dispatch([&] {
+                    for (std::size_t i = 0; i < uv.size(); ++i) out[i] = trilinear_lookup<decltype(mode)::value>(uv.data()[i], level.data()[i]);
+                });
+            });
+        }
+
+        // Elliptically weighted average over the footprint spanned by the
+        // derivatives, with a Gaussian filter (Heckbert 1989, as in pbrt).
+        // The minor axis is lengthened to limit the eccentricity to
+        // `max_anisotropy`, which bounds the number of texels read.
+        auto ewa(Point2f const& uv, Vec2f duv_dx, Vec2f duv_dy, FLOAT max_anisotropy = 8) const -> Color3f {
+            if (duv_dx.length_squared() < duv_dy.length_squared()) std::swap(duv_dx, duv_dy);
+            auto const major = duv_dx.length();
+            auto minor = duv_dy.length();
+            if (minor * max_anisotropy < major && minor > 0) {
+                auto const scale = major / (minor * max_anisotropy);
+                duv_dy = duv_dy * scale;
+                minor *= scale;
+            }
+            if (!(minor > 0)) return bilinear(uv, 0);
+
+            // the level where the minor axis spans about one texel
+            // past the coarsest level the ellipse covers the whole 1x1 texture
+            auto const& r = resolution();
+            auto const width = std::log2(minor * static_cast<FLOAT>(std::max(r.x, r.y)));
+            if (width >= static_cast<FLOAT>(levels() - 1)) return texel(levels() - 1, { 0, 0 });
+            auto const lod = std::max(FLOAT(0), width);
+            auto const l = static_cast<int>(lod);
+            auto const a = ewa_level(l, uv, duv_dx, duv_dy);
+            return l + 1 < levels() ? lerp(lod - static_cast<FLOAT>(l), a, ewa_level(l + 1, uv, duv_dx, duv_dy)) : a;
+        }
+
+    private:
+        auto clamp_level(int level) const -> std::size_t {
+            return static_cast<std::size_t>(std::clamp(level, 0, levels() - 1));
+        }
+
+        auto blend(detail::TexelQuad const& q) const -> Color3f {
+            auto const t = m_texels.data();
+            auto const top = lerp(q.fx, Format::decode(t[q.i00]), Format::decode(t[q.i10]));
+            auto const bottom = lerp(q.fx, Format::decode(t[q.i01]), Format::decode(t[q.i11]));
+            return lerp(q.fy, top, bottom);
+        }
+
+        auto blend(detail::TexelQuad const& q, TexelCache& cache) const -> Color3f {
+            auto const t = m_texels.data();
+            auto const tile = q.i00 / detail::tile_texels;
+            if (q.i10 / detail::tile_texels == tile && q.i01 / detail::tile_texels == tile && q.i11 / detail::tile_texels == tile) {
+                // the common case, one cache lookup for the quad
+                auto const texels = cache.tile(m_id, t, tile);
+                auto constexpr mask = detail::tile_texels - 1;
+                auto const top = lerp(q.fx, texels[q.i00 & mask], texels[q.i10 & mask]);
+                auto const bottom = lerp(q.fx, texels[q.i01 & mask], texels[q.i11 & mask]);
+                return lerp(q.fy, top, bottom);
+            }
+            auto const top = lerp(q.fx, cache.fetch(m_id, t, q.i00), cache.fetch(m_id, t, q.i10));
+            auto const bottom = lerp(q.fx, cache.fetch(m_id, t, q.i01), cache.fetch(m_id, t, q.i11));
+            return lerp(q.fy, top, bottom);
+        }
+
+        template<WrapMode Mode>
+        auto trilinear_lookup(Point2f const& uv, FLOAT level, TexelCache* cache = nullptr) const -> Color3f {
+            // NaN selects the finest level
+            auto const clamped = std::min(std::max(level, FLOAT(0)), static_cast<FLOAT>(levels() - 1));
+            auto const l0 = static_cast<std::size_t>(clamped);
+            auto const l1 = std::min(l0 + 1, m_levels.size() - 1);
+            auto const t = clamped - static_cast<FLOAT>(l0);
+            auto const q0 = detail::texel_quad<Mode>(m_levels[l0], uv), q1 = detail::texel_quad<Mode>(m_levels[l1], uv);
+            return cache ? lerp(t, blend(q0, *cache), blend(q1, *cache)) : lerp(t, blend(q0), blend(q1));
+        }
+
+        auto ewa_level(int level, Point2f const& uv, Vec2f d0, Vec2f d1) const -> Color3f {
+            auto const& r = resolution(level);
+            auto const sx = static_cast<FLOAT>(r.x), sy = static_cast<FLOAT>(r.y);
+            auto const s = uv.x * sx - FLOAT(0.5), t = uv.y * sy - FLOAT(0.5);
+            d0 = Vec2f{ d0.x * sx, d0.y * sy };
+            d1 = Vec2f{ d1.x * sx, d1.y * sy };
+
+            // implicit ellipse A s^2 + B s t + C t^2 < 1, widened by a texel
+            // so it always covers one
+            auto a = d0.y * d0.y + d1.y * d1.y + 1;
+            auto b = -2 * (d0.x * d0.y + d1.x * d1.y);
+            auto c = d0.x * d0.x + d1.x * d1.x + 1;
+            auto const inv_f = 1 / (a * c - b * b * FLOAT(0.25));
+            a *= inv_f;
+            b *= inv_f;
+            c *= inv_f;
+
+            // bounding box of the ellipse
+            auto const det = -b * b + 4 * a * c;
+            auto const inv_det = 1 / det;
+            auto const u_sqrt = std::sqrt(det * c), v_sqrt = std::sqrt(a * det);
+            auto const s0 = -floor_to_int(-(s - 2 * inv_det * u_sqrt)), s1 = floor_to_int(s + 2 * inv_det * u_sqrt);
+            auto const t0 = -floor_to_int(-(t - 2 * inv_det * v_sqrt)), t1 = floor_to_int(t + 2 * inv_det * v_sqrt);
+
+            auto sum = Color3f{};
+            auto weights = FLOAT(0);
+            auto constexpr last = detail::ewa_weights.size() - 1;
+            for (auto it = t0; it <= t1; ++it) {
+                auto const tt = static_cast<FLOAT>(it) - t;
+                for (auto is = s0; is <= s1; ++is) {
+                    auto const ss = static_cast<FLOAT>(is) - s;
+                    auto const r2 = a * ss * ss + b * ss * tt + c * tt * tt;
+                    if (r2 < 1) {
+                        auto const weight = detail::ewa_weights[std::min(static_cast<std::size_t>(r2 * last), last)];
+                        sum += texel(level, { is, it }) * weight;
+                        weights += weight;
+                    }
+                }
+            }
+            // only empty for NaN coordinates
+            return weights > 0 ? sum / weights : Color3f{};
+        }
+
+        std::vector<Texel> m_texels;
+        std::vector<detail::MipLevel> m_levels;
+        WrapMode m_mode;
+        // identifies the texels in a TexelCache; copies share the id, as
+        // their texels never change
+        std::uint64_t m_id = detail::next_texture_id();
+    };
+
+    typedef MipMap<Color3f> MipMapf;
+    typedef MipMap<Color3ui8> MipMapui8;
+}
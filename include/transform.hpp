@@ -4,56 +4,46 @@
 #include "vec3.hpp"
 #include "point3.hpp"
 #include "normal3.hpp"
+#include "interval.hpp"
+#include "dispatch.hpp"
+#include "lookup-tables.hpp"
+#include "span.hpp"
 
 namespace gm {
 
     class Transform {
     public:
     constexpr Transform() : m_matrix(Matrix4x4f::identity()), m_inverse(Matrix4x4f::identity()) { }
+    constexpr Transform(Matrix4x4f const& matrix, Matrix4x4f const& inverse) : m_matrix(matrix), m_inverse(inverse) { }
+
+    auto constexpr matrix() const -> Matrix4x4f const& { return m_matrix; }
+    auto constexpr inverse() const -> Matrix4x4f const& { return m_inverse; }
 
     auto constexpr translate(Vec3f const& vec) -> Transform& {
-        m_matrix *= {
-            1, 0, 0, vec.x,
-            0, 1, 0, vec.y,
-            0, 0, 1, vec.z,
-            0, 0, 0,     1
-        };
-        m_inverse *= {
-            1, 0, 0, -vec.x,
-            0, 1, 0, -vec.y,
-            0, 0, 1, -vec.z,
-            0, 0, 0,      1
-        };
+        m_matrix.post_translate(vec.x, vec.y, vec.z);
+        m_inverse.pre_translate(-vec.x, -vec.y, -vec.z);
 
         return *this;
     }
 
     auto constexpr scale(Vec3f const& vec) -> Transform&
     {
-        m_matrix *= {
-            vec.x,     0,     0, 0,
-                0, vec.y,     0, 0,
-                0,     0, vec.z, 0,
-                0,     0,     0,   1
-        };
-
-        m_inverse *= {
-            1.0f/vec.x,          0,          0,  0,
-            0,          1.0f/vec.y,          0,  0,
-            0,                   0, 1.0f/vec.z,  0,
-            0,                   0,          0,  1
-        };
+        GM_INSTRUMENT_COUNT_IF(vec.x == 0 || vec.y == 0 || vec.z == 0, singular_scale);
+        m_matrix.post_scale(vec.x, vec.y, vec.z);
+        m_inverse.pre_scale(1.0f/vec.x, 1.0f/vec.y, 1.0f/vec.z);
 
         return *this;
     }
 
-    auto constexpr rotate(Vec3f const& axis, FLOAT angle) -> Transform& {
+    // Angle in degrees, `trig` is ExactSinCos or a SinCosTable
+    template<typename Trig = ExactSinCos>
+    auto constexpr rotate(Vec3f const& axis, FLOAT angle, Trig const& trig = {}) -> Transform& {
 
         auto const norm_axis = axis.normalise();
-        auto const rad = degree_to_radian(angle);
+        auto const sin_cos = trig(angle);
 
-        auto const cos_theta = gcem::cos(rad);
-        auto const sin_theta = gcem::sin(rad);
+        auto const cos_theta = sin_cos.cos;
+        auto const sin_theta = sin_cos.sin;
 
         auto mat = Matrix4x4f::identity();
 
@@ -77,12 +67,104 @@ namespace gm {
         mat(3, 2) = 0;
         mat(3, 3) = 1;
 
-        m_matrix *= mat;
-        m_inverse *= mat.transpose();
+        m_matrix.post_rotate(mat);
+        m_inverse.pre_rotate(mat.transpose());
 
         return *this;
     }
     
+    // Camera conventions: right-handed, looking down -z, column vectors and
+    // clip space depth in [0,1] (see ClipDepth::zero_to_one)
+
+    auto constexpr perspective(FLOAT fov_y, FLOAT aspect, FLOAT near_z, FLOAT far_z) -> Transform& {
+        auto const f = 1 / gcem::tan(degree_to_radian(fov_y) / 2);
+        auto const range = near_z - far_z;
+
+        compose(
+            Matrix4x4f{
+                f / aspect, 0,              0,                        0,
+                         0, f,              0,                        0,
+                         0, 0, far_z / range,  near_z * far_z / range,
+                         0, 0,             -1,                        0
+            },
+            Matrix4x4f{
+                aspect / f,     0,                              0,                  0,
+                         0, 1 / f,                              0,                  0,
+                         0,     0,                              0,                 -1,
+                         0,     0, range / (near_z * far_z),          1 / near_z
+            });
+
+        return *this;
+    }
+
+    // Reversed-Z with the far plane at infinity: the near plane maps to depth 1
+    // and infinity to depth 0, which spreads floating point precision evenly
+    auto constexpr infinite_reversed_perspective(FLOAT fov_y, FLOAT aspect, FLOAT near_z) -> Transform& {
+        auto const f = 1 / gcem::tan(degree_to_radian(fov_y) / 2);
+
+        compose(
+            Matrix4x4f{
+                f / aspect, 0,  0,      0,
+                         0, f,  0,      0,
+                         0, 0,  0, near_z,
+                         0, 0, -1,      0
+            },
+            Matrix4x4f{
+                aspect / f,     0,          0,  0,
+                         0, 1 / f,          0,  0,
+                         0,     0,          0, -1,
+                         0,     0, 1 / near_z,  0
+            });
+
+        return *this;
+    }
+
+    auto constexpr orthographic(FLOAT left, FLOAT right, FLOAT bottom, FLOAT top, FLOAT near_z, FLOAT far_z) -> Transform& {
+        auto const width = right - left;
+        auto const height = top - bottom;
+        auto const range = near_z - far_z;
+
+        compose(
+            Matrix4x4f{
+                2 / width,          0,         0, -(right + left) / width,
+                        0, 2 / height,         0, -(top + bottom) / height,
+                        0,          0, 1 / range,           near_z / range,
+                        0,          0,         0,                        1
+            },
+            Matrix4x4f{
+                width / 2,          0,     0,  (right + left) / 2,
+                        0, height / 2,     0,  (top + bottom) / 2,
+                        0,          0, range,             -near_z,
+                        0,          0,     0,                   1
+            });
+
+        return *this;
+    }
+
+    // World to camera transformation
+    auto constexpr look_at(Point3f const& eye, Point3f const& target, Vec3f const& up) -> Transform& {
+        auto const f = static_cast<Vec3f>((target - eye).normalise());
+        auto const s = static_cast<Vec3f>(f.cross(up).normalise());
+        auto const u = s.cross(f);
+        auto const e = eye - Point3f{};
+
+        compose(
+            Matrix4x4f{
+                 s.x,  s.y,  s.z, -dot(s, e),
+                 u.x,  u.y,  u.z, -dot(u, e),
+                -f.x, -f.y, -f.z,  dot(f, e),
+                   0,    0,    0,          1
+            },
+            Matrix4x4f{
+                s.x, u.x, -f.x, eye.x,
+                s.y, u.y, -f.y, eye.y,
+                s.z, u.z, -f.z, eye.z,
+                  0,   0,    0,     1
+            });
+
+        return *this;
+    }
+
     auto constexpr apply(Point3f const& point) const -> Point3f {
 
         const auto x = m_matrix(0,0) * point.x + m_matrix(0,1) * point.y + m_matrix(0,2) * point.z + m_matrix(0,3);
@@ -90,6 +172,8 @@ namespace gm {
         const auto z = m_matrix(2,0) * point.x + m_matrix(2,1) * point.y + m_matrix(2,2) * point.z + m_matrix(2,3);
         const auto w = m_matrix(3,0) * point.x + m_matrix(3,1) * point.y + m_matrix(3,2) * point.z + m_matrix(3,3);
 
+        GM_INSTRUMENT_COUNT(transform_apply);
+        GM_INSTRUMENT_CHECK(x/w, y/w, z/w);
         return {x/w, y/w, z/w};
     }
 
@@ -98,6 +182,8 @@ namespace gm {
         const auto x = m_matrix(0,0) * vec.x + m_matrix(0,1) * vec.y + m_matrix(0,2) * vec.z;
         const auto y = m_matrix(1,0) * vec.x + m_matrix(1,1) * vec.y + m_matrix(1,2) * vec.z;
         const auto z = m_matrix(2,0) * vec.x + m_matrix(2,1) * vec.y + m_matrix(2,2) * vec.z;
+        GM_INSTRUMENT_COUNT(transform_apply);
+        GM_INSTRUMENT_CHECK(x, y, z);
         return {x, y, z};
     }
 
@@ -107,14 +193,112 @@ namespace gm {
         const auto x = m_inverse(0,0) * normal.x() + m_inverse(1,0) * normal.y() + m_inverse(2,0) * normal.z();
         const auto y = m_inverse(0,1) * normal.x() + m_inverse(1,1) * normal.y() + m_inverse(2,1) * normal.z();
         const auto z = m_inverse(0,2) * normal.x() + m_inverse(1,2) * normal.y() + m_inverse(2,2) * normal.z();
+        GM_INSTRUMENT_COUNT(transform_apply);
         return Vec3f{ x, y, z }.normalise();
     }
 
+    // Rigorous bounds: the result contains the transform of every point in `point`
+    auto apply(Point3fi const& point) const -> Point3fi {
+        auto const row = [this, &point](int i) {
+            return m_matrix(i,0) * point.x + m_matrix(i,1) * point.y + m_matrix(i,2) * point.z + Intervalf{ m_matrix(i,3) };
+        };
+        auto const x = row(0), y = row(1), z = row(2);
+        GM_INSTRUMENT_COUNT(transform_apply);
+        // affine transforms leave w at exactly one, dividing would only widen
+        if (m_matrix(3,0) == 0 && m_matrix(3,1) == 0 && m_matrix(3,2) == 0 && m_matrix(3,3) == 1) return {x, y, z};
+        auto const w = row(3);
+        return {x / w, y / w, z / w};
+    }
+
+    auto apply(Vec3fi const& vec) const -> Vec3fi {
+        auto const row = [this, &vec](int i) {
+            return m_matrix(i,0) * vec.x + m_matrix(i,1) * vec.y + m_matrix(i,2) * vec.z;
+        };
+        GM_INSTRUMENT_COUNT(transform_apply);
+        return {row(0), row(1), row(2)};
+    }
+
+    // Batched forms of the above, dispatched to the best CPU tier and rounded
+    // exactly as the scalar ones
+    GM_KERNEL_ABI auto apply(Span<Point3f const> points, Point3f* out) const -> void;
+    GM_KERNEL_ABI auto apply(Span<Vec3f const> vectors, Vec3f* out) const -> void;
+    GM_KERNEL_ABI auto apply(Span<Normal3f const> normals, Normal3f* out) const -> void;
+
+    auto apply(Point3fi const* points, Point3fi* out, std::size_t count) const -> void {
+        for (std::size_t i = 0; i < count; ++i) out[i] = apply(points[i]);
+    }
+
+    // Only valid for pure projections as built by perspective, orthographic and
+    // infinite_reversed_perspective: skips the entries those leave at zero.
+    auto constexpr apply_projective(Point3f const& point) const -> Point3f {
+        assert(is_projective());
+
+        const auto x = m_matrix(0,0) * point.x + m_matrix(0,2) * point.z + m_matrix(0,3);
+        const auto y = m_matrix(1,1) * point.y + m_matrix(1,2) * point.z + m_matrix(1,3);
+        const auto z = m_matrix(2,2) * point.z + m_matrix(2,3);
+        const auto w = m_matrix(3,2) * point.z + m_matrix(3,3);
+
+        const auto inv_w = 1 / w;
+        GM_INSTRUMENT_COUNT(transform_apply);
+        GM_INSTRUMENT_CHECK(x * inv_w, y * inv_w, z * inv_w);
+        return {x * inv_w, y * inv_w, z * inv_w};
+    }
+
+    auto apply_projective(Point3f const* points, Point3f* out, std::size_t count) const -> void {
+        assert(is_projective());
+
+        auto const m00 = m_matrix(0,0), m02 = m_matrix(0,2), m03 = m_matrix(0,3);
+        auto const m11 = m_matrix(1,1), m12 = m_matrix(1,2), m13 = m_matrix(1,3);
+        auto const m22 = m_matrix(2,2), m23 = m_matrix(2,3);
+        auto const m32 = m_matrix(3,2), m33 = m_matrix(3,3);
+
+        GM_INSTRUMENT_COUNT_N(transform_apply, count);
+        for (std::size_t i = 0; i < count; ++i) {
+            auto const p = points[i];
+            auto const inv_w = 1 / (m32 * p.z + m33);
+            out[i] = Point3f{ (m00 * p.x + m02 * p.z + m03) * inv_w,
+                              (m11 * p.y + m12 * p.z + m13) * inv_w,
+                              (m22 * p.z + m23) * inv_w };
+        }
+    }
+
+    auto constexpr is_projective() const -> bool {
+        return m_matrix(0,1) == 0 && m_matrix(1,0) == 0
+            && m_matrix(2,0) == 0 && m_matrix(2,1) == 0
+            && m_matrix(3,0) == 0 && m_matrix(3,1) == 0;
+    }
+
     // TODO: undo functions
 
     private:
+        // appends `matrix` to the transformation, so its inverse is prepended
+        auto constexpr compose(Matrix4x4f const& matrix, Matrix4x4f const& inverse) -> void {
+            m_matrix *= matrix;
+            m_inverse = inverse * m_inverse;
+        }
+
         Matrix4x4f m_matrix;
         Matrix4x4f m_inverse;
     };
 
+#if !defined(GM_KERNELS_OUT_OF_LINE)
+    GM_KERNEL auto Transform::apply(Span<Point3f const> points, Point3f* out) const -> void {
+        detail::dispatch([&] {
+            for (std::size_t i = 0; i < points.size(); ++i) out[i] = apply(points.data()[i]);
+        });
+    }
+
+    GM_KERNEL auto Transform::apply(Span<Vec3f const> vectors, Vec3f* out) const -> void {
+        detail::dispatch([&] {
+            for (std::size_t i = 0; i < vectors.size(); ++i) out[i] = apply(vectors.data()[i]);
+        });
+    }
+
+    GM_KERNEL auto Transform::apply(Span<Normal3f const> normals, Normal3f* out) const -> void {
+        detail::dispatch([&] {
+            for (std::size_t i = 0; i < normals.size(); ++i) out[i] = apply(normals.data()[i]);
+        });
+    }
+#endif
+
 }
\ No newline at end of file
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "compare.hpp"
+#include "point2.hpp"
+#include "vec2.hpp"
+#include "lookup-tables.hpp"
+#include "span.hpp"
+#include "util.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <optional>
+#include <ostream>
+
+namespace gm {
+
+    // 2D affine transform, the top two rows of a 3x3 matrix acting on column
+    // vectors: x' = a x + b y + tx, y' = c x + d y + ty
+    class Transform2D {
+    public:
+        FLOAT a, b, tx;
+        FLOAT c, d, ty;
+
+        constexpr Transform2D() : a(1), b(0), tx(0), c(0), d(1), ty(0) { }
+        constexpr Transform2D(FLOAT a, FLOAT b, FLOAT tx, FLOAT c, FLOAT d, FLOAT ty)
+            : a(a), b(b), tx(tx), c(c), d(d), ty(ty) { }
+
+        static auto constexpr translate(Vec2f const& t) -> Transform2D {
+            return { 1, 0, t.x, 0, 1, t.y };
+        }
+
+        static auto constexpr scale(Vec2f const& s) -> Transform2D {
+            return { s.x, 0, 0, 0, s.y, 0 };
+        }
+
+        // counter-clockwise, in degrees; `trig` is ExactSinCos or a SinCosTable
+        template<typename Trig = ExactSinCos>
+        static auto constexpr rotate(FLOAT angle, Trig const& trig = {}) -> Transform2D {
+            auto const sin_cos = trig(angle);
+            return { sin_cos.cos, -sin_cos.sin, 0, sin_cos.sin, sin_cos.cos, 0 };
+        }
+
+        // Applies `other` first, then this
+        auto constexpr operator*(Transform2D const& other) const -> Transform2D {
+            return { a * other.a + b * other.c, a * other.b + b * other.d, a * other.tx + b * other.ty + tx,
+                     c * other.a + d * other.c, c * other.b + d * other.d, c * other.tx + d * other.ty + ty };
+        }
+
+        // defined after approx_equal
+        auto constexpr operator==(Transform2D const& other) const -> bool;
+
+        auto constexpr operator!=(Transform2D const& other) const -> bool {
+            return !(*this == other);
+        }
+
+        auto constexpr determinant() const -> FLOAT {
+            return a * d - b * c;
+        }
+
+        auto constexpr inverse() const -> std::optional<Transform2D> {
+            auto const det = determinant();
+            if (det == 0) return std::nullopt;
+            auto const inv_det = 1 / det;
+            auto const ia = d * inv_det, ib = -b * inv_det;
+            auto const ic = -c * inv_det, id = a * inv_det;
+            return Transform2D{ ia, ib, -(ia * tx + ib * ty),
+                                ic, id, -(ic * tx + id * ty) };
+        }
+
+        auto constexpr operator()(Point2f const& p) const -> Point2f {
+            return { a * p.x + b * p.y + tx, c * p.x + d * p.y + ty };
+        }
+
+        // Directions ignore the translation
+        auto constexpr operator()(Vec2f const& v) const -> Vec2f {
+            return { a * v.x + b * v.y, c * v.x + d * v.y };
+        }
+
+        // Batched forms, `out` may alias `in`
+        auto apply(Span<Point2f const> in, Point2f* out) const -> void {
+            auto const m = *this;
+            auto const* p = in.data();
+            for (std::size_t i = 0; i < in.size(); ++i) {
+                auto const x = p[i].x, y = p[i].y;
+                out[i].x = m.a * x + m.b * y + m.tx;
+                out[i].y = m.c * x + m.d * y + m.ty;
+            }
+        }
+
+        auto apply(Span<Vec2f const> in, Vec2f* out) const -> void {
+            auto const m = *this;
+            auto const* v = in.data();
+            for (std::size_t i = 0; i < in.size(); ++i) {
+                auto const x = v[i].x, y = v[i].y;
+                out[i].x = m.a * x + m.b * y;
+                out[i].y = m.c * x + m.d * y;
+            }
+        }
+
+        auto friend operator<<(std::ostream& os, Transform2D const& t) -> std::ostream& {
+            os << '[' << t.a << ',' << t.b << ',' << t.tx << ';' << t.c << ',' << t.d << ',' << t.ty << ']' << '\n';
+            return os;
+        }
+    };
+
+    template<typename Policy>
+    auto constexpr approx_equal(Transform2D const& m, Transform2D const& n, Policy const& policy) -> bool {
+        return policy(m.a, n.a) & policy(m.b, n.b) & policy(m.tx, n.tx)
+             & policy(m.c, n.c) & policy(m.d, n.d) & policy(m.ty, n.ty);
+    }
+
+    auto constexpr Transform2D::operator==(Transform2D const& other) const -> bool {
+        return approx_equal(*this, other, DefaultComparison<FLOAT>{});
+    }
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "instrumentation.hpp"
+
 #include <gcem.hpp>
 
 #include <optional>
@@ -33,7 +35,9 @@ namespace gm {
     // Returns in order smallest to largest solution
     template<typename T, REQUIRES(std::is_arithmetic<T>())>
     auto constexpr solve_quadratic(T a, T b, T c) -> std::optional<std::tuple<FLOAT, FLOAT>> {
-       
+        GM_INSTRUMENT_COUNT(solve_quadratic);
+        GM_INSTRUMENT_COUNT_IF(a == 0, degenerate_quadratic);
+
         auto const discr = b * b - 4 * a * c;
 
         if (discr < 0) return std::nullopt;
@@ -51,6 +55,8 @@ namespace gm {
         if (solution_one > solution_two)
             std::swap(solution_one, solution_two);
 
+        GM_INSTRUMENT_CHECK(solution_one, solution_two);
+
         return std::make_tuple(solution_one, solution_two);
     }
 
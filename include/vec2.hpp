@@ -1,6 +1,7 @@
 #pragma once
 #include <gcem.hpp>
 #include "util.hpp"
+#include "compare.hpp"
 #include "vec3.hpp"
 
 #include <ostream>
@@ -54,29 +55,20 @@ namespace gm {
         }
 
         auto constexpr operator==(Vec2<Type> const& other) const -> bool {
-            if constexpr (std::is_floating_point_v<Type>) {
-                return gcem::abs(x - other.x) < constants::epsilon
-                    && gcem::abs(y - other.y) < constants::epsilon;
-            } else {
-                return x == other.x && y == other.y;
-            }
+            return approx_equal(*this, other, DefaultComparison<Type>{});
         }
 
         auto constexpr operator!=(Vec2<Type> const& other) const -> bool {
-            if constexpr (std::is_floating_point_v<Type>) {
-                return gcem::abs(x - other.x) > constants::epsilon
-                    || gcem::abs(y - other.y) > constants::epsilon;
-            } else {
-                return x != other.x || y != other.y;
-            }
-        } 
+            return !(*this == other);
+        }
 
         auto constexpr dot(Vec2 const& other) const -> Type {
-            return dot(*this, other); 
+            return x * other.x + y * other.y;
         }
 
-        auto constexpr cross(Vec2<Type> const& other) const -> Vec2<Type> {
-            return cross(*this, other); 
+        // z of the cross product of the vectors extended with z = 0
+        auto constexpr cross(Vec2<Type> const& other) const -> Type {
+            return x * other.y - y * other.x;
         }
 
         auto friend operator<<(std::ostream &os, Vec2<Type> const& v) -> std::ostream & {
@@ -86,15 +78,20 @@ namespace gm {
 
     };
 
+    template<typename Type, typename Policy>
+    auto constexpr approx_equal(Vec2<Type> const& a, Vec2<Type> const& b, Policy const& policy) -> bool {
+        return policy(a.x, b.x) & policy(a.y, b.y);
+    }
+
     template<typename Type>
     auto constexpr dot(Vec2<Type> const& v, Vec2<Type> const& u) -> Type {
         return v.x * u.x + v.y * u.y;
     }
 
-    template< typename T > 
-    auto cross(Vec2<T> const& u, Vec2<T> const& v) -> Vec2<T> {
-        return { u.y * v.z - u.z * v.y,
-                 u.z * v.x - u.x * v.z };
+    // z of the 3D cross product, as Vec2::cross
+    template<typename T>
+    auto constexpr cross(Vec2<T> const& u, Vec2<T> const& v) -> T {
+        return u.x * v.y - u.y * v.x;
     }
 
     template<typename Type>
@@ -110,4 +107,11 @@ namespace gm {
 
     typedef Vec2<FLOAT> Vec2f;
     typedef Vec2<int> Vec2i;
+
+#if defined(GRAPHICS_MATH_STATIC) && !defined(GRAPHICS_MATH_IMPLEMENTATION)
+    // instantiated in graphics-math-static
+    extern template class Vec2<float>;
+    extern template class Vec2<double>;
+    extern template class Vec2<int>;
+#endif
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include "util.hpp"
+#include "compare.hpp"
 //#include "normal3.hpp"
 
 #include <gcem.hpp>
@@ -60,24 +61,12 @@ namespace gm {
         }
 
         auto constexpr operator==(Vec3<Type> const& other) const -> bool {
-            if constexpr (std::is_floating_point_v<Type>) {
-                return gcem::abs(x - other.x) < constants::epsilon
-                    && gcem::abs(y - other.y) < constants::epsilon
-                    && gcem::abs(z - other.z) < constants::epsilon;
-            } else {
-                return x == other.x && y == other.y && z == other.z;
-            }
+            return approx_equal(*this, other, DefaultComparison<Type>{});
         }
 
         auto constexpr operator!=(Vec3<Type> const& other) const -> bool {
-            if constexpr (std::is_floating_point_v<Type>) {
-                return gcem::abs(x - other.x) > constants::epsilon
-                    || gcem::abs(y - other.y) > constants::epsilon
-                    || gcem::abs(z - other.z) > constants::epsilon;
-            } else {
-                return x != other.x || y != other.y || z != other.z;
-            }
-        } 
+            return !(*this == other);
+        }
 
         auto constexpr dot(Vec3 const& other) const -> Type {
             return x * other.x + y * other.y + z * other.z;
@@ -91,9 +80,13 @@ namespace gm {
 
 
 
+        // a member template, so explicit instantiations of integer vectors skip it
+        template<typename T = Type, REQUIRES(std::is_floating_point_v<T>)>
         auto constexpr normalise() const -> Normal3<Type> {
-            static_assert(std::is_floating_point_v<Type>);
             auto const len = length();
+            GM_INSTRUMENT_COUNT(normalise);
+            GM_INSTRUMENT_COUNT_IF(len == 0, zero_length_normalise);
+            GM_INSTRUMENT_CHECK(x / len, y / len, z / len);
             assert(len > 0);
             return { 
                 x / len, 
@@ -109,6 +102,11 @@ namespace gm {
 
     };
 
+    template<typename Type, typename Policy>
+    auto constexpr approx_equal(Vec3<Type> const& a, Vec3<Type> const& b, Policy const& policy) -> bool {
+        return policy(a.x, b.x) & policy(a.y, b.y) & policy(a.z, b.z);
+    }
+
     template<typename Type>
     auto constexpr dot(Vec3<Type> const& v, Vec3<Type> const& u) -> Type {
         return v.dot(u);
@@ -132,4 +130,10 @@ namespace gm {
     typedef Vec3<FLOAT> Vec3f;
     typedef Vec3<int> Vec3i;
 
+#if defined(GRAPHICS_MATH_STATIC) && !defined(GRAPHICS_MATH_IMPLEMENTATION)
+    // instantiated in graphics-math-static
+    extern template class Vec3<float>;
+    extern template class Vec3<double>;
+    extern template class Vec3<int>;
+#endif
 }
\ No newline at end of file
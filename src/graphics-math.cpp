@@ -0,0 +1,32 @@
+// The graphics-math-static library: the explicit instantiations behind the
+// extern template declarations in the headers, and through
+// GRAPHICS_MATH_IMPLEMENTATION the one definition of each batch kernel.
+#include <graphics-math.hpp>
+
+namespace gm {
+    template class Vec2<float>;
+    template class Vec2<double>;
+    template class Vec2<int>;
+
+    template class Vec3<float>;
+    template class Vec3<double>;
+    template class Vec3<int>;
+
+    template class Point2<float>;
+    template class Point2<double>;
+    template class Point2<int>;
+
+    template class Point3<float>;
+    template class Point3<double>;
+    template class Point3<int>;
+
+    template class Normal3<float>;
+    template class Normal3<double>;
+
+    template class Color3<float>;
+    template class Color3<double>;
+
+    template class Matrix4x4<float>;
+    template class Matrix4x4<double>;
+    template class Matrix4x4<int>;
+}
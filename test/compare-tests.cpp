@@ -0,0 +1,91 @@
+#include <graphics-math.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace gm;
+
+TEST_CASE("Comparison policies", "[compare]") {
+    auto const a = Vec3f{ 1.0f, 2.0f, 3.0f };
+
+    SECTION("Exact") {
+        REQUIRE(approx_equal(a, a, Exact{}));
+        REQUIRE_FALSE(approx_equal(a, Vec3f{ 1.0f, 2.0f, std::nextafter(3.0f, 4.0f) }, Exact{}));
+    }
+
+    SECTION("Absolute") {
+        REQUIRE(approx_equal(a, Vec3f{ 1.05f, 2.0f, 3.0f }, AbsoluteTolerance{ 0.1f }));
+        REQUIRE_FALSE(approx_equal(a, Vec3f{ 1.2f, 2.0f, 3.0f }, AbsoluteTolerance{ 0.1f }));
+    }
+
+    SECTION("Relative") {
+        auto const big = Point3f{ 1e6f, -2e6f, 3e6f };
+        REQUIRE(approx_equal(big, Point3f{ 1e6f + 1.0f, -2e6f, 3e6f }, RelativeTolerance{}));
+        REQUIRE_FALSE(approx_equal(big, Point3f{ 1e6f + 100.0f, -2e6f, 3e6f }, RelativeTolerance{}));
+    }
+
+    SECTION("ULP distance") {
+        auto x = 1.0f;
+        for (int i = 0; i < 4; ++i) x = std::nextafter(x, 2.0f);
+        REQUIRE(UlpDistance{ 4 }(1.0f, x));
+        REQUIRE_FALSE(UlpDistance{ 3 }(1.0f, x));
+        REQUIRE(UlpDistance{ 0 }(0.0f, -0.0f));
+        auto const tiny = std::numeric_limits<float>::denorm_min();
+        REQUIRE(UlpDistance{ 2 }(-tiny, tiny));
+        REQUIRE_FALSE(UlpDistance{ 1 }(-tiny, tiny));
+        auto const nan = std::numeric_limits<float>::quiet_NaN();
+        REQUIRE_FALSE(UlpDistance{ 1000 }(nan, nan));
+        REQUIRE(approx_equal(Color3f{ 0.5f, 0.25f, 0.125f }, Color3f{ 0.5f, 0.25f, 0.125f }, UlpDistance{}));
+    }
+}
+
+TEST_CASE("Operators use the default comparison", "[compare]") {
+    REQUIRE(Vec2f{ 1.0f, 2.0f } == Vec2f{ 1.0f, 2.0f + constants::epsilon * 0.5f });
+    REQUIRE(Vec2f{ 1.0f, 2.0f } != Vec2f{ 1.0f, 2.1f });
+    REQUIRE(Point2i{ 1, 2 } != Point2i{ 1, 3 });
+    REQUIRE(Color3<int>{ 1, 2, 3 } == Color3<int>{ 1, 2, 3 });
+    REQUIRE(Color3<int>{ 1, 2, 3 } != Color3<int>{ 1, 2, 4 });
+    REQUIRE(Transform2D::translate({ 1, 2 }) == Transform2D::translate({ 1, 2 + constants::epsilon * 0.5f }));
+    REQUIRE(Transform2D::translate({ 1, 2 }) != Transform2D::translate({ 1, 2.1f }));
+}
+
+TEST_CASE("Matrix approximate equality", "[compare]") {
+    auto const m = Matrix4x4f::identity();
+    auto n = m;
+    n(2, 3) = 1e-7f;
+    REQUIRE(m != n);
+    REQUIRE(approx_equal(m, n, AbsoluteTolerance{}));
+    REQUIRE_FALSE(approx_equal(m, n, Exact{}));
+    n(0, 0) = 1.5f;
+    REQUIRE_FALSE(approx_equal(m, n, AbsoluteTolerance{}));
+}
+
+TEST_CASE("Hashing agrees with exact equality", "[compare]") {
+    REQUIRE(Hash{}(Vec3f{ 0.0f, 1.0f, 2.0f }) == Hash{}(Vec3f{ -0.0f, 1.0f, 2.0f }));
+    REQUIRE(ExactEqual{}(Vec3f{ 0.0f, 1.0f, 2.0f }, Vec3f{ -0.0f, 1.0f, 2.0f }));
+    REQUIRE(Hash{}(Point3f{ 1.0f, 2.0f, 3.0f }) != Hash{}(Point3f{ 3.0f, 2.0f, 1.0f }));
+
+    std::unordered_map<Matrix4x4f, int, Hash, ExactEqual> map;
+    auto const a = Transform{}.translate(Vec3f{ 1.0f, 2.0f, 3.0f });
+    auto const b = Transform{}.scale(Vec3f{ 2.0f, 2.0f, 2.0f });
+    map[a.matrix()] = 1;
+    map[b.matrix()] = 2;
+    map[Transform{}.translate(Vec3f{ 1.0f, 2.0f, 3.0f }).matrix()] = 3;
+    REQUIRE(map.size() == 2);
+    REQUIRE(map[a.matrix()] == 3);
+
+    std::unordered_set<Transform, Hash, ExactEqual> transforms{ a, b, a };
+    REQUIRE(transforms.size() == 2);
+
+    std::unordered_set<Normal3f, Hash, ExactEqual> normals{ Vec3f{ 0.0f, 0.0f, 1.0f }.normalise() };
+    REQUIRE(normals.count(Vec3f{ 0.0f, 0.0f, 2.0f }.normalise()) == 1);
+
+    std::unordered_set<Transform2D, Hash, ExactEqual> transforms2d{ Transform2D::rotate(90), Transform2D::scale({ 2, 3 }), Transform2D::rotate(90) };
+    REQUIRE(transforms2d.size() == 2);
+    REQUIRE(Hash{}(Transform2D::translate({ 0.0f, 1.0f })) == Hash{}(Transform2D::translate({ -0.0f, 1.0f })));
+    REQUIRE_FALSE(approx_equal(Transform2D{}, Transform2D::translate({ 1e-7f, 0 }), Exact{}));
+}
@@ -0,0 +1,90 @@
+#include <graphics-math.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <vector>
+
+using namespace gm;
+
+TEST_CASE("Plane", "[Plane3]") {
+    auto constexpr plane = Plane3f{ Vec3f{0, 2, 0}, -4 }.normalise();
+    REQUIRE(plane == Plane3f{ 0, 1, 0, -2 });
+    REQUIRE(plane.distance(Point3f{ 5, 3, 1 }) == Approx(1));
+    REQUIRE(plane.flip().distance(Point3f{ 5, 3, 1 }) == Approx(-1));
+
+    auto constexpr through_point = Plane3f{ Vec3f{0, 0, 1}.normalise(), Point3f{ 0, 0, 5 } };
+    REQUIRE(through_point.distance(Point3f{ 1, 1, 5 }) == Approx(0));
+}
+
+TEST_CASE("Frustum extraction", "[Frustum]") {
+    // identity projection: clip volume is [-1,1] x [-1,1] x [0,1]
+    auto constexpr frustum = Frustum::from_matrix(Matrix4x4f::identity());
+    REQUIRE(frustum.contains(Point3f{ 0, 0, 0.5f }));
+    REQUIRE(frustum.contains(Point3f{ 1, -1, 1 }));
+    REQUIRE_FALSE(frustum.contains(Point3f{ 0, 0, -0.5f }));
+    REQUIRE_FALSE(frustum.contains(Point3f{ 1.5f, 0, 0.5f }));
+
+    auto const gl_frustum = Frustum::from_matrix(Matrix4x4f::identity(), ClipDepth::negative_one_to_one);
+    REQUIRE(gl_frustum.contains(Point3f{ 0, 0, -0.5f }));
+
+    // perspective looking down -z, 90 degree fov, near 1, far 10, [0,1] depth
+    auto const n = 1.0f, f = 10.0f;
+    auto const perspective = Matrix4x4f{
+        1, 0,            0,                0,
+        0, 1,            0,                0,
+        0, 0,  f / (n - f),  n * f / (n - f),
+        0, 0,           -1,                0
+    };
+    auto const view = Frustum::from_matrix(perspective);
+    REQUIRE(view.contains(Point3f{ 0, 0, -5 }));
+    REQUIRE(view.contains(Point3f{ 4.9f, 0, -5 }));
+    REQUIRE_FALSE(view.contains(Point3f{ 5.1f, 0, -5 }));
+    REQUIRE_FALSE(view.contains(Point3f{ 0, 0, -0.5f }));
+    REQUIRE_FALSE(view.contains(Point3f{ 0, 0, -11 }));
+    REQUIRE(view[0].normal.length() == Approx(1));
+}
+
+TEST_CASE("Batch culling", "[Frustum]") {
+    auto const frustum = Frustum::from_matrix(Matrix4x4f::identity());
+
+    // more than one block, alternating between visible and culled
+    auto const count = std::size_t{ 150 };
+    std::vector<FLOAT> x(count), y(count), z(count), r(count);
+    std::vector<FLOAT> min_x(count), min_y(count), min_z(count), max_x(count), max_y(count), max_z(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        x[i] = (i % 3 == 0) ? 0.0f : 3.0f;
+        y[i] = 0.0f;
+        z[i] = 0.5f;
+        r[i] = (i % 5 == 0) ? 2.5f : 0.1f;
+
+        min_x[i] = x[i] - r[i]; max_x[i] = x[i] + r[i];
+        min_y[i] = y[i] - r[i]; max_y[i] = y[i] + r[i];
+        min_z[i] = z[i] - r[i]; max_z[i] = z[i] + r[i];
+    }
+
+    std::vector<std::uint32_t> expected;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (frustum.intersects(Point3f{ x[i], y[i], z[i] }, r[i])) {
+            expected.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+    REQUIRE(expected.size() == 50 + 20);
+
+    SECTION("spheres") {
+        auto const visible = frustum.cull(SphereBatch{ x.data(), y.data(), z.data(), r.data(), count });
+        REQUIRE(visible == expected);
+    }
+
+    SECTION("boxes") {
+        auto const boxes = BoxBatch{
+            min_x.data(), min_y.data(), min_z.data(),
+            max_x.data(), max_y.data(), max_z.data(), count };
+        std::vector<std::uint32_t> visible(count);
+        visible.resize(frustum.cull(boxes, visible.data()));
+        REQUIRE(visible == expected);
+        for (auto i : visible) {
+            REQUIRE(frustum.intersects(Point3f{ min_x[i], min_y[i], min_z[i] }, Point3f{ max_x[i], max_y[i], max_z[i] }));
+        }
+    }
+}
@@ -0,0 +1,105 @@
+#include <graphics-math.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+using namespace gm;
+
+namespace {
+    template<typename Type>
+    auto bitwise_equal(Type const& a, Type const& b) -> bool {
+        return std::memcmp(&a, &b, sizeof(Type)) == 0;
+    }
+
+    // Every tier up to the detected one, restoring the active tier afterwards
+    template<typename Function>
+    auto for_each_tier(Function const& f) -> void {
+        auto const previous = cpu_tier();
+        for (auto tier : { CpuTier::scalar, CpuTier::sse42, CpuTier::avx2, CpuTier::avx512 }) {
+            if (tier > detected_cpu_tier()) break;
+            set_cpu_tier(tier);
+            INFO("tier " << to_string(tier));
+            f();
+        }
+        set_cpu_tier(previous);
+    }
+}
+
+TEST_CASE("CPU tier names round trip", "[dispatch]") {
+    for (auto tier : { CpuTier::scalar, CpuTier::sse42, CpuTier::avx2, CpuTier::avx512 }) {
+        REQUIRE(parse_cpu_tier(to_string(tier)) == tier);
+    }
+    REQUIRE_FALSE(parse_cpu_tier("avx3").has_value());
+    REQUIRE_FALSE(parse_cpu_tier("").has_value());
+}
+
+TEST_CASE("The environment override only lowers the tier", "[dispatch]") {
+    REQUIRE(detail::initial_cpu_tier(nullptr, CpuTier::avx2) == CpuTier::avx2);
+    REQUIRE(detail::initial_cpu_tier("scalar", CpuTier::avx2) == CpuTier::scalar);
+    REQUIRE(detail::initial_cpu_tier("sse4.2", CpuTier::avx2) == CpuTier::sse42);
+    REQUIRE(detail::initial_cpu_tier("avx512", CpuTier::avx2) == CpuTier::avx2);
+    REQUIRE(detail::initial_cpu_tier("fastest", CpuTier::avx2) == CpuTier::avx2);
+}
+
+TEST_CASE("Forced tiers are clamped to the detected one", "[dispatch]") {
+    auto const previous = set_cpu_tier(CpuTier::scalar);
+    REQUIRE(cpu_tier() == CpuTier::scalar);
+    set_cpu_tier(CpuTier::avx512);
+    REQUIRE(cpu_tier() == detected_cpu_tier());
+    set_cpu_tier(previous);
+}
+
+TEST_CASE("Batch kernels match the scalar functions bit for bit at every tier", "[dispatch]") {
+    // odd count, so vectorised loops run their remainder
+    auto const count = std::size_t(1037);
+    detail::Pcg32 rng(7);
+    auto const value = [&rng] { return (rng.uniform() - FLOAT(0.5)) * 200; };
+
+    std::vector<Vec3f> vectors(count);
+    std::vector<Point3f> points(count);
+    std::vector<Normal3f> normals(count);
+    std::vector<Matrix4x4f> a(count, Matrix4x4f::identity()), b(count, Matrix4x4f::identity());
+    for (std::size_t i = 0; i < count; ++i) {
+        vectors[i] = Vec3f{ value(), value(), value() };
+        points[i] = Point3f{ value(), value(), value() };
+        normals[i] = vectors[i].normalise();
+        for (int r = 0; r < 4; ++r) {
+            for (int c = 0; c < 4; ++c) {
+                a[i](r, c) = value();
+                b[i](r, c) = value();
+            }
+        }
+    }
+    auto transform = Transform{};
+    transform.translate({ 1, -2, 3 }).rotate({ 1, 1, 0 }, 37).scale({ 2, 0.5f, 3 });
+    auto const projection = Transform{}.perspective(60, 1.5f, 0.1f, 100);
+
+    for_each_tier([&] {
+        std::vector<Matrix4x4f> products(count, Matrix4x4f::identity());
+        multiply(a, b, products.data());
+        for (std::size_t i = 0; i < count; ++i) REQUIRE(bitwise_equal(products[i], a[i] * b[i]));
+
+        std::vector<Point3f> moved(count);
+        transform.apply(Span<Point3f const>(points), moved.data());
+        for (std::size_t i = 0; i < count; ++i) REQUIRE(bitwise_equal(moved[i], transform.apply(points[i])));
+        projection.apply(Span<Point3f const>(points), moved.data());
+        for (std::size_t i = 0; i < count; ++i) REQUIRE(bitwise_equal(moved[i], projection.apply(points[i])));
+
+        std::vector<Vec3f> directions(count);
+        transform.apply(Span<Vec3f const>(vectors), directions.data());
+        for (std::size_t i = 0; i < count; ++i) REQUIRE(bitwise_equal(directions[i], transform.apply(vectors[i])));
+
+        std::vector<Normal3f> unit(count);
+        transform.apply(Span<Normal3f const>(normals), unit.data());
+        for (std::size_t i = 0; i < count; ++i) REQUIRE(bitwise_equal(unit[i], transform.apply(normals[i])));
+        normalise(vectors, unit.data());
+        for (std::size_t i = 0; i < count; ++i) REQUIRE(bitwise_equal(unit[i], vectors[i].normalise()));
+
+        std::vector<Color3f> colors(count);
+        xyz_to_linear_srgb(vectors, colors.data());
+        for (std::size_t i = 0; i < count; ++i) REQUIRE(bitwise_equal(colors[i], xyz_to_linear_srgb(vectors[i])));
+    });
+}
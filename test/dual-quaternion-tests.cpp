@@ -0,0 +1,107 @@
+#include <graphics-math.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using namespace gm;
+
+namespace {
+    auto rigid(Vec3f const& axis, float angle, Vec3f const& translation) -> Transform {
+        return Transform{}.translate(translation).rotate(axis, angle);
+    }
+}
+
+TEST_CASE("Dual quaternions from rigid transforms", "[dual-quaternion]") {
+    auto const points = { Point3f{ 1, 2, 3 }, Point3f{ -4, 0.5f, 2 }, Point3f{ 0, 0, 0 } };
+
+    // cover every branch of the matrix to quaternion conversion
+    for (auto const& axis : { Vec3f{ 1, 0, 0 }, Vec3f{ 0, 1, 0 }, Vec3f{ 0, 0, 1 }, Vec3f{ 1, 2, -1 } }) {
+        for (auto const angle : { 0.0f, 30.0f, 179.0f, 270.0f }) {
+            auto const transform = rigid(axis, angle, Vec3f{ 3, -2, 5 });
+            auto const dq = DualQuaternion::from_transform(transform);
+            REQUIRE(dq.has_value());
+            for (auto const& p : points) REQUIRE(approx_equal((*dq)(p), transform.apply(p), AbsoluteTolerance{ 1e-4f }));
+
+            auto const back = dq->to_transform();
+            REQUIRE(approx_equal(back.matrix(), transform.matrix(), AbsoluteTolerance{ 1e-4f }));
+            REQUIRE(approx_equal(back.inverse(), transform.inverse(), AbsoluteTolerance{ 1e-4f }));
+        }
+    }
+
+    REQUIRE_FALSE(DualQuaternion::from_transform(Transform{}.scale(Vec3f{ 2, 2, 2 })).has_value());
+    REQUIRE_FALSE(DualQuaternion::from_transform(Transform{}.scale(Vec3f{ -1, 1, 1 })).has_value());
+}
+
+TEST_CASE("Dual quaternion composition", "[dual-quaternion]") {
+    auto const a = rigid(Vec3f{ 0, 1, 0 }, 40.0f, Vec3f{ 1, 0, 0 });
+    auto const b = rigid(Vec3f{ 1, 0, 1 }, -75.0f, Vec3f{ 0, 2, -1 });
+    auto const composed = *DualQuaternion::from_transform(a) * *DualQuaternion::from_transform(b);
+    auto const p = Point3f{ 0.5f, -1, 2 };
+    REQUIRE(approx_equal(composed(p), a.apply(b.apply(p)), AbsoluteTolerance{ 1e-4f }));
+}
+
+TEST_CASE("Dual quaternion skinning", "[dual-quaternion]") {
+    auto const quarter = *DualQuaternion::from_transform(rigid(Vec3f{ 0, 0, 1 }, 90.0f, Vec3f{ 0, 0, 0 }));
+    std::vector<DualQuaternion> const bones = {
+        DualQuaternion{},
+        quarter,
+        // the same transform as bone 1 from the opposite hemisphere
+        quarter * -1.0f,
+        *DualQuaternion::from_transform(rigid(Vec3f{ 1, 1, 0 }, 20.0f, Vec3f{ 0, 0, 4 })),
+    };
+
+    SECTION("Blending preserves length") {
+        std::vector<Point3f> const in = { { 2, 0, 0 } };
+        std::vector<BoneInfluences> const influences = { { { 0, 1, 0, 0 }, { 0.5f, 0.5f, 0, 0 } } };
+        std::vector<Point3f> out(1);
+        skin(bones, influences, in, out.data());
+        auto const r = std::sqrt(2.0f);
+        REQUIRE(approx_equal(out[0], Point3f{ r, r, 0 }, AbsoluteTolerance{ 1e-5f }));
+    }
+
+    SECTION("Antipodal bones blend to the same transform") {
+        std::vector<Point3f> const in = { { 2, 0, 0 } };
+        std::vector<BoneInfluences> const influences = { { { 1, 2, 0, 0 }, { 0.5f, 0.5f, 0, 0 } } };
+        std::vector<Point3f> out(1);
+        skin(bones, influences, in, out.data());
+        REQUIRE(approx_equal(out[0], Point3f{ 0, 2, 0 }, AbsoluteTolerance{ 1e-5f }));
+    }
+
+    SECTION("Batched kernels match per vertex blending") {
+        constexpr std::size_t count = 20000;
+        std::vector<Point3f> points(count);
+        std::vector<Normal3f> normals(count);
+        std::vector<BoneInfluences> influences(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            auto const f = static_cast<float>(i) / count;
+            points[i] = Point3f{ f, 1 - f, 2 * f };
+            normals[i] = Vec3f{ 1 - f, f, 0.5f }.normalise();
+            auto const w = 0.25f + 0.5f * f;
+            influences[i] = { { static_cast<std::uint16_t>(i % 4), static_cast<std::uint16_t>((i + 1) % 4), 3, 0 }, { w, 0.75f - w, 0.25f, 0 } };
+        }
+
+        std::vector<Point3f> out_points(count), combined_points(count);
+        std::vector<Normal3f> out_normals(count), combined_normals(count);
+        skin(bones, influences, points, out_points.data());
+        skin(bones, influences, normals, out_normals.data());
+        skin(bones, influences, points, normals, combined_points.data(), combined_normals.data());
+
+        for (std::size_t i = 0; i < count; i += 97) {
+            auto const& b = influences[i];
+            auto const pivot = bones[b.bones[0]].real;
+            DualQuaternion sum{ Quaternion{ Vec3f{}, 0 }, Quaternion{ Vec3f{}, 0 } };
+            for (int k = 0; k < 4; ++k) {
+                auto const& bone = bones[b.bones[k]];
+                sum = sum + bone * (pivot.dot(bone.real) < 0 ? -b.weights[k] : b.weights[k]);
+            }
+            auto const blended = sum.normalise();
+            REQUIRE(approx_equal(out_points[i], blended(points[i]), AbsoluteTolerance{ 1e-5f }));
+            REQUIRE(out_normals[i] == blended(normals[i]));
+            REQUIRE(ExactEqual{}(combined_points[i], out_points[i]));
+            REQUIRE(ExactEqual{}(combined_normals[i], out_normals[i]));
+        }
+    }
+}
@@ -0,0 +1,108 @@
+#include <graphics-math.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+using namespace gm;
+
+namespace {
+    auto angle_degrees(Normal3f const& a, Normal3f const& b) -> double {
+        // in double precision, a float dot product alone cannot resolve small angles
+        double const ax = a.x(), ay = a.y(), az = a.z(), bx = b.x(), by = b.y(), bz = b.z();
+        auto const cx = ay * bz - az * by, cy = az * bx - ax * bz, cz = ax * by - ay * bx;
+        auto const sin_theta = std::sqrt(cx * cx + cy * cy + cz * cz);
+        return std::atan2(sin_theta, ax * bx + ay * by + az * bz) * 180.0 / 3.14159265358979323846;
+    }
+
+    auto test_normals() -> std::vector<Normal3f> {
+        std::vector<Point2f> u(1 << 14);
+        sobol_2d(0, u.size(), u.data(), 5);
+        std::vector<Normal3f> normals;
+        for (auto const& p : u) normals.push_back(sample_uniform_sphere(p).normalise());
+        // the axes and the octahedron seams
+        for (auto const& v : { Vec3f{1, 0, 0}, Vec3f{-1, 0, 0}, Vec3f{0, 1, 0}, Vec3f{0, -1, 0},
+                               Vec3f{0, 0, 1}, Vec3f{0, 0, -1}, Vec3f{1, 1, 0}, Vec3f{-1, 1, -1e-7f} }) {
+            normals.push_back(v.normalise());
+        }
+        return normals;
+    }
+}
+
+TEMPLATE_TEST_CASE("Octahedral encoding error bounds", "[encoding]", std::int8_t, std::int16_t) {
+    // maximum angular error in degrees, rounding and precise
+    auto const bound = sizeof(TestType) == 1 ? 1.5 : 0.006;
+    auto const precise_bound = sizeof(TestType) == 1 ? 0.85 : 0.0035;
+
+    auto const normals = test_normals();
+    std::vector<Octahedral<TestType>> encoded(normals.size());
+    std::vector<Normal3f> decoded(normals.size());
+    encode_octahedral(normals.data(), encoded.data(), normals.size());
+    decode_octahedral(encoded.data(), decoded.data(), normals.size());
+
+    auto max_error = 0.0, max_precise_error = 0.0;
+    for (std::size_t i = 0; i < normals.size(); ++i) {
+        REQUIRE(encoded[i] == encode_octahedral<TestType>(normals[i]));
+        max_error = std::max(max_error, angle_degrees(decoded[i], normals[i]));
+        auto const precise = decode_octahedral(encode_octahedral_precise<TestType>(normals[i]));
+        max_precise_error = std::max(max_precise_error, angle_degrees(precise, normals[i]));
+    }
+    REQUIRE(max_error < bound);
+    REQUIRE(max_precise_error < precise_bound);
+    REQUIRE(max_precise_error <= max_error);
+
+    REQUIRE(decode_octahedral(encode_octahedral<TestType>(Vec3f{0, 0, -1}.normalise())) == Vec3f{0, 0, -1}.normalise());
+}
+
+TEST_CASE("Half precision conversion", "[encoding]") {
+    SECTION("exactly representable values") {
+        for (float v : { 0.0f, -0.0f, 1.0f, -2.5f, 0.099975586f, 65504.0f, 6.1035156e-05f, 5.9604645e-08f }) {
+            REQUIRE(static_cast<float>(Half{ v }) == v);
+        }
+        REQUIRE(Half{ 1.0f }.bits() == 0x3c00);
+        REQUIRE(Half{ -2.0f }.bits() == 0xc000);
+    }
+
+    SECTION("rounding and range") {
+        REQUIRE(Half{ 1.0f + 1.0f / 4096 }.bits() == 0x3c00); // ties to even
+        REQUIRE(Half{ 1.0f + 3.0f / 4096 }.bits() == 0x3c01);
+        REQUIRE(Half{ 1.0f + 6.0f / 4096 }.bits() == 0x3c02); // ties to even
+        REQUIRE(Half{ 1e6f }.bits() == 0x7c00);
+        REQUIRE(Half{ -std::numeric_limits<float>::infinity() }.bits() == 0xfc00);
+        REQUIRE(std::isnan(static_cast<float>(Half{ std::numeric_limits<float>::quiet_NaN() })));
+        REQUIRE(static_cast<float>(Half{ 1e-9f }) == 0.0f);
+
+        for (float v = 1e-4f; v < 6e4f; v *= 1.37f) {
+            REQUIRE(std::abs(static_cast<float>(Half{ v }) - v) <= v * (1.0f / 2048));
+        }
+    }
+
+    SECTION("batch conversion matches scalar") {
+        std::vector<Vec3f> vectors;
+        std::vector<Color3f> colors;
+        for (int i = 0; i < 37; ++i) {
+            vectors.push_back(Vec3f{ i * 0.37f, -i * 11.1f, 1.0f / (i + 1) });
+            colors.push_back(Color3f{ i * 0.01f, i * 3.3f, 0.5f });
+        }
+        std::vector<Vec3h> half_vectors(vectors.size());
+        std::vector<Color3h> half_colors(colors.size());
+        std::vector<Vec3f> vectors_out(vectors.size());
+        std::vector<Color3f> colors_out(colors.size());
+        encode_half(vectors.data(), half_vectors.data(), vectors.size());
+        encode_half(colors.data(), half_colors.data(), colors.size());
+        decode_half(half_vectors.data(), vectors_out.data(), vectors.size());
+        decode_half(half_colors.data(), colors_out.data(), colors.size());
+
+        for (std::size_t i = 0; i < vectors.size(); ++i) {
+            auto const expected = static_cast<Vec3f>(Vec3h{ vectors[i] });
+            REQUIRE(vectors_out[i].x == expected.x);
+            REQUIRE(vectors_out[i].y == expected.y);
+            REQUIRE(vectors_out[i].z == expected.z);
+            REQUIRE(colors_out[i].g == static_cast<Color3f>(Color3h{ colors[i] }).g);
+            REQUIRE(colors_out[i].r == Approx(colors[i].r).epsilon(1e-3));
+        }
+    }
+}
@@ -0,0 +1,104 @@
+#include <graphics-math.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <thread>
+#include <vector>
+
+using namespace gm;
+
+TEST_CASE("Film reconstruction", "[Film]") {
+    SECTION("box filter") {
+        auto film = Film(4, 3, Filter::box());
+        auto tile = film.make_tile(film.tiles().front());
+        tile.add_sample(Point2f{ 2.5f, 1.5f }, Color3f{ 1, 2, 3 });
+        tile.add_sample(Point2f{ 2.7f, 1.2f }, Color3f{ 3, 2, 1 });
+        film.merge(tile);
+        REQUIRE(film.pixel(2, 1) == Color3f{ 2, 2, 2 });
+        REQUIRE(film.pixel(1, 1).is_black());
+    }
+
+    SECTION("wide filters spread over neighbours") {
+        for (auto const& filter : { Filter::triangle(), Filter::gaussian(), Filter::mitchell() }) {
+            auto film = Film(5, 5, filter);
+            auto tile = film.make_tile(film.tiles().front());
+            tile.add_sample(Point2f{ 2.5f, 2.5f }, Color3f{ 1 });
+            film.merge(tile);
+            REQUIRE(film.pixel(2, 2) == Color3f{ 1 });
+            REQUIRE(film.pixel(3, 2) == Color3f{ 1 });
+            REQUIRE(filter.evaluate(0) > filter.evaluate(1));
+            REQUIRE(filter.evaluate(filter.radius() + 1) == 0);
+        }
+    }
+}
+
+TEST_CASE("Concurrent tiles match serial accumulation", "[Film]") {
+    auto const width = 37, height = 29;
+    auto const filter = Filter::gaussian();
+
+    // deterministic samples per pixel, independent of which thread renders it
+    auto const render = [](FilmTile& tile) {
+        auto const& b = tile.bounds();
+        std::vector<Point2f> positions;
+        std::vector<Color3f> radiance;
+        for (int y = b.min.y; y < b.max.y; ++y) {
+            for (int x = b.min.x; x < b.max.x; ++x) {
+                for (int s = 0; s < 4; ++s) {
+                    positions.push_back(Point2f{ x + 0.25f + 0.5f * (s & 1), y + 0.25f + 0.5f * (s >> 1) });
+                    radiance.push_back(Color3f{ x * 0.1f, y * 0.1f, static_cast<FLOAT>(s) });
+                }
+            }
+        }
+        tile.add_samples(positions.data(), radiance.data(), positions.size());
+    };
+
+    auto serial = Film(width, height, filter, width + height);
+    auto whole = serial.make_tile(serial.tiles().front());
+    render(whole);
+    serial.merge(whole);
+
+    auto parallel = Film(width, height, filter, 8);
+    auto const tiles = parallel.tiles();
+    REQUIRE(tiles.size() == 5 * 4);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&, t] {
+            for (std::size_t i = t; i < tiles.size(); i += 4) {
+                auto tile = parallel.make_tile(tiles[i]);
+                render(tile);
+                parallel.merge(tile);
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    std::vector<Color3f> expected(width * height), result(width * height);
+    serial.resolve(expected.data());
+    parallel.resolve(result.data());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        REQUIRE(result[i].r == Approx(expected[i].r).margin(1e-4));
+        REQUIRE(result[i].g == Approx(expected[i].g).margin(1e-4));
+        REQUIRE(result[i].b == Approx(expected[i].b).margin(1e-4));
+    }
+}
+
+TEST_CASE("Concurrent splatting", "[Film]") {
+    auto film = Film(16, 16, Filter::triangle(1));
+    auto const splats_per_thread = 2000;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&film, t] {
+            for (int i = 0; i < splats_per_thread; ++i) {
+                film.add_splat(Point2f{ 4 + (i % 7) * 1.1f, 3 + t * 2.3f }, Color3f{ 1, 0.5f, 0 });
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    auto total = Color3f{};
+    for (int y = 0; y < film.height(); ++y)
+        for (int x = 0; x < film.width(); ++x)
+            total += film.pixel(x, y, 0.5f);
+    REQUIRE(total.r == Approx(0.5f * 4 * splats_per_thread).epsilon(1e-4));
+    REQUIRE(total.g == Approx(0.25f * 4 * splats_per_thread).epsilon(1e-4));
+}
@@ -0,0 +1,4 @@
+// Compiles the whole library with FLOAT=double, set by the build
+#include <graphics-math.hpp>
+
+static_assert(sizeof(gm::Vec3f) == 3 * sizeof(double));
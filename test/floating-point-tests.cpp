@@ -0,0 +1,54 @@
+#include <graphics-math.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace gm;
+
+namespace {
+    auto multiply(float a, float b) -> float {
+        // keep the product out of constant folding
+        volatile float x = a;
+        return x * b;
+    }
+}
+
+TEST_CASE("Flush to zero is scoped", "[floating-point]") {
+    auto const tiny = std::numeric_limits<float>::min();
+    REQUIRE(multiply(tiny, 0.5f) != 0);
+
+    if (ScopedFlushToZero::supported()) {
+        ScopedFlushToZero guard;
+        REQUIRE(multiply(tiny, 0.5f) == 0);
+    }
+
+    REQUIRE(multiply(tiny, 0.5f) != 0);
+}
+
+TEST_CASE("Sanitizing kernels", "[floating-point]") {
+    auto const nan = std::numeric_limits<float>::quiet_NaN();
+    auto const inf = std::numeric_limits<float>::infinity();
+    auto const denormal = std::numeric_limits<float>::denorm_min() * 3;
+
+    std::vector<Vec3f> vectors{ { nan, 1, -inf }, { denormal, -denormal, 2 }, { 0, -0.0f, std::numeric_limits<float>::max() } };
+    REQUIRE(flush_nonfinite(vectors) == 2);
+    REQUIRE(vectors[0].x == 0);
+    REQUIRE(vectors[0].z == 0);
+    REQUIRE(vectors[0].y == 1);
+
+    REQUIRE(clamp_denormals(vectors) == 2);
+    REQUIRE(vectors[1].x == 0);
+    REQUIRE(std::signbit(vectors[1].y));
+    REQUIRE(vectors[1].z == 2);
+    REQUIRE(vectors[2].z == std::numeric_limits<float>::max());
+
+    std::vector<Color3f> colors{ { inf, denormal, 0.5f } };
+    REQUIRE(flush_nonfinite(colors, 1.0f) == 1);
+    REQUIRE(clamp_denormals(colors) == 1);
+    REQUIRE(colors[0].r == 1);
+    REQUIRE(colors[0].g == 0);
+    REQUIRE(colors[0].b == 0.5f);
+}
@@ -0,0 +1,105 @@
+#include <graphics-math.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace gm;
+
+namespace {
+    template<typename Value>
+    auto format(Value const& value) -> std::string {
+        char buffer[formatted_size_v<Value>];
+        auto const result = to_chars(buffer, buffer + sizeof(buffer), value);
+        REQUIRE(result.ec == std::errc{});
+        return std::string(buffer, result.ptr);
+    }
+
+    template<typename Value>
+    auto parse(std::string const& text, Value& value) -> bool {
+        auto const result = from_chars(text.data(), text.data() + text.size(), value);
+        return result.ec == std::errc{} && result.ptr == text.data() + text.size();
+    }
+
+    auto from_bits(std::uint32_t bits) -> float {
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+}
+
+TEST_CASE("Values format like operator<< without the newline", "[format]") {
+    REQUIRE(format(Vec3f{ 1, -2.5f, 0 }) == "[1,-2.5,0]");
+    REQUIRE(format(Point3f{ 0.1f, 2, 3 }) == "(0.1,2,3)");
+    REQUIRE(format(Color3f{ 0.25f, 0.5f, 1 }) == "(0.25,0.5,1)");
+    REQUIRE(format(Vec3f{ 0, 0, 2 }.normalise()) == "[0,0,1]");
+    REQUIRE(format(Vec3<std::int32_t>{ -2147483647 - 1, 0, 7 }) == "[-2147483648,0,7]");
+    REQUIRE(format(Matrix4x4f::identity()) == "[[1,0,0,0],[0,1,0,0],[0,0,1,0],[0,0,0,1]]");
+}
+
+TEST_CASE("Formatting round trips exactly", "[format]") {
+    // bit patterns spread over the normal float range, some standard
+    // libraries report subnormals as out of range
+    for (std::uint32_t bits = 0x00800000u; bits < 0x7f800000u; bits += 0x000f1a2bu) {
+        auto const x = from_bits(bits);
+        auto const v = Vec3f{ x, -x, std::numeric_limits<float>::max() };
+        Vec3f parsed;
+        REQUIRE(parse(format(v), parsed));
+        REQUIRE(std::memcmp(&parsed, &v, sizeof(v)) == 0);
+    }
+
+    auto const n = Vec3f{ 1, 2, 3 }.normalise();
+    Normal3f parsed_normal;
+    REQUIRE(parse(format(n), parsed_normal));
+    REQUIRE(std::memcmp(&parsed_normal, &n, sizeof(n)) == 0);
+
+    auto m = Matrix4x4f::identity();
+    for (int i = 0; i < 16; ++i) m(i / 4, i % 4) = from_bits(0x3dcccccdu + 977u * i) * (i % 3 == 0 ? -1 : 1);
+    auto parsed = Matrix4x4f::identity();
+    REQUIRE(parse(format(m), parsed));
+    REQUIRE(parsed == m);
+}
+
+TEST_CASE("Parsing", "[format]") {
+    Point3f p;
+    REQUIRE(parse("(1, 2, 3)", p));
+    REQUIRE(p == Point3f{ 1, 2, 3 });
+
+    SECTION("Rejects malformed input and leaves the value untouched") {
+        for (auto const* text : { "[1,2,3]", "(1,2)", "(1,2,3", "(1;2;3)", "", "(a,2,3)" }) {
+            REQUIRE_FALSE(parse(text, p));
+            REQUIRE(p == Point3f{ 1, 2, 3 });
+        }
+    }
+
+    SECTION("Too small buffers are reported") {
+        char buffer[8];
+        REQUIRE(to_chars(buffer, buffer + sizeof(buffer), Point3f{ 1, 2, 3 }).ec == std::errc{});
+        REQUIRE(to_chars(buffer, buffer + sizeof(buffer), Point3f{ 0.1f, 0.2f, 0.3f }).ec == std::errc::value_too_large);
+    }
+}
+
+TEST_CASE("Arrays dump and reload", "[format]") {
+    std::vector<Color3f> colors;
+    for (int i = 0; i < 1000; ++i) colors.emplace_back(i / 7.0f, 1.0f / (i + 1), -i * 1e-20f);
+
+    std::vector<char> text(colors.size() * (formatted_size_v<Color3f> + 1));
+    auto const written = to_chars(text.data(), text.data() + text.size(), colors.data(), colors.size());
+    REQUIRE(written.ec == std::errc{});
+
+    std::vector<Color3f> parsed(colors.size());
+    auto const read = from_chars(text.data(), written.ptr, parsed.data(), parsed.size());
+    REQUIRE(read.ec == std::errc{});
+    REQUIRE(read.ptr == written.ptr - 1);
+    REQUIRE(std::memcmp(parsed.data(), colors.data(), colors.size() * sizeof(Color3f)) == 0);
+}
+
+#if defined(GRAPHICS_MATH_FMT)
+TEST_CASE("{fmt} integration", "[format]") {
+    REQUIRE(fmt::format("{} {}", Vec3f{ 1, 2, 3 }, Point3f{ 0.5f, 0, 0 }) == "[1,2,3] (0.5,0,0)");
+}
+#endif
@@ -0,0 +1,90 @@
+#include <graphics-math.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+using namespace gm;
+
+namespace {
+    auto reference_morton(std::uint64_t const* coords, int dims, int bits) -> std::uint64_t {
+        std::uint64_t code = 0;
+        for (int b = 0; b < bits; ++b) {
+            for (int d = 0; d < dims; ++d) code |= ((coords[d] >> b) & 1) << (b * dims + d);
+        }
+        return code;
+    }
+}
+
+TEST_CASE("Floor division and modulo", "[grid]") {
+    REQUIRE(floor_div(7, 2) == 3);
+    REQUIRE(floor_div(-7, 2) == -4);
+    REQUIRE(floor_div(-8, 2) == -4);
+    REQUIRE(floor_div(7, -2) == -4);
+    REQUIRE(floor_mod(-7, 4) == 1);
+    REQUIRE(floor_mod(7, -4) == -1);
+    REQUIRE(floor_div(Point3i{ -1, 15, -16 }, 16) == Point3i{ -1, 0, -1 });
+    REQUIRE(floor_mod(Point3i{ -1, 15, -16 }, 16) == Point3i{ 15, 15, 0 });
+}
+
+TEST_CASE("Clamped grid conversion", "[grid]") {
+    REQUIRE(floor_to_int(-0.5f) == -1);
+    REQUIRE(floor_to_int(1e20f) == std::numeric_limits<int>::max() / 128 * 128);
+    REQUIRE(floor_to_int(-1e20f) == std::numeric_limits<int>::min());
+    REQUIRE(floor_to_int(std::numeric_limits<float>::quiet_NaN()) == 0);
+
+    auto const resolution = Point3i{ 4, 8, 16 };
+    REQUIRE(to_grid(Point3f{ 1.5f, 7.99f, 0 }, resolution) == Point3i{ 1, 7, 0 });
+    REQUIRE(to_grid(Point3f{ -3, 8, 1e30f }, resolution) == Point3i{ 0, 7, 15 });
+    REQUIRE(to_grid(Point2f{ 2.5f, -1 }, Point2i{ 2, 2 }) == Point2i{ 1, 0 });
+}
+
+TEST_CASE("Morton codes", "[grid]") {
+    std::srand(7);
+    for (int i = 0; i < 1000; ++i) {
+        std::uint64_t const c3[] = { std::uint64_t(std::rand()) & 0x1fffff, std::uint64_t(std::rand()) & 0x1fffff, std::uint64_t(std::rand()) & 0x1fffff };
+        auto const p3 = Point3i{ int(c3[0]), int(c3[1]), int(c3[2]) };
+        REQUIRE(morton_encode(p3) == reference_morton(c3, 3, 21));
+        REQUIRE(morton_decode_3d(morton_encode(p3)) == p3);
+
+        std::uint64_t const c2[] = { std::uint64_t(std::rand()) & 0x7fffffff, std::uint64_t(std::rand()) & 0x7fffffff };
+        auto const p2 = Point2i{ int(c2[0]), int(c2[1]) };
+        REQUIRE(morton_encode(p2) == reference_morton(c2, 2, 31));
+        REQUIRE(morton_decode_2d(morton_encode(p2)) == p2);
+    }
+}
+
+TEST_CASE("Hilbert curves visit every cell through face neighbours", "[grid]") {
+    SECTION("2D") {
+        int const order = 5, side = 1 << order;
+        std::vector<bool> visited(side * side);
+        auto previous = hilbert_decode_2d(0, order);
+        REQUIRE(previous == Point2i{ 0, 0 });
+        for (std::uint64_t i = 0; i < std::uint64_t(side * side); ++i) {
+            auto const p = hilbert_decode_2d(i, order);
+            REQUIRE(hilbert_encode(p, order) == i);
+            REQUIRE(std::abs(p.x - previous.x) + std::abs(p.y - previous.y) == (i == 0 ? 0 : 1));
+            REQUIRE_FALSE(visited[p.y * side + p.x]);
+            visited[p.y * side + p.x] = true;
+            previous = p;
+        }
+    }
+
+    SECTION("3D") {
+        int const order = 4, side = 1 << order;
+        std::vector<bool> visited(side * side * side);
+        auto previous = hilbert_decode_3d(0, order);
+        REQUIRE(previous == Point3i{ 0, 0, 0 });
+        for (std::uint64_t i = 0; i < std::uint64_t(side * side * side); ++i) {
+            auto const p = hilbert_decode_3d(i, order);
+            REQUIRE(hilbert_encode(p, order) == i);
+            REQUIRE(std::abs(p.x - previous.x) + std::abs(p.y - previous.y) + std::abs(p.z - previous.z) == (i == 0 ? 0 : 1));
+            REQUIRE_FALSE(visited[(p.z * side + p.y) * side + p.x]);
+            visited[(p.z * side + p.y) * side + p.x] = true;
+            previous = p;
+        }
+    }
+}
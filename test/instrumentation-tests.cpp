@@ -0,0 +1,69 @@
+#include <graphics-math.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <limits>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace gm;
+using instrumentation::Counter;
+
+TEST_CASE("Hot paths are counted", "[instrumentation]") {
+    instrumentation::reset();
+
+    auto transform = Transform{};
+    transform.translate({ 1, 2, 3 }).scale({ 2, 0, 1 });
+    auto const p = transform.apply(Point3f{ 1, 1, 1 });
+    auto const n = Vec3f{ 0, 3, 4 }.normalise();
+    auto const roots = solve_quadratic(1.0f, -3.0f, 2.0f);
+    (void)p; (void)n; (void)roots;
+
+    auto const report = instrumentation::report();
+    REQUIRE(report[Counter::transform_apply] == 1);
+    REQUIRE(report[Counter::normalise] == 1);
+    REQUIRE(report[Counter::solve_quadratic] == 1);
+    REQUIRE(report[Counter::singular_scale] == 1);
+    REQUIRE(report[Counter::nan] == 0);
+}
+
+TEST_CASE("Numeric events are recorded", "[instrumentation]") {
+    instrumentation::reset();
+
+    // inf / inf
+    (void)Vec3f{ std::numeric_limits<float>::infinity(), 0, 0 }.normalise();
+    (void)Transform{}.scale({ 2, 2, 2 }).apply(Vec3f{ std::numeric_limits<float>::max(), 0, 0 });
+    (void)Transform{}.apply(Vec3f{ 1e-40f, 1, 0 });
+
+    auto const report = instrumentation::report();
+    REQUIRE(report[Counter::nan] == 1);
+    REQUIRE(report[Counter::infinity] == 1);
+    REQUIRE(report[Counter::denormal] == 1);
+
+    std::ostringstream text;
+    text << report;
+    REQUIRE(text.str().find("infinity: 1\n") != std::string::npos);
+}
+
+TEST_CASE("Counts from every thread are aggregated", "[instrumentation]") {
+    instrumentation::reset();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([] {
+            for (int i = 0; i < 1000; ++i) (void)Vec3f{ 1, 2, 3 }.normalise();
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    // finished threads keep their counts
+    REQUIRE(instrumentation::report()[Counter::normalise] == 4000);
+}
+
+TEST_CASE("Constant evaluation is unaffected", "[instrumentation]") {
+    instrumentation::reset();
+    auto constexpr n = Vec3f{ 0, 0, 2 }.normalise();
+    REQUIRE(n.z() == 1);
+    REQUIRE(instrumentation::report()[Counter::normalise] == 0);
+}
@@ -0,0 +1,77 @@
+#include <graphics-math.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <vector>
+
+using namespace gm;
+
+namespace {
+    auto make_transform(int i) -> Transform {
+        return Transform{}.translate(Vec3f{ static_cast<float>(i), 0.0f, 1.0f }).scale(Vec3f{ 2.0f, 2.0f, 2.0f });
+    }
+}
+
+TEST_CASE("Intern cache deduplicates transforms", "[intern-cache]") {
+    TransformCache cache;
+    auto const a = cache.intern(make_transform(1));
+    auto const b = cache.intern(make_transform(2));
+    REQUIRE(a != b);
+    REQUIRE(cache.intern(make_transform(1)) == a);
+    REQUIRE(cache.size() == 2);
+    REQUIRE(ExactEqual{}(cache[b], make_transform(2)));
+    REQUIRE(cache.find(make_transform(2)) == b);
+    REQUIRE_FALSE(cache.find(make_transform(3)).has_value());
+
+    auto const stats = cache.stats();
+    REQUIRE(stats.lookups == 3);
+    REQUIRE(stats.hits == 1);
+    REQUIRE(stats.unique == 2);
+    REQUIRE(stats.hit_rate() == Approx(1.0 / 3.0));
+}
+
+TEST_CASE("Intern cache snaps to a quantum", "[intern-cache]") {
+    MatrixCache cache(1e-4f);
+    auto m = Matrix4x4f::identity();
+    auto const a = cache.intern(m);
+    m(0, 3) = 1e-6f;
+    REQUIRE(cache.intern(m) == a);
+    m(1, 1) = -0.0f;
+    m(2, 2) = 0.0f;
+    auto const b = cache.intern(m);
+    m(1, 1) = 0.0f;
+    REQUIRE(cache.intern(m) == b);
+    REQUIRE(cache.size() == 2);
+    REQUIRE(cache[a] == Matrix4x4f::identity());
+}
+
+TEST_CASE("Intern cache handles span many blocks", "[intern-cache]") {
+    MatrixCache cache;
+    std::vector<MatrixCache::Handle> handles;
+    for (int i = 0; i < 5000; ++i) {
+        auto m = Matrix4x4f::identity();
+        m(0, 3) = static_cast<float>(i);
+        handles.push_back(cache.intern(m));
+    }
+    for (int i = 0; i < 5000; ++i) {
+        REQUIRE(handles[i] == static_cast<MatrixCache::Handle>(i));
+        REQUIRE(cache[handles[i]](0, 3) == static_cast<float>(i));
+    }
+}
+
+TEST_CASE("Intern cache supports concurrent insertion", "[intern-cache]") {
+    TransformCache cache;
+    constexpr std::size_t count = 40000, unique = 1000;
+    std::vector<TransformCache::Handle> handles(count);
+    parallel_chunks(count, 4, [&](std::size_t, std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i) handles[i] = cache.intern(make_transform(static_cast<int>(i % unique)));
+    });
+
+    REQUIRE(cache.size() == unique);
+    REQUIRE(cache.stats().hits == count - unique);
+    for (std::size_t i = 0; i < count; ++i) {
+        REQUIRE(handles[i] == handles[i % unique]);
+        REQUIRE(ExactEqual{}(cache[handles[i]], make_transform(static_cast<int>(i % unique))));
+    }
+}
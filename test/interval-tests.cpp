@@ -0,0 +1,77 @@
+#include <graphics-math.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <limits>
+#include <random>
+
+using namespace gm;
+
+TEST_CASE("Interval arithmetic contains exact results", "[interval]") {
+    Intervalf const a{ 1.0f, 2.0f }, b{ -3.0f, 0.5f };
+
+    auto const sum = a + b;
+    REQUIRE(sum.low <= -2.0f);
+    REQUIRE(sum.high >= 2.5f);
+    auto const product = a * b;
+    REQUIRE(product.low <= -6.0f);
+    REQUIRE(product.high >= 1.0f);
+    auto const quotient = b / a;
+    REQUIRE(quotient.low <= -3.0f);
+    REQUIRE(quotient.high >= 0.5f);
+    REQUIRE((a / b).width() == std::numeric_limits<float>::infinity());
+    REQUIRE(-a == Intervalf{ -2.0f, -1.0f });
+    REQUIRE(hull(a, b) == Intervalf{ -3.0f, 2.0f });
+
+    // 0.1 is not representable, the bounds must straddle the real sum
+    auto const tenth = Intervalf{ 0.1f } + Intervalf{ 0.2f };
+    REQUIRE(tenth.low < tenth.high);
+    REQUIRE(static_cast<double>(tenth.low) <= 0.1 + 0.2);
+    REQUIRE(static_cast<double>(tenth.high) >= 0.1 + 0.2);
+
+    REQUIRE(detail::next_up(0.0f) == std::numeric_limits<float>::denorm_min());
+    REQUIRE(detail::next_down(-0.0f) == -std::numeric_limits<float>::denorm_min());
+    REQUIRE(detail::next_up(std::numeric_limits<float>::infinity()) == std::numeric_limits<float>::infinity());
+    REQUIRE(detail::next_up(-std::numeric_limits<float>::infinity()) == -std::numeric_limits<float>::max());
+}
+
+TEST_CASE("Vectors and matrices over intervals", "[interval]") {
+    Vec3fi const v{ Intervalf{ 1.0f, 2.0f }, Intervalf{ 0.0f }, Intervalf{ -1.0f, 1.0f } };
+    auto const d = v.dot(v);
+    REQUIRE(d.contains(1.0f));
+    REQUIRE(d.contains(5.0f));
+    REQUIRE(v == v);
+
+    auto const m = Matrix4x4<Intervalf>::identity() * Matrix4x4<Intervalf>::fill_with(Intervalf{ 1.0f, 2.0f });
+    REQUIRE(m(1, 2).contains(1.0f));
+    REQUIRE(m(1, 2).contains(2.0f));
+}
+
+TEST_CASE("Transforming interval points bounds every point", "[interval]") {
+    auto const transform = Transform{}.translate(Vec3f{ 0.1f, -3.3f, 7.0f }).rotate(Vec3f{ 1, 2, 3 }, 37.0f).scale(Vec3f{ 0.3f, 1.7f, 2.0f });
+    auto const perspective = Transform{}.perspective(60.0f, 1.0f, 0.1f, 100.0f);
+    auto const lo = Point3f{ -1.0f, 0.5f, 2.0f }, hi = Point3f{ 0.25f, 1.5f, 3.0f };
+    auto const box = to_interval(lo, hi);
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (auto const& t : { transform, perspective }) {
+        auto const bounds = t.apply(box);
+        Point3fi batched;
+        t.apply(&box, &batched, 1);
+        REQUIRE(batched == bounds);
+
+        for (int i = 0; i < 1000; ++i) {
+            auto const p = Point3f{ lo.x + unit(rng) * (hi.x - lo.x), lo.y + unit(rng) * (hi.y - lo.y), lo.z + unit(rng) * (hi.z - lo.z) };
+            auto const q = t.apply(p);
+            REQUIRE(bounds.x.contains(q.x));
+            REQUIRE(bounds.y.contains(q.y));
+            REQUIRE(bounds.z.contains(q.z));
+        }
+        for (auto const& corner : { lo, hi }) {
+            auto const q = t.apply(corner);
+            REQUIRE(lower(bounds).x <= q.x);
+            REQUIRE(upper(bounds).z >= q.z);
+        }
+    }
+}
@@ -73,4 +73,51 @@ TEMPLATE_TEST_CASE(
 
     REQUIRE(m1 * m2 == result);
 
-}
\ No newline at end of file
+}
+
+TEMPLATE_TEST_CASE(
+    "Sparse composition matches dense multiplication", "[Matrix4x4]",
+    std::int32_t, std::int64_t,
+    float, double) {
+
+    auto constexpr base = gm::Matrix4x4<TestType>{
+         1,  2,  3,  4,
+         5,  6,  7,  8,
+         9, 10, 11, 12,
+        13, 14, 15, 16
+    };
+    auto constexpr translation = gm::Matrix4x4<TestType>{
+        1, 0, 0,  3,
+        0, 1, 0, -2,
+        0, 0, 1,  7,
+        0, 0, 0,  1
+    };
+    auto constexpr scale = gm::Matrix4x4<TestType>{
+        2, 0, 0, 0,
+        0, 5, 0, 0,
+        0, 0, 3, 0,
+        0, 0, 0, 1
+    };
+    auto constexpr rotation = gm::Matrix4x4<TestType>{
+        0, -1, 0, 0,
+        1,  0, 0, 0,
+        0,  0, 1, 0,
+        0,  0, 0, 1
+    };
+
+    SECTION("translate") {
+        auto post = base, pre = base;
+        REQUIRE(post.post_translate(3, -2, 7) == base * translation);
+        REQUIRE(pre.pre_translate(3, -2, 7) == translation * base);
+    }
+    SECTION("scale") {
+        auto post = base, pre = base;
+        REQUIRE(post.post_scale(2, 5, 3) == base * scale);
+        REQUIRE(pre.pre_scale(2, 5, 3) == scale * base);
+    }
+    SECTION("rotate") {
+        auto post = base, pre = base;
+        REQUIRE(post.post_rotate(rotation) == base * rotation);
+        REQUIRE(pre.pre_rotate(rotation) == rotation * base);
+    }
+}
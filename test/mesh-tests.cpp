@@ -0,0 +1,95 @@
+#include <graphics-math.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using namespace gm;
+
+namespace {
+    // unit quad in the xy plane, counter-clockwise seen from +z
+    std::vector<Point3f> const quad_positions = { { 0, 0, 0 }, { 1, 0, 0 }, { 1, 1, 0 }, { 0, 1, 0 } };
+    std::vector<std::uint32_t> const quad_indices = { 0, 1, 2, 0, 2, 3 };
+}
+
+TEST_CASE("Vertex normals", "[mesh]") {
+    SECTION("Planar") {
+        std::vector<Normal3f> normals(quad_positions.size());
+        vertex_normals(quad_positions, quad_indices, normals.data());
+        for (auto const& n : normals) REQUIRE(n == Vec3f(0, 0, 1).normalise());
+    }
+
+    SECTION("Area weighted") {
+        // a large triangle facing +z and a small one facing +x share vertex 0
+        std::vector<Point3f> const positions = { { 0, 0, 0 }, { 4, 0, 0 }, { 0, 4, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+        std::vector<std::uint32_t> const indices = { 0, 1, 2, 0, 3, 4 };
+        std::vector<Normal3f> normals(positions.size());
+        vertex_normals(positions, indices, normals.data());
+        REQUIRE(normals[0] == Vec3f(1, 0, 16).normalise());
+        REQUIRE(normals[1] == Vec3f(0, 0, 1).normalise());
+        REQUIRE(normals[4] == Vec3f(1, 0, 0).normalise());
+    }
+
+    SECTION("Unreferenced vertices") {
+        auto positions = quad_positions;
+        positions.push_back({ 5, 5, 5 });
+        std::vector<Normal3f> normals(positions.size());
+        vertex_normals(positions, quad_indices, normals.data());
+        REQUIRE(normals[4] == Normal3f{});
+    }
+}
+
+TEST_CASE("Vertex tangents", "[mesh]") {
+    std::vector<Normal3f> const normals(quad_positions.size(), Vec3f(0, 0, 1).normalise());
+    std::vector<Tangent> tangents(quad_positions.size());
+
+    SECTION("Aligned UVs") {
+        std::vector<Point2f> const uvs = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } };
+        vertex_tangents(quad_positions, normals, uvs, quad_indices, tangents.data());
+        for (std::size_t i = 0; i < tangents.size(); ++i) {
+            REQUIRE(tangents[i].direction == Vec3f(1, 0, 0).normalise());
+            REQUIRE(tangents[i].sign == 1);
+            auto const frame = tangents[i].frame(normals[i]);
+            REQUIRE(frame.v() == Vec3f(0, 1, 0).normalise());
+        }
+    }
+
+    SECTION("Mirrored UVs") {
+        std::vector<Point2f> const uvs = { { 1, 0 }, { 0, 0 }, { 0, 1 }, { 1, 1 } };
+        vertex_tangents(quad_positions, normals, uvs, quad_indices, tangents.data());
+        for (std::size_t i = 0; i < tangents.size(); ++i) {
+            REQUIRE(tangents[i].direction == Vec3f(-1, 0, 0).normalise());
+            REQUIRE(tangents[i].sign == -1);
+            REQUIRE(tangents[i].frame(normals[i]).v() == Vec3f(0, 1, 0).normalise());
+        }
+    }
+
+    SECTION("Degenerate UVs") {
+        std::vector<Point2f> const uvs(quad_positions.size(), Point2f{ 0.5f, 0.5f });
+        vertex_tangents(quad_positions, normals, uvs, quad_indices, tangents.data());
+        for (std::size_t i = 0; i < tangents.size(); ++i) {
+            REQUIRE(std::abs(dot(normals[i], Vec3f(tangents[i].direction))) < 1e-6f);
+        }
+    }
+}
+
+TEST_CASE("Triangle bounds", "[mesh]") {
+    std::vector<Point3f> const positions = { { 0, 0, 0 }, { 3, -1, 2 }, { 1, 4, -2 } };
+    std::vector<std::uint32_t> const indices = { 0, 1, 2, 2, 1, 0 };
+    TriangleBounds bounds;
+    triangle_bounds(positions, indices, bounds);
+    REQUIRE(bounds.size() == 2);
+    for (std::size_t t = 0; t < 2; ++t) {
+        REQUIRE(bounds.min_x[t] == 0);
+        REQUIRE(bounds.min_y[t] == -1);
+        REQUIRE(bounds.min_z[t] == -2);
+        REQUIRE(bounds.max_x[t] == 3);
+        REQUIRE(bounds.max_y[t] == 4);
+        REQUIRE(bounds.max_z[t] == 2);
+        REQUIRE(bounds.centroid_x[t] == Approx(4.0f / 3.0f));
+        REQUIRE(bounds.centroid_y[t] == Approx(1.0f));
+        REQUIRE(bounds.centroid_z[t] == Approx(0.0f));
+    }
+}
@@ -0,0 +1,136 @@
+#include <graphics-math.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace gm;
+
+namespace {
+    auto constexpr cubic = solve_cubic(1.0f, -6.0f, 11.0f, -6.0f);
+    static_assert(cubic.size() == 3);
+}
+
+TEST_CASE("Cubic roots", "[polynomial]") {
+    auto const three = solve_cubic(2.0f, -12.0f, 22.0f, -12.0f);
+    REQUIRE(three.size() == 3);
+    REQUIRE(three[0] == Approx(1.0f));
+    REQUIRE(three[1] == Approx(2.0f));
+    REQUIRE(three[2] == Approx(3.0f));
+    REQUIRE(cubic[1] == Approx(2.0f).margin(1e-3));
+
+    auto const one = solve_cubic(1.0f, 0.0f, 1.0f, 1.0f);
+    REQUIRE(one.size() == 1);
+    REQUIRE(one[0] == Approx(-0.6823278f));
+
+    // (x + 1)^2 (x - 2)
+    auto const repeated = solve_cubic(1.0, 0.0, -3.0, -2.0);
+    REQUIRE(repeated.size() >= 2);
+    REQUIRE(repeated[0] == Approx(-1.0).margin(1e-3));
+    REQUIRE(repeated[repeated.size() - 1] == Approx(2.0));
+
+    auto const quadratic = solve_cubic(0.0f, 1.0f, -3.0f, 2.0f);
+    REQUIRE(quadratic.size() == 2);
+    REQUIRE(quadratic[0] == Approx(1.0f));
+    REQUIRE(quadratic[1] == Approx(2.0f));
+}
+
+TEST_CASE("Quartic roots", "[polynomial]") {
+    // (x - 1)(x - 2)(x - 3)(x - 4)
+    auto const four = solve_quartic(1.0f, -10.0f, 35.0f, -50.0f, 24.0f);
+    REQUIRE(four.size() == 4);
+    for (std::size_t i = 0; i < 4; ++i) REQUIRE(four[i] == Approx(i + 1.0f).margin(1e-4));
+
+    // (x^2 + 1)(x - 1)(x + 2) = x^4 + x^3 - x^2 + x - 2
+    auto const two = solve_quartic(1.0f, 1.0f, -1.0f, 1.0f, -2.0f);
+    REQUIRE(two.size() == 2);
+    REQUIRE(two[0] == Approx(-2.0f));
+    REQUIRE(two[1] == Approx(1.0f));
+
+    REQUIRE(solve_quartic(1.0f, 0.0f, 0.0f, 0.0f, 1.0f).empty());
+
+    // x (x - 1)(x + 1)(x - 3)
+    auto const zero = solve_quartic(1.0f, -3.0f, -1.0f, 3.0f, 0.0f);
+    REQUIRE(zero.size() == 4);
+    REQUIRE(zero[0] == Approx(-1.0f));
+    REQUIRE(zero[1] == Approx(0.0f).margin(1e-6));
+    REQUIRE(zero[3] == Approx(3.0f));
+}
+
+TEST_CASE("Random quartics", "[polynomial]") {
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> root(-4.0f, 4.0f);
+    for (int i = 0; i < 1000; ++i) {
+        std::array<float, 4> r{ root(rng), root(rng), root(rng), root(rng) };
+        std::sort(r.begin(), r.end());
+        if (r[1] - r[0] < 0.1f || r[2] - r[1] < 0.1f || r[3] - r[2] < 0.1f) continue;
+        // expand (x - r0)(x - r1)(x - r2)(x - r3)
+        auto const b = -(r[0] + r[1] + r[2] + r[3]);
+        auto const c = r[0] * r[1] + r[0] * r[2] + r[0] * r[3] + r[1] * r[2] + r[1] * r[3] + r[2] * r[3];
+        auto const d = -(r[0] * r[1] * r[2] + r[0] * r[1] * r[3] + r[0] * r[2] * r[3] + r[1] * r[2] * r[3]);
+        auto const e = r[0] * r[1] * r[2] * r[3];
+        auto const roots = solve_quartic(1.0f, b, c, d, e);
+        REQUIRE(roots.size() == 4);
+        for (std::size_t k = 0; k < 4; ++k) {
+            // rounding the coefficients to float moves the roots, so compare
+            // with the exact roots of the rounded polynomial
+            auto x = static_cast<double>(r[k]);
+            for (int step = 0; step < 8; ++step) {
+                auto const f = (((x + b) * x + c) * x + d) * x + e;
+                auto const df = ((4 * x + 3.0 * b) * x + 2.0 * c) * x + d;
+                x -= f / df;
+            }
+            // float evaluation of the polynomial limits the attainable accuracy
+            auto const ax = std::abs(x);
+            auto const magnitude = (((ax + std::abs(b)) * ax + std::abs(c)) * ax + std::abs(d)) * ax + std::abs(e);
+            auto const df = ((4 * x + 3.0 * b) * x + 2.0 * c) * x + d;
+            auto const bound = 16 * std::numeric_limits<float>::epsilon() * magnitude / std::abs(df);
+            REQUIRE(roots[k] == Approx(x).margin(bound));
+        }
+    }
+}
+
+TEST_CASE("Newton bisection", "[polynomial]") {
+    auto const square_minus = [](std::size_t lane, float x) { return std::make_pair(x * x - float(lane + 1), 2 * x); };
+    auto const roots = newton_bisect<4>(square_minus, { 0.0f, 0.0f, 0.0f, 5.0f }, { 4.0f, 4.0f, 4.0f, 6.0f });
+    for (std::size_t lane = 0; lane < 3; ++lane) REQUIRE(roots[lane] == Approx(std::sqrt(float(lane + 1))));
+    REQUIRE(std::isnan(roots[3]));
+
+    // flat derivative at the start falls back to bisection
+    auto const cube = [](float x) { return std::make_pair(x * x * x - 0.5f, 3 * x * x); };
+    auto const root = newton_bisect(cube, -1.0f, 1.0f, 1e-6f);
+    REQUIRE(root.has_value());
+    REQUIRE(*root == Approx(std::cbrt(0.5f)));
+    REQUIRE_FALSE(newton_bisect(cube, 1.0f, 2.0f).has_value());
+
+    REQUIRE(evaluate_polynomial(2.0f, std::array<float, 3>{ 1.0f, -3.0f, 2.0f }) == 3.0f);
+}
+
+TEST_CASE("Bezier curves", "[polynomial]") {
+    std::array<Point3f, 4> const control{ Point3f{ 0, 0, 0 }, Point3f{ 1, 2, 0 }, Point3f{ 3, 2, 1 }, Point3f{ 4, 0, 1 } };
+    for (auto const t : { 0.0f, 0.3f, 0.5f, 1.0f }) {
+        auto expected = Point3f{};
+        for (int i = 0; i < 4; ++i) expected = expected + bernstein(i, 3, t) * control[i];
+        REQUIRE(approx_equal(bezier(control, t), expected, AbsoluteTolerance{ 1e-5f }));
+    }
+    REQUIRE(bezier(control, 0.0f) == control[0]);
+    REQUIRE(bezier(control, 1.0f) == control[3]);
+
+    auto const [left, right] = subdivide(control, 0.25f);
+    REQUIRE(left[0] == control[0]);
+    REQUIRE(right[3] == control[3]);
+    REQUIRE(left[3] == right[0]);
+    REQUIRE(approx_equal(bezier(left, 0.5f), bezier(control, 0.125f), AbsoluteTolerance{ 1e-5f }));
+    REQUIRE(approx_equal(bezier(right, 0.5f), bezier(control, 0.625f), AbsoluteTolerance{ 1e-5f }));
+
+    auto const derivative = bezier_derivative(control);
+    auto const h = 1e-3f;
+    auto const numeric = (bezier(control, 0.4f + h) - bezier(control, 0.4f - h)) / (2 * h);
+    REQUIRE(approx_equal(bezier(derivative, 0.4f), numeric, AbsoluteTolerance{ 1e-2f }));
+
+    REQUIRE(bezier(std::array<float, 3>{ 0.0f, 1.0f, 0.0f }, 0.5f) == 0.5f);
+}
@@ -0,0 +1,354 @@
+#include <graphics-math.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Randomized differential tests: every fast or batched path is compared with
+// a scalar or double precision reference over many generated inputs, and the
+// worst error is checked against a per function budget in ulps. Run with
+// `ctest -L property`; GRAPHICS_MATH_PROPERTY_SAMPLES overrides the number of
+// samples per property.
+
+using namespace gm;
+
+namespace {
+    auto samples() -> std::size_t {
+        static auto const count = [] {
+            auto const* value = std::getenv("GRAPHICS_MATH_PROPERTY_SAMPLES");
+            return value != nullptr ? static_cast<std::size_t>(std::strtoull(value, nullptr, 10)) : std::size_t(1) << 20;
+        }();
+        return count;
+    }
+
+    // Representable floats between a and b, +0 and -0 are the same
+    auto ulps(float a, float b) -> double {
+        if (std::isnan(a) || std::isnan(b)) return std::isnan(a) && std::isnan(b) ? 0 : INFINITY;
+        auto const ordered = [](float x) -> std::int64_t {
+            std::int32_t i;
+            std::memcpy(&i, &x, sizeof(x));
+            return i < 0 ? std::int64_t(std::numeric_limits<std::int32_t>::min()) - i : i;
+        };
+        return static_cast<double>(std::llabs(ordered(a) - ordered(b)));
+    }
+
+    // An absolute error in ulps of `magnitude`, for results of sums where
+    // cancellation makes the ulp of the result meaningless
+    auto ulps_of(double error, double magnitude) -> double {
+        auto const m = static_cast<float>(std::abs(magnitude));
+        auto const ulp = std::max(std::nextafter(m, INFINITY) - m, std::numeric_limits<float>::denorm_min());
+        return std::abs(error) / ulp;
+    }
+
+    // Mostly ordinary values spread over many magnitudes, mixed with the
+    // edge cases: signed zeros, ones, denormals and huge values
+    class Inputs {
+    public:
+        explicit Inputs(std::uint32_t seed) : m_rng(seed) { }
+
+        auto uniform(float lo, float hi) -> float {
+            return std::uniform_real_distribution<float>(lo, hi)(m_rng);
+        }
+
+        auto scalar(float max_exponent = 30) -> float {
+            auto const sign = m_rng() & 1 ? 1.0f : -1.0f;
+            switch (m_rng() % 16) {
+            case 0: return sign * 0.0f;
+            case 1: return sign;
+            case 2: return sign * uniform(0, 1) * std::numeric_limits<float>::min();
+            case 3: return sign * std::pow(10.0f, uniform(max_exponent - 4, max_exponent));
+            default: return sign * std::pow(10.0f, uniform(-max_exponent, max_exponent));
+            }
+        }
+
+        auto vector(float max_exponent = 30) -> Vec3f {
+            return { scalar(max_exponent), scalar(max_exponent), scalar(max_exponent) };
+        }
+
+        // A relative perturbation of about 1e-6, so cross products cancel
+        auto near_parallel(Vec3f const& v) -> Vec3f {
+            auto const e = [this] { return 1 + uniform(-1e-6f, 1e-6f); };
+            return { v.x * e(), v.y * e(), v.z * e() };
+        }
+
+        auto matrix(float max_magnitude) -> Matrix4x4f {
+            auto m = Matrix4x4f::identity();
+            for (int i = 0; i < 4; ++i) {
+                for (int j = 0; j < 4; ++j) m(i, j) = uniform(-max_magnitude, max_magnitude);
+            }
+            return m;
+        }
+
+    private:
+        std::mt19937 m_rng;
+    };
+
+    // The largest error seen and the input that produced it
+    struct Worst {
+        double error = 0;
+        std::string input;
+
+        template<typename Describe>
+        auto record(double e, Describe const& describe) -> void {
+            if (std::isnan(e)) e = INFINITY;
+            if (e <= error) return;
+            error = e;
+            std::ostringstream os;
+            os.precision(9);
+            describe(os);
+            input = os.str();
+        }
+    };
+
+    auto print(std::ostream& os, Matrix4x4f const& m) -> std::ostream& {
+        for (int i = 0; i < 4; ++i) {
+            os << (i == 0 ? '[' : ' ');
+            for (int j = 0; j < 4; ++j) os << m(i, j) << (j < 3 ? ',' : i < 3 ? ';' : ']');
+        }
+        return os;
+    }
+
+    auto within(Worst const& worst, double budget) -> bool {
+        UNSCOPED_INFO("worst error " << worst.error << " ulps for " << worst.input);
+        return worst.error <= budget;
+    }
+
+    auto random_transform(Inputs& in) -> Transform {
+        return Transform{}
+            .translate(Vec3f{ in.uniform(-100, 100), in.uniform(-100, 100), in.uniform(-100, 100) })
+            .rotate(Vec3f{ in.uniform(-1, 1), in.uniform(-1, 1), 1 }, in.uniform(-180, 180))
+            .scale(Vec3f{ in.uniform(0.1f, 10), in.uniform(0.1f, 10), in.uniform(0.1f, 10) });
+    }
+}
+
+TEST_CASE("normalise is within 2 ulps", "[property]") {
+    Inputs in(1);
+    Worst worst;
+    for (std::size_t i = 0; i < samples(); ++i) {
+        auto const v = i % 4 == 0 ? in.near_parallel(in.vector(18)) : in.vector(18);
+        // the domain: a finite, normal squared length
+        auto const length_squared = v.length_squared();
+        if (!(length_squared >= std::numeric_limits<float>::min() && length_squared <= std::numeric_limits<float>::max())) continue;
+        auto const n = v.normalise();
+        auto const length = std::sqrt(double(v.x) * v.x + double(v.y) * v.y + double(v.z) * v.z);
+        auto const e = std::max({ ulps(n.x(), float(v.x / length)), ulps(n.y(), float(v.y / length)), ulps(n.z(), float(v.z / length)) });
+        worst.record(e, [&](auto& os) { os << v; });
+    }
+    REQUIRE(within(worst, 2));
+}
+
+TEST_CASE("ONB is orthonormal", "[property]") {
+    Inputs in(2);
+    Worst worst;
+    for (std::size_t i = 0; i < samples(); ++i) {
+        // include normals close to the x axis, where the helper vector switches
+        auto const v = i % 2 == 0 ? Vec3f{ in.uniform(0.85f, 0.95f), in.uniform(-0.5f, 0.5f), in.uniform(-0.5f, 0.5f) } : in.vector(10);
+        if (!(v.length_squared() >= std::numeric_limits<float>::min() && v.length_squared() <= std::numeric_limits<float>::max())) continue;
+        auto const n = v.normalise();
+        ONB const onb(n);
+        REQUIRE(ExactEqual{}(onb.w(), n));
+        auto const u = Vec3f(onb.u()), w = Vec3f(onb.v()), t = Vec3f(onb.w());
+        auto const e = std::max({ std::abs(u.dot(w)), std::abs(u.dot(t)), std::abs(w.dot(t)),
+                                  std::abs(u.length() - 1), std::abs(w.length() - 1) });
+        worst.record(ulps_of(e, 1), [&](auto& os) { os << n; });
+    }
+    REQUIRE(within(worst, 4));
+}
+
+TEST_CASE("Sparse matrix compositions match multiply exactly", "[property]") {
+    Inputs in(3);
+    Worst worst;
+    auto const distance = [](Matrix4x4f const& a, Matrix4x4f const& b) {
+        auto e = 0.0;
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) e = std::max(e, ulps(a(i, j), b(i, j)));
+        }
+        return e;
+    };
+    for (std::size_t i = 0; i < samples() / 8; ++i) {
+        auto const m = in.matrix(1e4f);
+        auto const x = in.uniform(-100, 100), y = in.uniform(-100, 100), z = in.uniform(-100, 100);
+        auto const translation = Transform{}.translate(Vec3f{ x, y, z }).matrix();
+        auto const scale = Transform{}.scale(Vec3f{ x, y, z }).matrix();
+        auto const rotation = Transform{}.rotate(Vec3f{ x, y, z + 1000 }, in.uniform(-180, 180)).matrix();
+
+        auto e = 0.0;
+        e = std::max(e, distance(Matrix4x4f(m).post_translate(x, y, z), m * translation));
+        e = std::max(e, distance(Matrix4x4f(m).pre_translate(x, y, z), translation * m));
+        e = std::max(e, distance(Matrix4x4f(m).post_scale(x, y, z), m * scale));
+        e = std::max(e, distance(Matrix4x4f(m).pre_scale(x, y, z), scale * m));
+        e = std::max(e, distance(Matrix4x4f(m).post_rotate(rotation), m * rotation));
+        e = std::max(e, distance(Matrix4x4f(m).pre_rotate(rotation), rotation * m));
+        worst.record(e, [&](auto& os) { print(os, m) << x << ' ' << y << ' ' << z; });
+    }
+    REQUIRE(within(worst, 0));
+}
+
+TEST_CASE("Transform::apply matches double precision", "[property]") {
+    Inputs in(4);
+    Worst points, vectors, normals;
+    auto transform = random_transform(in);
+    for (std::size_t i = 0; i < samples(); ++i) {
+        if (i % 1024 == 0) transform = random_transform(in);
+        auto const& m = transform.matrix();
+        auto const v = in.vector(6);
+
+        auto const p = transform.apply(Point3f{ v.x, v.y, v.z });
+        auto const q = transform.apply(v);
+        for (int r = 0; r < 3; ++r) {
+            auto reference = double(m(r, 3)), magnitude = std::abs(double(m(r, 3)));
+            for (int c = 0; c < 3; ++c) {
+                reference += double(m(r, c)) * v[c];
+                magnitude += std::abs(double(m(r, c)) * v[c]);
+            }
+            // three products and three sums, each rounded once
+            points.record(ulps_of(p[r] - reference, magnitude), [&](auto& os) { print(os << v, transform.matrix()); });
+            vectors.record(ulps_of(q[r] - (reference - m(r, 3)), magnitude), [&](auto& os) { print(os << v, transform.matrix()); });
+        }
+
+        if (!(v.length_squared() >= 1e-10f && v.length_squared() <= 1e10f)) continue;
+        auto const normal = v.normalise();
+        auto const n = transform.apply(normal);
+        auto const unit = Vec3f(normal);
+        auto const& inv = transform.inverse();
+        double reference[3];
+        for (int c = 0; c < 3; ++c) {
+            reference[c] = 0;
+            for (int r = 0; r < 3; ++r) reference[c] += double(inv(r, c)) * unit[r];
+        }
+        auto const length = std::sqrt(reference[0] * reference[0] + reference[1] * reference[1] + reference[2] * reference[2]);
+        auto const e = std::max({ std::abs(n.x() - reference[0] / length), std::abs(n.y() - reference[1] / length), std::abs(n.z() - reference[2] / length) });
+        normals.record(ulps_of(e, 1), [&](auto& os) { print(os << v, transform.inverse()); });
+    }
+    CHECK(within(points, 4));
+    CHECK(within(vectors, 4));
+    REQUIRE(within(normals, 16));
+}
+
+TEST_CASE("Batched projection matches the scalar path", "[property]") {
+    Inputs in(5);
+    Worst worst;
+    auto const batch = std::size_t(256);
+    std::vector<Point3f> points(batch), projected(batch);
+    for (std::size_t i = 0; i < samples() / batch; ++i) {
+        auto const projection = i % 2 == 0
+            ? Transform{}.perspective(in.uniform(20, 120), in.uniform(0.5f, 2), in.uniform(0.01f, 1), in.uniform(10, 1e4f))
+            : Transform{}.orthographic(-in.uniform(1, 10), in.uniform(1, 10), -in.uniform(1, 10), in.uniform(1, 10), in.uniform(0.01f, 1), in.uniform(10, 1e4f));
+        for (auto& p : points) p = Point3f{ in.uniform(-100, 100), in.uniform(-100, 100), -in.uniform(0.01f, 1e4f) };
+        projection.apply_projective(points.data(), projected.data(), batch);
+        for (std::size_t k = 0; k < batch; ++k) {
+            auto const scalar = projection.apply(points[k]);
+            // the batch multiplies by 1 / w where the scalar path divides by w
+            auto const e = std::max({ ulps(projected[k].x, scalar.x), ulps(projected[k].y, scalar.y), ulps(projected[k].z, scalar.z) });
+            worst.record(e, [&](auto& os) { print(os << points[k], projection.matrix()); });
+        }
+    }
+    REQUIRE(within(worst, 2));
+}
+
+TEST_CASE("solve_quadratic matches double precision", "[property]") {
+    Inputs in(6);
+    Worst worst;
+    for (std::size_t i = 0; i < samples(); ++i) {
+        // roots differing by at least a tenth of their magnitude, at any scale
+        auto const scale = std::pow(10.0f, in.uniform(-10, 10));
+        auto const r0 = in.uniform(-1, 1) * scale;
+        auto r1 = in.uniform(-1, 1) * scale;
+        if (std::abs(r0 - r1) < 0.1f * std::max(std::abs(r0), std::abs(r1))) continue;
+        auto const a = in.uniform(0.5f, 2) * (in.uniform(0, 1) < 0.5f ? -1 : 1);
+        auto const b = -a * (r0 + r1), c = a * r0 * r1;
+
+        auto const roots = solve_quadratic(a, b, c);
+        if (!roots) {
+            worst.record(INFINITY, [&](auto& os) { os << a << ' ' << b << ' ' << c; });
+            continue;
+        }
+        // the exact roots of the float coefficients
+        auto const discr = double(b) * b - 4.0 * a * c;
+        auto const q = -0.5 * (b + std::copysign(std::sqrt(std::max(discr, 0.0)), double(b)));
+        auto lo = q / a, hi = c / q;
+        if (lo > hi) std::swap(lo, hi);
+        auto const e = std::max(ulps(std::get<0>(*roots), float(lo)), ulps(std::get<1>(*roots), float(hi)));
+        worst.record(e, [&](auto& os) { os << a << ' ' << b << ' ' << c; });
+    }
+    REQUIRE(within(worst, 32));
+}
+
+TEST_CASE("Batched kernels match their scalar forms exactly", "[property]") {
+    Inputs in(7);
+    auto const batch = std::size_t(512);
+    std::vector<Point2f> uv(batch), wrapped(batch), moved(batch);
+    std::vector<Vec2f> dx(batch), dy(batch), directions(batch);
+    std::vector<BilinearFootprint> footprints(batch);
+    std::vector<FLOAT> levels(batch);
+    std::vector<Vec3f> vectors(batch), sanitized(batch);
+
+    for (std::size_t i = 0; i < samples() / batch; ++i) {
+        for (std::size_t k = 0; k < batch; ++k) {
+            uv[k] = Point2f{ in.uniform(-4, 4), in.uniform(-4, 4) };
+            dx[k] = Vec2f{ in.scalar(4), in.scalar(4) };
+            dy[k] = Vec2f{ in.scalar(4), in.scalar(4) };
+            vectors[k] = in.vector();
+        }
+        auto const mode = static_cast<WrapMode>(i % 3);
+        auto const resolution = Point2i{ 1 + int(i % 1024), 1 + int((i * 7) % 1024) };
+        auto const transform = Transform2D::rotate(in.uniform(-180, 180)) * Transform2D::translate(Vec2f{ in.uniform(-9, 9), in.uniform(-9, 9) });
+
+        wrap(uv, wrapped.data(), mode);
+        bilinear_footprint(uv, resolution, mode, footprints.data());
+        mip_level(dx, dy, resolution, levels.data());
+        transform.apply(Span<Point2f const>(uv), moved.data());
+        transform.apply(Span<Vec2f const>(dx), directions.data());
+        sanitized = vectors;
+        auto const flushed = flush_nonfinite(Span<Vec3f>(sanitized), 0);
+
+        std::size_t expected_flushed = 0;
+        for (std::size_t k = 0; k < batch; ++k) {
+            REQUIRE(ulps(wrapped[k].x, wrap(uv[k].x, mode)) == 0);
+            REQUIRE(ulps(wrapped[k].y, wrap(uv[k].y, mode)) == 0);
+            auto const f = bilinear_footprint(uv[k], resolution, mode);
+            REQUIRE(std::memcmp(&f, &footprints[k], sizeof(f)) == 0);
+            REQUIRE(ulps(levels[k], mip_level(dx[k], dy[k], resolution)) == 0);
+            REQUIRE(ExactEqual{}(moved[k], transform(uv[k])));
+            REQUIRE(ExactEqual{}(directions[k], transform(dx[k])));
+            for (int c = 0; c < 3; ++c) {
+                auto const finite = std::isfinite(vectors[k][c]);
+                expected_flushed += !finite;
+                REQUIRE(ulps(sanitized[k][c], finite ? vectors[k][c] : 0.0f) == 0);
+            }
+        }
+        REQUIRE(flushed == expected_flushed);
+    }
+}
+
+TEST_CASE("Interval transforms contain every point transform", "[property]") {
+    Inputs in(8);
+    for (std::size_t i = 0; i < samples() / 64; ++i) {
+        auto const transform = random_transform(in);
+        auto const lo = Point3f{ in.uniform(-10, 10), in.uniform(-10, 10), in.uniform(-10, 10) };
+        auto const hi = lo + Vec3f{ in.uniform(0, 1), in.uniform(0, 1), in.uniform(0, 1) };
+        auto const bounds = transform.apply(to_interval(lo, hi));
+        auto const& m = transform.matrix();
+        for (int k = 0; k < 8; ++k) {
+            // a corner and an interior point, transformed in double precision
+            auto const corner = Point3f{ k & 1 ? hi.x : lo.x, k & 2 ? hi.y : lo.y, k & 4 ? hi.z : lo.z };
+            auto const inside = Point3f{ in.uniform(lo.x, hi.x), in.uniform(lo.y, hi.y), in.uniform(lo.z, hi.z) };
+            for (auto const& p : { corner, inside }) {
+                for (int r = 0; r < 3; ++r) {
+                    auto const exact = double(m(r, 0)) * p.x + double(m(r, 1)) * p.y + double(m(r, 2)) * p.z + m(r, 3);
+                    auto const& bound = r == 0 ? bounds.x : r == 1 ? bounds.y : bounds.z;
+                    REQUIRE(bound.low <= exact);
+                    REQUIRE(exact <= bound.high);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,115 @@
+#include <graphics-math.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <vector>
+
+using namespace gm;
+
+namespace {
+    // true if each of the 2^k x 2^(m-k) elementary intervals holds exactly one point
+    auto is_02_net(std::vector<Point2f> const& points, int m) -> bool {
+        for (int k = 0; k <= m; ++k) {
+            auto const columns = 1u << k, rows = 1u << (m - k);
+            std::vector<int> count(std::size_t{1} << m, 0);
+            for (auto const& p : points) {
+                auto const c = static_cast<std::uint32_t>(p.x * columns);
+                auto const r = static_cast<std::uint32_t>(p.y * rows);
+                if (++count[r * columns + c] > 1) return false;
+            }
+        }
+        return true;
+    }
+}
+
+TEST_CASE("Sobol sequence", "[sampling]") {
+    REQUIRE(sobol_2d(0) == Point2f{ 0, 0 });
+    REQUIRE(sobol_2d(1) == Point2f{ 0.5f, 0.5f });
+    REQUIRE(sobol_2d(2) == Point2f{ 0.25f, 0.75f });
+    REQUIRE(sobol_2d(3) == Point2f{ 0.75f, 0.25f });
+
+    for (std::uint32_t seed : { 0u, 1u, 1234u }) {
+        std::vector<Point2f> points(256);
+        sobol_2d(0, points.size(), points.data(), seed);
+        REQUIRE(is_02_net(points, 8));
+        for (auto const& p : points) {
+            REQUIRE(p.x >= 0); REQUIRE(p.x < 1);
+            REQUIRE(p.y >= 0); REQUIRE(p.y < 1);
+        }
+    }
+    REQUIRE(sobol_2d(5, 7) != sobol_2d(5, 8));
+}
+
+TEST_CASE("Halton sequence", "[sampling]") {
+    REQUIRE(halton_2d(1) == Point2f{ 0.5f, 1.0f / 3 });
+    REQUIRE(halton_2d(2) == Point2f{ 0.25f, 2.0f / 3 });
+    REQUIRE(halton_2d(3) == Point2f{ 0.75f, 1.0f / 9 });
+
+    std::vector<Point2f> points(9);
+    halton_2d(0, points.size(), points.data());
+    REQUIRE(points[4] == halton_2d(4));
+}
+
+TEST_CASE("PMJ02 sequence", "[sampling]") {
+    for (std::uint32_t seed : { 0u, 7u, 42u }) {
+        auto const points = pmj02(1024, seed);
+        REQUIRE(points.size() == 1024);
+        for (int m = 0; m <= 10; ++m) {
+            auto const prefix = std::vector<Point2f>(points.begin(), points.begin() + (std::size_t{1} << m));
+            REQUIRE(is_02_net(prefix, m));
+        }
+    }
+    REQUIRE(pmj02(100).size() == 100);
+}
+
+TEST_CASE("Sample warps", "[sampling]") {
+    std::vector<Point2f> u(256);
+    sobol_2d(0, u.size(), u.data(), 99);
+
+    SECTION("concentric disk") {
+        std::vector<Point2f> disk(u.size());
+        sample_concentric_disk(u.data(), disk.data(), u.size());
+        for (auto const& p : disk) REQUIRE(p.x * p.x + p.y * p.y <= 1.0001f);
+        REQUIRE(sample_concentric_disk(Point2f{ 0.5f, 0.5f }) == Point2f{ 0, 0 });
+    }
+
+    SECTION("uniform sphere") {
+        std::vector<Vec3f> dirs(u.size());
+        sample_uniform_sphere(u.data(), dirs.data(), u.size());
+        auto mean = Vec3f{};
+        for (auto const& d : dirs) {
+            REQUIRE(d.length() == Approx(1));
+            mean = mean + d / static_cast<FLOAT>(dirs.size());
+        }
+        REQUIRE(mean.length() < 0.05f);
+    }
+
+    SECTION("cosine hemisphere in a frame") {
+        auto const normal = Vec3f{ 1, 2, -1 }.normalise();
+        auto const frame = ONB(normal);
+        std::vector<Vec3f> dirs(u.size());
+        sample_cosine_hemisphere(u.data(), frame, dirs.data(), u.size());
+        auto mean_cos = FLOAT(0);
+        for (auto const& d : dirs) {
+            REQUIRE(d.length() == Approx(1));
+            REQUIRE(dot(normal, d) >= -1e-5f);
+            mean_cos += dot(normal, d) / dirs.size();
+        }
+        // E[cos] = 2/3 for a cosine weighted hemisphere
+        REQUIRE(mean_cos == Approx(2.0f / 3).epsilon(0.02));
+    }
+
+    SECTION("GGX visible normals") {
+        auto const wo = static_cast<Vec3f>(Vec3f{ 0.3f, -0.2f, 1 }.normalise());
+        std::vector<Normal3f> normals(u.size());
+        sample_ggx_vndf(wo, 0.3f, 0.6f, u.data(), normals.data(), u.size());
+        for (auto const& n : normals) {
+            REQUIRE(static_cast<Vec3f>(n).length() == Approx(1));
+            REQUIRE(n.z() >= 0);
+            REQUIRE(dot(n, wo) >= -1e-5f);
+        }
+        // a smooth surface only has the geometric normal
+        REQUIRE(sample_ggx_vndf(wo, 1e-6f, 1e-6f, Point2f{ 0.3f, 0.7f }) == Vec3f{ 0, 0, 1 }.normalise());
+    }
+}
@@ -0,0 +1,97 @@
+#include <serialization.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace gm;
+
+namespace {
+    auto temp_path(std::string const& name) -> std::string {
+        return "graphics-math-" + name + ".bin";
+    }
+}
+
+TEST_CASE("Binary arrays round trip through memory mapped files", "[serialization]") {
+    auto const path = temp_path("points");
+    std::vector<Point3f> points;
+    for (int i = 0; i < 1000; ++i) {
+        points.emplace_back(FLOAT(i), FLOAT(-i) * FLOAT(0.5), FLOAT(i) * FLOAT(0.25));
+    }
+
+    {
+        auto writer = BinaryWriter<Point3f>::open(path);
+        REQUIRE(writer);
+        // streamed in two chunks
+        REQUIRE(writer->write(points.data(), 400));
+        REQUIRE(writer->write(Span<Point3f const>{ points }.subspan(400, 600)));
+        REQUIRE(writer->close());
+    }
+
+    auto reader = BinaryReader<Point3f>::open(path);
+    REQUIRE(reader);
+    auto const elements = reader->elements();
+    REQUIRE(elements.size() == points.size());
+    REQUIRE(reinterpret_cast<std::uintptr_t>(elements.data()) % 64 == 0);
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        REQUIRE(elements[i] == points[i]);
+    }
+
+    SECTION("Mismatched element types are rejected") {
+        REQUIRE_FALSE(BinaryReader<Normal3f>::open(path));
+        REQUIRE_FALSE(BinaryReader<Matrix4x4f>::open(path));
+    }
+
+    SECTION("Truncated files are rejected") {
+        std::ifstream in(path, std::ios::binary);
+        std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        in.close();
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 4));
+        REQUIRE_FALSE(BinaryReader<Point3f>::open(path));
+    }
+
+    std::remove(path.c_str());
+    REQUIRE_FALSE(BinaryReader<Point3f>::open(path));
+}
+
+TEST_CASE("Transforms serialize with their inverse", "[serialization]") {
+    auto const path = temp_path("transforms");
+    std::vector<Transform> transforms(3);
+    transforms[0].translate({ 1, 2, 3 });
+    transforms[1].scale({ 2, 4, 8 });
+    transforms[2].rotate({ 0, 1, 0 }, 30).translate({ -1, 0, 5 });
+
+    {
+        auto writer = BinaryWriter<Transform>::open(path);
+        REQUIRE(writer);
+        REQUIRE(writer->write(transforms.data(), transforms.size()));
+    }
+
+    auto reader = BinaryReader<Transform>::open(path);
+    REQUIRE(reader);
+    REQUIRE(reader->size() == transforms.size());
+    for (std::size_t i = 0; i < transforms.size(); ++i) {
+        REQUIRE(reader->elements()[i].matrix() == transforms[i].matrix());
+        REQUIRE(reader->elements()[i].inverse() == transforms[i].inverse());
+    }
+
+    reader.reset();
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Empty binary arrays", "[serialization]") {
+    auto const path = temp_path("empty");
+    REQUIRE(BinaryWriter<Color3f>::open(path));
+
+    auto reader = BinaryReader<Color3f>::open(path);
+    REQUIRE(reader);
+    REQUIRE(reader->elements().empty());
+
+    reader.reset();
+    std::remove(path.c_str());
+}
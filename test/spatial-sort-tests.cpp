@@ -0,0 +1,64 @@
+#include <spatial-sort.hpp>
+#include <sampling.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+using namespace gm;
+
+TEST_CASE("parallel_for covers every index once", "[parallel]") {
+    for (std::size_t count : { 0, 1, 1000, 300001 }) {
+        std::vector<std::atomic<int>> visits(count);
+        parallel_for(count, [&](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i) ++visits[i];
+        }, 1024);
+        REQUIRE(std::all_of(visits.begin(), visits.end(), [](auto const& v) { return v == 1; }));
+    }
+}
+
+TEST_CASE("Radix sort is a stable sort of key/value pairs", "[spatial-sort]") {
+    auto const count = std::size_t(200000);
+    detail::Pcg32 rng(3);
+    std::vector<std::uint64_t> keys(count);
+    for (auto& key : keys) {
+        // few distinct high digits so stability matters, one constant byte to exercise skipped passes
+        key = (std::uint64_t(rng.uniform(16)) << 56) | (std::uint64_t(0xab) << 40) | rng.uniform(1000);
+    }
+    std::vector<std::uint32_t> values(count);
+    std::iota(values.begin(), values.end(), 0u);
+
+    std::vector<std::uint32_t> expected(values);
+    std::stable_sort(expected.begin(), expected.end(), [&](std::uint32_t a, std::uint32_t b) { return keys[a] < keys[b]; });
+
+    auto sorted_keys = keys;
+    radix_sort(sorted_keys.data(), values.data(), count);
+    REQUIRE(values == expected);
+    REQUIRE(std::is_sorted(sorted_keys.begin(), sorted_keys.end()));
+}
+
+TEST_CASE("Morton sort orders points along the curve", "[spatial-sort]") {
+    auto const count = std::size_t(100000);
+    std::vector<Point3f> points(count);
+    detail::Pcg32 rng(11);
+    for (auto& p : points) p = Point3f{ rng.uniform() * 10 - 5, rng.uniform(), rng.uniform() * 1000 };
+
+    auto const permutation = morton_sort(points);
+    REQUIRE(permutation.size() == count);
+
+    auto check = permutation;
+    std::sort(check.begin(), check.end());
+    for (std::size_t i = 0; i < count; ++i) REQUIRE(check[i] == i);
+
+    std::vector<Point3f> sorted(count);
+    gather(points.data(), permutation, sorted.data());
+
+    auto const [min, max] = bounds(sorted);
+    std::vector<std::uint64_t> codes(count);
+    morton_codes(sorted, min, max, codes.data());
+    REQUIRE(std::is_sorted(codes.begin(), codes.end()));
+}
@@ -0,0 +1,116 @@
+#include <graphics-math.hpp>
+#include <rgb-to-spectrum.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <vector>
+
+using namespace gm;
+
+namespace {
+    // Averages the film conversion over many stratified wavelength sets
+    template<typename SpectrumAt>
+    auto estimate_color(SpectrumAt const& spectrum_at) -> Color3f {
+        auto constexpr count = std::size_t{ 4096 };
+        std::vector<SampledSpectrum4> spectra(count);
+        std::vector<SampledWavelengths4> wavelengths(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            wavelengths[i] = SampledWavelengths4::sample_visible((i + FLOAT(0.5)) / count);
+            spectra[i] = spectrum_at(wavelengths[i]);
+        }
+        std::vector<Color3f> colors(count);
+        to_color(spectra.data(), wavelengths.data(), colors.data(), count);
+
+        auto sum = Color3f{};
+        for (auto const& c : colors) sum += c / static_cast<FLOAT>(count);
+        return sum;
+    }
+
+    // built once, the fit is expensive in unoptimised builds
+    auto test_table() -> RGBToSpectrumTable const& {
+        static auto const table = RGBToSpectrumTable::build(12);
+        return table;
+    }
+}
+
+TEST_CASE("Sampled spectrum arithmetic", "[spectrum]") {
+    auto const a = SampledSpectrum4{ { 1, 2, 3, 4 } };
+    auto const b = SampledSpectrum4{ 2 };
+    REQUIRE(a + b == SampledSpectrum4{ { 3, 4, 5, 6 } });
+    REQUIRE(a - b == SampledSpectrum4{ { -1, 0, 1, 2 } });
+    REQUIRE(a * b == 2.0f * a);
+    REQUIRE(a / b == a * 0.5f);
+    REQUIRE(a / SampledSpectrum4{} == SampledSpectrum4::black());
+    REQUIRE(SampledSpectrum4::black().is_black());
+    REQUIRE(a.average() == Approx(2.5));
+    REQUIRE(a.max_value() == Approx(4));
+    REQUIRE(lerp(0.5f, a, b) == SampledSpectrum4{ { 1.5f, 2, 2.5f, 3 } });
+    REQUIRE(alignof(SampledSpectrum4) == 16);
+}
+
+TEST_CASE("Wavelength sampling", "[spectrum]") {
+    auto const w = SampledWavelengths4::sample_visible(0.3f);
+    for (std::size_t i = 0; i < 4; ++i) {
+        REQUIRE(w.lambda(i) >= constants::lambda_min);
+        REQUIRE(w.lambda(i) <= constants::lambda_max);
+        REQUIRE(w.pdf(i) == Approx(SampledWavelengths4::visible_pdf(w.lambda(i))));
+    }
+    auto const u = SampledWavelengths4::sample_uniform(0);
+    REQUIRE(u.lambda(2) == Approx(595));
+}
+
+TEST_CASE("Spectrum to color", "[spectrum]") {
+    auto const white = estimate_color([](SampledWavelengths4 const&) { return SampledSpectrum4{ 1 }; });
+    REQUIRE(white.r == Approx(1).epsilon(0.01));
+    REQUIRE(white.g == Approx(1).epsilon(0.01));
+    REQUIRE(white.b == Approx(1).epsilon(0.01));
+
+    // a long wavelength band is red
+    auto const red = estimate_color([](SampledWavelengths4 const& w) {
+        auto s = SampledSpectrum4{};
+        for (std::size_t i = 0; i < 4; ++i) s[i] = w.lambda(i) > 600 ? FLOAT(1) : FLOAT(0);
+        return s;
+    });
+    REQUIRE(red.r > 5 * red.g);
+    REQUIRE(red.r > 5 * red.b);
+}
+
+TEST_CASE("RGB to spectrum upsampling", "[spectrum]") {
+    auto const& table = test_table();
+
+    SECTION("grey is exact") {
+        auto const grey = table(Color3f{ 0.25f });
+        REQUIRE(grey.evaluate(400) == Approx(0.25));
+        REQUIRE(grey.evaluate(700) == Approx(0.25));
+        REQUIRE(table(Color3f{ 0 }).evaluate(500) == 0);
+        REQUIRE(table(Color3f{ 1 }).evaluate(500) == 1);
+    }
+
+    SECTION("round trip") {
+        for (auto const& color : { Color3f{ 0.8f, 0.2f, 0.1f }, Color3f{ 0.1f, 0.5f, 0.3f },
+                                   Color3f{ 0.3f, 0.35f, 0.7f }, Color3f{ 0.6f, 0.6f, 0.2f } }) {
+            auto const polynomial = table(color);
+            auto const result = estimate_color([&](SampledWavelengths4 const& w) { return polynomial.sample(w); });
+            REQUIRE(result.r == Approx(color.r).margin(0.02));
+            REQUIRE(result.g == Approx(color.g).margin(0.02));
+            REQUIRE(result.b == Approx(color.b).margin(0.02));
+        }
+    }
+
+    SECTION("save and memory map") {
+        auto const path = std::string{ "rgb-to-spectrum-test.coeff" };
+        REQUIRE(table.save(path));
+        auto const loaded = RGBToSpectrumTable::load(path);
+        REQUIRE(loaded.has_value());
+        REQUIRE(loaded->resolution() == 12);
+        auto const a = table(Color3f{ 0.7f, 0.3f, 0.2f });
+        auto const b = (*loaded)(Color3f{ 0.7f, 0.3f, 0.2f });
+        REQUIRE(a.c0 == b.c0);
+        REQUIRE(a.c1 == b.c1);
+        REQUIRE(a.c2 == b.c2);
+        std::remove(path.c_str());
+
+        REQUIRE_FALSE(RGBToSpectrumTable::load("does-not-exist.coeff").has_value());
+    }
+}
@@ -0,0 +1,83 @@
+#include <graphics-math.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <vector>
+
+using namespace gm;
+
+// UV arrays are tightly packed
+static_assert(sizeof(Point2f) == 2 * sizeof(FLOAT));
+
+TEST_CASE("2D affine transforms", "[Transform2D]") {
+    auto const t = Transform2D::translate({ 1, 2 }) * Transform2D::rotate(90) * Transform2D::scale({ 2, 2 });
+    auto const p = t(Point2f{ 1, 0 });
+    REQUIRE(p.x == Approx(1).margin(1e-6));
+    REQUIRE(p.y == Approx(4));
+
+    auto const v = t(Vec2f{ 1, 0 });
+    REQUIRE(v.x == Approx(0).margin(1e-6));
+    REQUIRE(v.y == Approx(2));
+
+    auto const inverse = t.inverse();
+    REQUIRE(inverse);
+    REQUIRE(*inverse * t == Transform2D{});
+    REQUIRE_FALSE(Transform2D::scale({ 0, 1 }).inverse());
+
+    SECTION("Batches match the scalar transform") {
+        std::vector<Point2f> points;
+        for (int i = 0; i < 37; ++i) points.emplace_back(i * 0.5f, -i * 0.25f);
+        std::vector<Point2f> out(points.size());
+        t.apply(points, out.data());
+        for (std::size_t i = 0; i < points.size(); ++i) REQUIRE(out[i] == t(points[i]));
+    }
+}
+
+TEST_CASE("Texture addressing", "[texcoord]") {
+    REQUIRE(wrap_texel(-1, 4, WrapMode::repeat) == 3);
+    REQUIRE(wrap_texel(9, 4, WrapMode::repeat) == 1);
+    REQUIRE(wrap_texel(-1, 4, WrapMode::clamp) == 0);
+    REQUIRE(wrap_texel(4, 4, WrapMode::clamp) == 3);
+    REQUIRE(wrap_texel(-1, 4, WrapMode::mirror) == 0);
+    REQUIRE(wrap_texel(4, 4, WrapMode::mirror) == 3);
+    REQUIRE(wrap_texel(9, 4, WrapMode::mirror) == 1);
+
+    REQUIRE(wrap(1.25f, WrapMode::repeat) == Approx(0.25f));
+    REQUIRE(wrap(-0.25f, WrapMode::repeat) == Approx(0.75f));
+    REQUIRE(wrap(1.25f, WrapMode::clamp) == 1);
+    REQUIRE(wrap(1.25f, WrapMode::mirror) == Approx(0.75f));
+    REQUIRE(wrap(-0.25f, WrapMode::mirror) == Approx(0.25f));
+
+    std::vector<Point2f> uv{ { 1.25f, -0.25f }, { 0.5f, 2.75f } };
+    wrap(uv, uv.data(), WrapMode::mirror);
+    REQUIRE(uv[0] == Point2f{ 0.75f, 0.25f });
+    REQUIRE(uv[1] == Point2f{ 0.5f, 0.75f });
+}
+
+TEST_CASE("Bilinear footprints", "[texcoord]") {
+    auto const f = bilinear_footprint({ 0.5f, 0.5f }, { 4, 4 }, WrapMode::clamp);
+    REQUIRE(f.x0 == 1);
+    REQUIRE(f.x1 == 2);
+    REQUIRE(f.fx == Approx(0.5f));
+    auto const w = f.weights();
+    REQUIRE(w[0] + w[1] + w[2] + w[3] == Approx(1));
+
+    // across the edge the second texel wraps around
+    auto const edge = bilinear_footprint({ 0.0f, 0.0f }, { 4, 4 }, WrapMode::repeat);
+    REQUIRE(edge.x0 == 3);
+    REQUIRE(edge.x1 == 0);
+    REQUIRE(edge.fx == Approx(0.5f));
+}
+
+TEST_CASE("Mip level selection", "[texcoord]") {
+    auto const resolution = Point2i{ 256, 256 };
+    REQUIRE(mip_level({ 1.0f / 256, 0 }, { 0, 1.0f / 256 }, resolution) == Approx(0));
+    REQUIRE(mip_level({ 4.0f / 256, 0 }, { 0, 1.0f / 256 }, resolution) == Approx(2));
+    REQUIRE(mip_level({ 0, 0 }, { 0, 0 }, resolution) == 0);
+
+    std::vector<Vec2f> dx{ { 8.0f / 256, 0 }, { 0, 0 } }, dy{ { 0, 1.0f / 256 }, { 0, 16.0f / 256 } };
+    FLOAT levels[2];
+    mip_level(dx, dy, resolution, levels);
+    REQUIRE(levels[0] == Approx(3));
+    REQUIRE(levels[1] == Approx(4));
+}
@@ -0,0 +1,164 @@
+#include <graphics-math.hpp>
+
+#include <catch2/catch.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+using namespace gm;
+
+namespace {
+    // A w x h texture with distinct texels
+    auto gradient(Point2i const& r) -> std::vector<Color3f> {
+        std::vector<Color3f> texels;
+        for (int y = 0; y < r.y; ++y) {
+            for (int x = 0; x < r.x; ++x) texels.emplace_back(FLOAT(x) / r.x, FLOAT(y) / r.y, FLOAT((x * 7 + y * 3) % 11) / 11);
+        }
+        return texels;
+    }
+
+    auto bitwise_equal(Color3f const& a, Color3f const& b) -> bool {
+        return std::memcmp(&a, &b, sizeof(Color3f)) == 0;
+    }
+
+    auto near(Color3f const& a, Color3f const& b, FLOAT margin) -> bool {
+        return approx_equal(a, b, [margin](FLOAT x, FLOAT y) { return std::abs(x - y) <= margin; });
+    }
+}
+
+TEST_CASE("Mip levels halve down to 1x1", "[texture]") {
+    auto const texels = gradient({ 13, 6 });
+    auto const texture = MipMapf({ 13, 6 }, texels);
+    REQUIRE(texture.levels() == 4);
+    REQUIRE(texture.resolution(1) == Point2i{ 6, 3 });
+    REQUIRE(texture.resolution(2) == Point2i{ 3, 1 });
+    REQUIRE(texture.resolution(3) == Point2i{ 1, 1 });
+
+    // the tiled layout returns every texel
+    for (int y = 0; y < 6; ++y) {
+        for (int x = 0; x < 13; ++x) REQUIRE(bitwise_equal(texture.texel(0, { x, y }), texels[static_cast<std::size_t>(y * 13 + x)]));
+    }
+    auto const box = (texels[0] + texels[1] + texels[13] + texels[14]) * FLOAT(0.25);
+    REQUIRE(near(texture.texel(1, { 0, 0 }), box, FLOAT(1e-6)));
+}
+
+TEST_CASE("Bilinear lookups match bilinear_footprint", "[texture]") {
+    auto const r = Point2i{ 16, 8 };
+    auto const texels = gradient(r);
+    for (auto mode : { WrapMode::repeat, WrapMode::clamp, WrapMode::mirror }) {
+        auto const texture = MipMapf(r, texels, mode);
+        detail::Pcg32 rng(3);
+        for (int i = 0; i < 1000; ++i) {
+            auto const uv = Point2f{ (rng.uniform() - FLOAT(0.5)) * 4, (rng.uniform() - FLOAT(0.5)) * 4 };
+            // the footprint of the wrapped coordinate, as the texture uses
+            auto const f = bilinear_footprint(Point2f{ wrap(uv.x, mode), wrap(uv.y, mode) }, r, mode);
+            auto const w = f.weights();
+            auto const at = [&](int x, int y) { return texels[static_cast<std::size_t>(y * r.x + x)]; };
+            auto const expected = at(f.x0, f.y0) * w[0] + at(f.x1, f.y0) * w[1] + at(f.x0, f.y1) * w[2] + at(f.x1, f.y1) * w[3];
+            INFO(uv.x << ' ' << uv.y);
+            REQUIRE(near(texture.bilinear(uv), expected, FLOAT(1e-5)));
+        }
+    }
+}
+
+TEST_CASE("Trilinear lookups blend neighbouring levels", "[texture]") {
+    auto const texture = MipMapf({ 32, 32 }, gradient({ 32, 32 }));
+    auto const uv = Point2f{ 0.3f, 0.7f };
+    REQUIRE(bitwise_equal(texture.trilinear(uv, 2), texture.bilinear(uv, 2)));
+    REQUIRE(near(texture.trilinear(uv, FLOAT(2.25)), lerp(FLOAT(0.25), texture.bilinear(uv, 2), texture.bilinear(uv, 3)), FLOAT(1e-6)));
+    // out of range levels clamp
+    REQUIRE(bitwise_equal(texture.trilinear(uv, -1), texture.bilinear(uv, 0)));
+    REQUIRE(near(texture.trilinear(uv, 100), texture.texel(5, { 0, 0 }), FLOAT(1e-6)));
+    // a footprint of 4 texels selects level 2
+    REQUIRE(bitwise_equal(texture.trilinear(uv, Vec2f{ FLOAT(4) / 32, 0 }, Vec2f{ 0, FLOAT(1) / 32 }), texture.bilinear(uv, 2)));
+}
+
+TEST_CASE("Batched lookups match the scalar ones at every tier", "[texture]") {
+    auto const texture = MipMapf({ 37, 21 }, gradient({ 37, 21 }), WrapMode::mirror);
+    detail::Pcg32 rng(11);
+    std::vector<Point2f> uv(1037);
+    std::vector<FLOAT> levels(uv.size());
+    for (std::size_t i = 0; i < uv.size(); ++i) {
+        uv[i] = Point2f{ (rng.uniform() - FLOAT(0.5)) * 3, (rng.uniform() - FLOAT(0.5)) * 3 };
+        levels[i] = rng.uniform() * 7 - 1;
+    }
+    auto const previous = cpu_tier();
+    for (auto tier : { CpuTier::scalar, CpuTier::sse42, CpuTier::avx2, CpuTier::avx512 }) {
+        if (tier > detected_cpu_tier()) break;
+        set_cpu_tier(tier);
+        INFO("tier " << to_string(tier));
+        std::vector<Color3f> out(uv.size());
+        texture.bilinear(uv, 1, out.data());
+        for (std::size_t i = 0; i < uv.size(); ++i) REQUIRE(bitwise_equal(out[i], texture.bilinear(uv[i], 1)));
+        texture.trilinear(uv, levels, out.data());
+        for (std::size_t i = 0; i < uv.size(); ++i) REQUIRE(bitwise_equal(out[i], texture.trilinear(uv[i], levels[i])));
+    }
+    set_cpu_tier(previous);
+}
+
+TEST_CASE("8-bit textures decode sRGB", "[texture]") {
+    std::vector<Color3ui8> texels(64, Color3ui8{ 0, 128, 255 });
+    texels[0] = Color3ui8{ 255, 255, 255 };
+    auto const texture = MipMapui8({ 8, 8 }, texels);
+    auto const c = texture.texel(0, { 1, 0 });
+    REQUIRE(c.r == 0);
+    REQUIRE(c.g == Approx(srgb_to_linear(128.0 / 255)));
+    REQUIRE(c.b == 1);
+    // levels are filtered in linear values, then encoded
+    auto const expected = (texture.texel(0, { 0, 0 }) + c * 3) * FLOAT(0.25);
+    REQUIRE(near(texture.texel(1, { 0, 0 }), expected, FLOAT(0.01)));
+}
+
+TEST_CASE("Texel caches return the uncached values", "[texture]") {
+    std::vector<Color3ui8> texels;
+    for (int i = 0; i < 64 * 64; ++i) texels.emplace_back(static_cast<std::uint8_t>(i), static_cast<std::uint8_t>(i >> 4), static_cast<std::uint8_t>(i * 7));
+    auto const texture = MipMapui8({ 64, 64 }, texels);
+    auto const other = MipMapui8({ 64, 64 }, std::vector<Color3ui8>(64 * 64, Color3ui8{ 9, 9, 9 }));
+    // small enough that the textures evict each other
+    auto cache = TexelCache(4);
+    detail::Pcg32 rng(5);
+    for (int i = 0; i < 2000; ++i) {
+        auto const uv = Point2f{ rng.uniform(), rng.uniform() };
+        auto const level = rng.uniform() * 7;
+        REQUIRE(bitwise_equal(texture.bilinear(uv, 0, cache), texture.bilinear(uv, 0)));
+        REQUIRE(bitwise_equal(texture.trilinear(uv, level, cache), texture.trilinear(uv, level)));
+        REQUIRE(bitwise_equal(other.bilinear(uv, 0, cache), other.bilinear(uv, 0)));
+    }
+    REQUIRE(cache.hits() > 0);
+    REQUIRE(cache.misses() > 0);
+
+    // neighbouring lookups mostly hit
+    auto& local = TexelCache::local();
+    local.clear();
+    for (int i = 0; i < 64; ++i) texture.bilinear(Point2f{ (FLOAT(i) + FLOAT(0.5)) / 64, FLOAT(0.5) }, 0, local);
+    REQUIRE(local.hits() > 3 * local.misses());
+}
+
+TEST_CASE("EWA filtering", "[texture]") {
+    SECTION("A constant texture stays constant") {
+        auto const texture = MipMapf({ 32, 16 }, std::vector<Color3f>(32 * 16, Color3f{ 0.25f, 0.5f, 0.75f }));
+        detail::Pcg32 rng(2);
+        for (int i = 0; i < 200; ++i) {
+            auto const uv = Point2f{ rng.uniform() * 3, rng.uniform() * 3 };
+            auto const dx = Vec2f{ rng.uniform() * FLOAT(0.2), rng.uniform() * FLOAT(0.01) };
+            auto const dy = Vec2f{ rng.uniform() * FLOAT(0.01), rng.uniform() * FLOAT(0.05) };
+            REQUIRE(near(texture.ewa(uv, dx, dy), Color3f{ 0.25f, 0.5f, 0.75f }, FLOAT(1e-5)));
+        }
+    }
+
+    SECTION("Footprints average along the major axis") {
+        // vertical stripes, one texel wide
+        std::vector<Color3f> texels(64 * 64);
+        for (std::size_t i = 0; i < texels.size(); ++i) texels[i] = Color3f(FLOAT(i % 2));
+        auto const texture = MipMapf({ 64, 64 }, texels);
+        auto const uv = Point2f{ 0.5f, 0.5f };
+        // narrow vertically, wide across the stripes: the average
+        auto const across = texture.ewa(uv, Vec2f{ FLOAT(8) / 64, 0 }, Vec2f{ 0, FLOAT(1) / 64 });
+        REQUIRE(across.r == Approx(0.5).margin(0.05));
+        // zero derivatives fall back to bilinear
+        REQUIRE(bitwise_equal(texture.ewa(uv, {}, {}), texture.bilinear(uv, 0)));
+        // huge footprints read the 1x1 level
+        REQUIRE(bitwise_equal(texture.ewa(uv, Vec2f{ 100, 0 }, Vec2f{ 0, 100 }), texture.texel(6, { 0, 0 })));
+    }
+}
@@ -52,6 +52,22 @@ TEST_CASE("Transformations", "[Transform]") {
     }
 }
 
+TEST_CASE("Composed transformations", "[Transform]") {
+    auto transform = gm::Transform();
+    transform.translate(Vec3f{ 1, 2, 3 }).scale(Vec3f{ 2, 4, 0.5f }).rotate(Vec3f{ 0, 1, 1 }, 30.0f);
+
+    auto const product = transform.matrix() * transform.inverse();
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            REQUIRE(product(i, j) == Approx(i == j ? 1.0f : 0.0f).margin(1e-5));
+        }
+    }
+
+    auto const point = Point3f{ 1, -1, 2 };
+    auto const inverse = gm::Transform(transform.inverse(), transform.matrix());
+    REQUIRE(inverse.apply(transform.apply(point)) == point);
+}
+
 TEST_CASE("Orthonormal basis", "[ONB]") {
     auto constexpr onb = ONB(Vec3f{1, 1, 0}.normalise()); 
     auto constexpr x = Vec3f{1, 0, 0}; 
@@ -60,4 +76,62 @@ TEST_CASE("Orthonormal basis", "[ONB]") {
     REQUIRE(onb.convert_to_local(x) == static_cast<Vec3f>(onb.u()));
     REQUIRE(onb.convert_to_local(y) == static_cast<Vec3f>(onb.v()));
     REQUIRE(onb.convert_to_local(z) == static_cast<Vec3f>(onb.w()));
-}
\ No newline at end of file
+}
+
+TEST_CASE("Projections", "[Transform]") {
+
+    auto const is_identity = [](Matrix4x4f const& m) {
+        for (int i = 0; i < 4; ++i)
+            for (int j = 0; j < 4; ++j)
+                if (std::abs(m(i, j) - (i == j ? 1.0f : 0.0f)) > 1e-5f) return false;
+        return true;
+    };
+
+    SECTION("perspective") {
+        auto transform = gm::Transform();
+        transform.perspective(90.0f, 2.0f, 1.0f, 10.0f);
+        REQUIRE(is_identity(transform.matrix() * transform.inverse()));
+        REQUIRE(transform.apply(Point3f{ 0, 0, -1 }).z == Approx(0).margin(1e-6));
+        REQUIRE(transform.apply(Point3f{ 0, 0, -10 }).z == Approx(1));
+        REQUIRE(transform.apply(Point3f{ 2, 1, -1 }) == Point3f{ 1, 1, 0 });
+    }
+
+    SECTION("infinite reversed-z") {
+        auto transform = gm::Transform();
+        transform.infinite_reversed_perspective(90.0f, 1.0f, 0.1f);
+        REQUIRE(is_identity(transform.matrix() * transform.inverse()));
+        REQUIRE(transform.apply(Point3f{ 0, 0, -0.1f }).z == Approx(1));
+        REQUIRE(transform.apply(Point3f{ 0, 0, -1e30f }).z == Approx(0).margin(1e-6));
+        REQUIRE(transform.apply(Point3f{ 0, 0, -1e30f }).z > 0);
+    }
+
+    SECTION("orthographic") {
+        auto transform = gm::Transform();
+        transform.orthographic(-2, 2, -1, 3, 1, 5);
+        REQUIRE(is_identity(transform.matrix() * transform.inverse()));
+        REQUIRE(transform.apply(Point3f{ -2, -1, -1 }) == Point3f{ -1, -1, 0 });
+        REQUIRE(transform.apply(Point3f{ 2, 3, -5 }) == Point3f{ 1, 1, 1 });
+    }
+
+    SECTION("look at") {
+        auto transform = gm::Transform();
+        transform.look_at(Point3f{ 0, 0, 5 }, Point3f{ 0, 0, 0 }, Vec3f{ 0, 1, 0 });
+        REQUIRE(is_identity(transform.matrix() * transform.inverse()));
+        REQUIRE(transform.apply(Point3f{ 0, 0, 0 }) == Point3f{ 0, 0, -5 });
+        REQUIRE(transform.apply(Point3f{ 1, 2, 5 }) == Point3f{ 1, 2, 0 });
+    }
+
+    SECTION("apply_projective matches apply") {
+        auto transform = gm::Transform();
+        transform.perspective(60.0f, 1.5f, 0.5f, 100.0f);
+        REQUIRE(transform.is_projective());
+
+        Point3f const points[] = { { 1, 2, -3 }, { -4, 0.5f, -50 }, { 0, 0, -0.5f } };
+        Point3f out[3];
+        transform.apply_projective(points, out, 3);
+        for (int i = 0; i < 3; ++i) {
+            REQUIRE(transform.apply_projective(points[i]) == transform.apply(points[i]));
+            REQUIRE(out[i] == transform.apply(points[i]));
+        }
+    }
+}
@@ -82,6 +82,15 @@ TEMPLATE_TEST_CASE( "cross product", "[Vec3]", std::int32_t, std::int64_t, float
     REQUIRE( cross(v, u) == gm::Vec3<TestType>{ -3, 6, -3 } );
 }
 
+TEMPLATE_TEST_CASE( "2D cross product", "[Vec2]", std::int32_t, float, double ) {
+    auto const v = gm::Vec2<TestType>{ 2, 3 };
+    auto const u = gm::Vec2<TestType>{ 5, 7 };
+
+    REQUIRE( v.cross(u) == TestType(-1) );
+    REQUIRE( gm::cross(v, u) == TestType(-1) );
+    REQUIRE( gm::cross(u, v) == TestType(1) );
+}
+
 TEMPLATE_TEST_CASE( "scaling by constant", "[Vec3]", std::int32_t, std::int64_t, float, double ) {
     auto const v = gm::Vec3<TestType>{ 9, 828, 18 };
     auto const factor = static_cast<TestType>(4);